@@ -126,6 +126,14 @@ mcp_session_manager_t *mcp_session_manager_create(const mcp_session_manager_conf
         hal->memory.free(manager);
         return NULL;
     }
+
+    if (pthread_cond_init(&manager->cleanup_cond, NULL) != 0) {
+        pthread_mutex_destroy(&manager->manager_mutex);
+        pthread_rwlock_destroy(&manager->sessions_lock);
+        hal->memory.free(manager->sessions);
+        hal->memory.free(manager);
+        return NULL;
+    }
     
     // 初始化统计信息
     manager->total_sessions_created = 0;
@@ -161,6 +169,7 @@ void mcp_session_manager_destroy(mcp_session_manager_t *manager) {
     
     // 销毁同步原语
     pthread_rwlock_destroy(&manager->sessions_lock);
+    pthread_cond_destroy(&manager->cleanup_cond);
     pthread_mutex_destroy(&manager->manager_mutex);
     
     // 释放内存
@@ -178,13 +187,21 @@ static void *session_cleanup_thread(void *arg) {
     
     mcp_log_info("Session cleanup thread started");
     
+    pthread_mutex_lock(&manager->manager_mutex);
     while (manager->cleanup_running) {
-        sleep(manager->config.cleanup_interval);
-        
+        // 等待清理间隔，停止时被条件变量提前唤醒
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += manager->config.cleanup_interval;
+        pthread_cond_timedwait(&manager->cleanup_cond, &manager->manager_mutex, &deadline);
+
         if (!manager->cleanup_running) break;
-        
+
+        pthread_mutex_unlock(&manager->manager_mutex);
         mcp_session_manager_cleanup_expired_sessions(manager);
+        pthread_mutex_lock(&manager->manager_mutex);
     }
+    pthread_mutex_unlock(&manager->manager_mutex);
     
     mcp_log_info("Session cleanup thread stopped");
     return NULL;
@@ -212,11 +229,8 @@ int mcp_session_manager_start(mcp_session_manager_t *manager) {
             return -1;
         }
 
-        void *thread_handle;
-        int thread_result = hal->thread.create(&thread_handle, session_cleanup_thread, manager, 0);
-        if (thread_result == 0) {
-            manager->cleanup_thread = *(pthread_t*)&thread_handle;
-        } else {
+        int thread_result = hal->thread.create(&manager->cleanup_thread, session_cleanup_thread, manager, 0);
+        if (thread_result != 0) {
             manager->cleanup_running = false;
             pthread_mutex_unlock(&manager->manager_mutex);
             mcp_log_error("Failed to create session cleanup thread");
@@ -242,12 +256,15 @@ int mcp_session_manager_stop(mcp_session_manager_t *manager) {
     }
     
     manager->cleanup_running = false;
+    pthread_cond_signal(&manager->cleanup_cond);
     pthread_mutex_unlock(&manager->manager_mutex);
     
     // 等待清理线程结束
-    if (pthread_join(manager->cleanup_thread, NULL) != 0) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal || hal->thread.join(manager->cleanup_thread) != 0) {
         mcp_log_warn("Failed to join session cleanup thread");
     }
+    manager->cleanup_thread = NULL;
     
     mcp_log_info("Session manager stopped");
     return 0;
@@ -302,7 +319,7 @@ mcp_session_t *mcp_session_manager_create_session(mcp_session_manager_t *manager
     session->created_time = time(NULL);
     session->last_activity = session->created_time;
     session->expires_at = session->created_time + manager->config.default_session_timeout;
-    session->ref_count = 1;
+    session->ref_count = 2;  // 管理器持有一个引用，返回给调用方一个（与find_session一致）
     
     // 初始化互斥锁
     if (pthread_mutex_init(&session->mutex, NULL) != 0) {
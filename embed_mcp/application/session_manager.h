@@ -79,7 +79,8 @@ struct mcp_session_manager {
     pthread_mutex_t manager_mutex;
     
     // Cleanup thread
-    pthread_t cleanup_thread;
+    void *cleanup_thread;            // HAL thread handle
+    pthread_cond_t cleanup_cond;     // Signalled on stop to end the wait early
     bool cleanup_running;
     
     // Statistics
@@ -95,7 +96,7 @@ void mcp_session_manager_destroy(mcp_session_manager_t *manager);
 int mcp_session_manager_start(mcp_session_manager_t *manager);
 int mcp_session_manager_stop(mcp_session_manager_t *manager);
 
-// Session management
+// Session management - create/find return a reference, release it with mcp_session_unref()
 mcp_session_t *mcp_session_manager_create_session(mcp_session_manager_t *manager,
                                                  const char *session_id);
 mcp_session_t *mcp_session_manager_find_session(mcp_session_manager_t *manager,
@@ -0,0 +1,248 @@
+#include "worker_pool.h"
+#include "hal/platform_hal.h"
+#include "utils/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 工作线程主循环
+static void *worker_thread_main(void *arg) {
+    mcp_worker_pool_t *pool = (mcp_worker_pool_t*)arg;
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->idle_threads++;
+        while (!pool->head && !pool->shutting_down) {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+        pool->idle_threads--;
+
+        // 关闭时先把队列里的任务执行完
+        mcp_worker_job_t *job = pool->head;
+        if (!job) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+
+        pool->head = job->next;
+        if (!pool->head) pool->tail = NULL;
+        pool->queue_length--;
+        pthread_mutex_unlock(&pool->mutex);
+
+        job->fn(job->arg);
+        hal->memory.free(job);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->jobs_completed++;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return NULL;
+}
+
+// 创建工作线程池
+mcp_worker_pool_t *mcp_worker_pool_create(size_t thread_count, size_t max_queue_length) {
+    if (thread_count == 0) return NULL;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal || !hal->thread.create) return NULL;
+
+    mcp_worker_pool_t *pool = hal->memory.alloc(sizeof(mcp_worker_pool_t));
+    if (!pool) return NULL;
+    memset(pool, 0, sizeof(mcp_worker_pool_t));
+
+    pool->threads = hal->memory.alloc(thread_count * sizeof(void*));
+    if (!pool->threads) {
+        hal->memory.free(pool);
+        return NULL;
+    }
+    memset(pool->threads, 0, thread_count * sizeof(void*));
+
+    pool->max_queue_length = max_queue_length;
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        hal->memory.free(pool->threads);
+        hal->memory.free(pool);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&pool->cond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->mutex);
+        hal->memory.free(pool->threads);
+        hal->memory.free(pool);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < thread_count; i++) {
+        if (hal->thread.create(&pool->threads[i], worker_thread_main, pool, 0) != 0) {
+            mcp_log_error("Worker pool: Failed to create worker thread %zu", i);
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    if (pool->thread_count == 0) {
+        mcp_worker_pool_destroy(pool);
+        return NULL;
+    }
+
+    mcp_log_info("Worker pool started with %zu threads", pool->thread_count);
+    return pool;
+}
+
+// 拒绝新任务但不等待：工作线程执行完队列中的任务后自行退出
+void mcp_worker_pool_close(mcp_worker_pool_t *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutting_down = true;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// 已接收的任务是否都已执行完
+bool mcp_worker_pool_is_drained(mcp_worker_pool_t *pool) {
+    if (!pool) return true;
+
+    pthread_mutex_lock(&pool->mutex);
+    bool drained = pool->jobs_completed == pool->jobs_submitted;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return drained;
+}
+
+// 停止工作线程池：拒绝新任务，执行完队列中的任务后等待线程退出
+void mcp_worker_pool_shutdown(mcp_worker_pool_t *pool) {
+    if (!pool) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    mcp_worker_pool_close(pool);
+
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        if (pool->threads[i]) {
+            hal->thread.join(pool->threads[i]);
+            pool->threads[i] = NULL;
+        }
+    }
+
+    // 没有线程可用时残留的任务在调用线程上执行，任务参数由任务自己释放
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        mcp_worker_job_t *job = pool->head;
+        if (job) {
+            pool->head = job->next;
+            if (!pool->head) pool->tail = NULL;
+            pool->queue_length--;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+        if (!job) break;
+
+        job->fn(job->arg);
+        hal->memory.free(job);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->jobs_completed++;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+// 销毁工作线程池
+void mcp_worker_pool_destroy(mcp_worker_pool_t *pool) {
+    if (!pool) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    mcp_worker_pool_shutdown(pool);
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+
+    hal->memory.free(pool->threads);
+    hal->memory.free(pool);
+}
+
+// 任务入队（调用者持有锁）
+static void worker_pool_enqueue(mcp_worker_pool_t *pool, mcp_worker_job_t *job) {
+    if (pool->tail) {
+        pool->tail->next = job;
+    } else {
+        pool->head = job;
+    }
+    pool->tail = job;
+    pool->queue_length++;
+    pool->jobs_submitted++;
+
+    pthread_cond_signal(&pool->cond);
+}
+
+static mcp_worker_job_t *worker_job_create(mcp_worker_job_fn_t fn, void *arg) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    mcp_worker_job_t *job = hal->memory.alloc(sizeof(mcp_worker_job_t));
+    if (!job) return NULL;
+
+    job->fn = fn;
+    job->arg = arg;
+    job->next = NULL;
+    return job;
+}
+
+// 提交任务
+int mcp_worker_pool_submit(mcp_worker_pool_t *pool, mcp_worker_job_fn_t fn, void *arg) {
+    if (!pool || !fn) return -1;
+
+    mcp_worker_job_t *job = worker_job_create(fn, arg);
+    if (!job) return -1;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (pool->shutting_down ||
+        (pool->max_queue_length > 0 && pool->queue_length >= pool->max_queue_length)) {
+        pool->jobs_rejected++;
+        pthread_mutex_unlock(&pool->mutex);
+        mcp_platform_get_hal()->memory.free(job);
+        return -1;
+    }
+
+    worker_pool_enqueue(pool, job);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+// 仅在有空闲线程可以立即接手时提交：排队中的任务各自占用一个空闲线程
+int mcp_worker_pool_submit_if_idle(mcp_worker_pool_t *pool, mcp_worker_job_fn_t fn, void *arg) {
+    if (!pool || !fn) return -1;
+
+    mcp_worker_job_t *job = worker_job_create(fn, arg);
+    if (!job) return -1;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (pool->shutting_down || pool->idle_threads <= pool->queue_length) {
+        pthread_mutex_unlock(&pool->mutex);
+        mcp_platform_get_hal()->memory.free(job);
+        return -1;
+    }
+
+    worker_pool_enqueue(pool, job);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+size_t mcp_worker_pool_get_thread_count(const mcp_worker_pool_t *pool) {
+    return pool ? pool->thread_count : 0;
+}
+
+size_t mcp_worker_pool_get_queue_length(mcp_worker_pool_t *pool) {
+    if (!pool) return 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    size_t length = pool->queue_length;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return length;
+}
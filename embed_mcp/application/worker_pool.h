@@ -0,0 +1,71 @@
+#ifndef MCP_WORKER_POOL_H
+#define MCP_WORKER_POOL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// Forward declarations
+typedef struct mcp_worker_pool mcp_worker_pool_t;
+typedef struct mcp_worker_job mcp_worker_job_t;
+
+// Job function executed on a worker thread
+typedef void (*mcp_worker_job_fn_t)(void *arg);
+
+// Queued job (FIFO linked list)
+struct mcp_worker_job {
+    mcp_worker_job_fn_t fn;
+    void *arg;
+    mcp_worker_job_t *next;
+};
+
+// Worker pool structure
+struct mcp_worker_pool {
+    // Worker threads (HAL thread handles)
+    void **threads;
+    size_t thread_count;
+
+    // Job queue
+    mcp_worker_job_t *head;
+    mcp_worker_job_t *tail;
+    size_t queue_length;
+    size_t max_queue_length;
+    size_t idle_threads;        // Workers waiting for a job
+
+    // Thread safety
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool shutting_down;
+
+    // Statistics
+    size_t jobs_submitted;
+    size_t jobs_completed;
+    size_t jobs_rejected;
+};
+
+// Worker pool lifecycle
+// max_queue_length == 0 means unbounded.
+mcp_worker_pool_t *mcp_worker_pool_create(size_t thread_count, size_t max_queue_length);
+// Stops accepting jobs without waiting; the workers still run every queued job.
+// Poll mcp_worker_pool_is_drained, then finish with mcp_worker_pool_shutdown.
+void mcp_worker_pool_close(mcp_worker_pool_t *pool);
+// Whether every accepted job has finished
+bool mcp_worker_pool_is_drained(mcp_worker_pool_t *pool);
+// Stops accepting jobs, runs every job still queued and joins the workers.
+// The pool stays valid (submit returns -1) until mcp_worker_pool_destroy.
+void mcp_worker_pool_shutdown(mcp_worker_pool_t *pool);
+// Shuts the pool down if needed, then frees it.
+void mcp_worker_pool_destroy(mcp_worker_pool_t *pool);
+
+// Job submission - returns 0 on success, -1 if the queue is full or the pool is stopping
+int mcp_worker_pool_submit(mcp_worker_pool_t *pool, mcp_worker_job_fn_t fn, void *arg);
+// Submit only if an idle worker will take the job at once, e.g. optional help that
+// is useless once it would wait. Not counted against max_queue_length; returns -1
+// if every worker is busy or the pool is stopping.
+int mcp_worker_pool_submit_if_idle(mcp_worker_pool_t *pool, mcp_worker_job_fn_t fn, void *arg);
+
+// Pool information
+size_t mcp_worker_pool_get_thread_count(const mcp_worker_pool_t *pool);
+size_t mcp_worker_pool_get_queue_length(mcp_worker_pool_t *pool);
+
+#endif // MCP_WORKER_POOL_H
@@ -1,6 +1,7 @@
 #include "embed_mcp.h"
 #include "protocol/mcp_protocol.h"
 #include "transport/transport_interface.h"
+#include "transport/http_transport.h"
 #include "tools/tool_registry.h"
 #include "tools/tool_interface.h"
 #include "tools/resource_registry.h"
@@ -9,17 +10,69 @@
 #include "hal/hal_common.h"
 #include "utils/logging.h"
 #include "utils/error_codes.h"
+#include "utils/arena.h"
+#include "utils/atomic.h"
+#include "utils/json_buffer.h"
+#include "utils/base64.h"
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 
 // Global error message
 static char g_error_message[512] = {0};
 static volatile int g_running = 1;
 
+// Main loop wakeup: self-pipe for STDIO, HAL network wakeup for HTTP
+static int g_wakeup_pipe[2] = {-1, -1};
+
+// Idle timeout of the main loop; stop requests and signals wake it earlier
+#define EMBED_MCP_LOOP_IDLE_MS 1000
+
 // HAL helper functions are now in hal_common.h/c
 
+// Replies of async tool calls outlive the request that started them. They reach the
+// transport through this gate, which is open only while the transport runs; closing it
+// releases the connections still waiting, and late results are dropped.
+typedef struct pending_reply pending_reply_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    int open;
+    bool pretty_json;
+    pending_reply_t *pending;               // Replies holding a detached connection
+    int ref_count;                          // Server plus one per pending reply
+} reply_gate_t;
+
+struct pending_reply {
+    reply_gate_t *gate;
+    mcp_connection_t *connection;           // NULL once answered or the gate closed
+    cJSON *id;                              // Heap copy of the request id
+    cJSON *progress_token;                  // Heap copy of params._meta.progressToken, if any
+    int ref_count;                          // Completion callback, plus the tool's handle
+    pending_reply_t *prev;
+    pending_reply_t *next;
+};
+
+// The tools/call being dispatched on the calling thread. Synchronous tools report
+// progress through it; async handlers pick up their pending reply from it.
+typedef struct {
+    mcp_connection_t *connection;
+    const cJSON *progress_token;            // Borrowed from the request
+    bool pretty_json;
+    pending_reply_t *reply;                 // Set if the response is deferred
+} tool_call_scope_t;
+
+static pthread_key_t g_call_scope_key;
+static pthread_once_t g_call_scope_once = PTHREAD_ONCE_INIT;
+static int g_call_scope_key_created = 0;
+
+// Calls are named "<session id>\n<request id>" for notifications/cancelled
+#define CALL_KEY_SIZE 256
+
 // Server structure
 struct embed_mcp_server {
     char *name;
@@ -34,103 +87,312 @@ struct embed_mcp_server {
     int session_timeout;
     int enable_sessions;
     int auto_cleanup;
+    int worker_threads;
+    int event_loops;
+    int request_arena;
+    size_t list_page_size;
+    size_t max_message_size;
 
     mcp_protocol_t *protocol;
     mcp_transport_t *transport;
     mcp_tool_registry_t *tool_registry;
     mcp_resource_registry_t *resource_registry;
     mcp_session_manager_t *session_manager;
-    mcp_connection_t *current_connection;  // For backward compatibility
+    pthread_key_t connection_key;           // Connection being handled by the calling thread
+    int connection_key_created;
+    reply_gate_t *replies;                  // Async tool results on their way to the transport
 
-    int running;
+    volatile int running;
 };
 
+// Universal function wrapper data
+typedef struct {
+    mcp_universal_func_t wrapper_func;
+    mcp_universal_value_func_t value_func;  // Set instead of wrapper_func for value tools
+    mcp_batch_func_t batch_func;            // Set instead of both for batch tools
+    const char** param_names;
+    mcp_param_type_t* param_types;
+    mcp_param_category_t* param_categories;
+    mcp_packed_type_t* packed_types;    // Element layout of packed parameters
+    size_t param_count;
+    mcp_return_type_t return_type;
+    void* user_data;
+    bool structured_only;       // Skip the text mirror of structuredContent
+
+    // Name index over param_names, built at registration: open addressing with
+    // linear probing, each bucket holding a parameter position or -1
+    uint32_t* param_hashes;
+    int* name_index;
+    size_t name_index_mask;
+} universal_func_data_t;
+
+#define UNIVERSAL_LOCAL_SLOTS 16
+
+// One registered parameter of the call being handled. Arguments are decoded once, in
+// a single pass over the argument object; the getters then read slots instead of
+// searching the object for every parameter.
+typedef struct {
+    const cJSON* item;          // Argument value, NULL if absent
+    mcp_param_value_t value;    // Valid if decoded: the item has the registered type
+    bool decoded;
+} param_slot_t;
+
+// Block of view memory; the union keeps the data that follows it aligned
+typedef union param_scratch {
+    union param_scratch* next;
+    double align_double;
+    int64_t align_int;
+} param_scratch_t;
+
 // Parameter accessor implementation
 typedef struct {
     const cJSON* args;  // JSON arguments from MCP call
+    const universal_func_data_t* func;  // Registered parameters
+    param_slot_t* slots;                // One per registered parameter
+    param_scratch_t* scratch;           // Array views handed out during the call
 } param_accessor_data_t;
 
-// Parameter accessor function implementations
-static int64_t param_get_int(mcp_param_accessor_t* self, const char* name) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsNumber(item)) {
-        return 0;  // Default value for missing/invalid parameters
+static uint32_t param_name_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
     }
-    return (int64_t)cJSON_GetNumberValue(item);
+    return hash;
 }
 
-static double param_get_double(mcp_param_accessor_t* self, const char* name) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsNumber(item)) {
-        return 0.0;  // Default value for missing/invalid parameters
+// Position of a registered parameter, -1 for other names
+static int universal_param_index(const universal_func_data_t* func, const char* name) {
+    if (!func || !func->name_index || !name) {
+        return -1;
+    }
+
+    uint32_t hash = param_name_hash(name);
+    for (size_t i = hash & func->name_index_mask; func->name_index[i] >= 0;
+         i = (i + 1) & func->name_index_mask) {
+        int index = func->name_index[i];
+        if (func->param_hashes[index] == hash && strcmp(func->param_names[index], name) == 0) {
+            return index;
+        }
     }
-    return cJSON_GetNumberValue(item);
+    return -1;
 }
 
-static const char* param_get_string(mcp_param_accessor_t* self, const char* name) {
+static void param_slots_decode(const universal_func_data_t* func, const cJSON* args, param_slot_t* slots) {
+    memset(slots, 0, func->param_count * sizeof(param_slot_t));
+    if (!cJSON_IsObject(args)) {
+        return;
+    }
+
+    for (const cJSON* member = args->child; member; member = member->next) {
+        int index = universal_param_index(func, member->string);
+        if (index < 0 || slots[index].item) {
+            continue;   // Not a parameter, or a repeated key (the first one wins)
+        }
+
+        param_slot_t* slot = &slots[index];
+        slot->item = member;
+        if (func->param_categories[index] != MCP_PARAM_SINGLE) {
+            continue;   // Arrays and objects are converted by their getters
+        }
+
+        slot->value.type = func->param_types[index];
+        switch (func->param_types[index]) {
+            case MCP_PARAM_INT:
+                slot->decoded = cJSON_IsNumber(member);
+                slot->value.int_val = slot->decoded ? (int64_t)member->valuedouble : 0;
+                break;
+            case MCP_PARAM_DOUBLE:
+                slot->decoded = cJSON_IsNumber(member);
+                slot->value.double_val = slot->decoded ? member->valuedouble : 0.0;
+                break;
+            case MCP_PARAM_STRING:
+                slot->decoded = cJSON_IsString(member);
+                slot->value.string_val = slot->decoded ? member->valuestring : NULL;
+                break;
+            case MCP_PARAM_BOOL:
+                slot->decoded = cJSON_IsBool(member);
+                slot->value.bool_val = cJSON_IsTrue(member) ? 1 : 0;
+                break;
+        }
+    }
+}
+
+// Slot of a registered parameter; other names fall back to a search of the object
+static const param_slot_t* param_lookup(mcp_param_accessor_t* self, const char* name, const cJSON** item) {
     param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsString(item)) {
-        return "";  // Default value for missing/invalid parameters
+    int index = data->slots ? universal_param_index(data->func, name) : -1;
+    if (index >= 0) {
+        *item = data->slots[index].item;
+        return &data->slots[index];
     }
-    return cJSON_GetStringValue(item);
+    *item = name ? cJSON_GetObjectItem(data->args, name) : NULL;
+    return NULL;
 }
 
-static int param_get_bool(mcp_param_accessor_t* self, const char* name) {
+static const param_slot_t* param_at(mcp_param_accessor_t* self, size_t index, const cJSON** item) {
     param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsBool(item)) {
-        return 0;  // Default value for missing/invalid parameters
+    if (!data->slots || index >= data->func->param_count) {
+        *item = NULL;
+        return NULL;
     }
-    return cJSON_IsTrue(item) ? 1 : 0;
+    *item = data->slots[index].item;
+    return &data->slots[index];
 }
 
-static double* param_get_double_array(mcp_param_accessor_t* self, const char* name, size_t* count);
-static char** param_get_string_array(mcp_param_accessor_t* self, const char* name, size_t* count);
-static int64_t* param_get_int_array(mcp_param_accessor_t* self, const char* name, size_t* count);
+static const cJSON* param_item(mcp_param_accessor_t* self, const char* name) {
+    const cJSON* item;
+    param_lookup(self, name, &item);
+    return item;
+}
 
-static int param_try_get_int(mcp_param_accessor_t* self, const char* name, int64_t* out) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsNumber(item) || !out) {
+// Read a value, from its decoded slot when the type matches
+static int param_read_int(const param_slot_t* slot, const cJSON* item, int64_t* out) {
+    if (slot && slot->decoded && slot->value.type == MCP_PARAM_INT) {
+        *out = slot->value.int_val;
+        return 1;
+    }
+    if (!cJSON_IsNumber(item)) {
         return 0;
     }
     *out = (int64_t)cJSON_GetNumberValue(item);
     return 1;
 }
 
-static int param_try_get_double(mcp_param_accessor_t* self, const char* name, double* out) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsNumber(item) || !out) {
+static int param_read_double(const param_slot_t* slot, const cJSON* item, double* out) {
+    if (slot && slot->decoded && slot->value.type == MCP_PARAM_DOUBLE) {
+        *out = slot->value.double_val;
+        return 1;
+    }
+    if (!cJSON_IsNumber(item)) {
         return 0;
     }
     *out = cJSON_GetNumberValue(item);
     return 1;
 }
 
-static int param_try_get_string(mcp_param_accessor_t* self, const char* name, const char** out) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsString(item) || !out) {
+static int param_read_string(const param_slot_t* slot, const cJSON* item, const char** out) {
+    if (slot && slot->decoded && slot->value.type == MCP_PARAM_STRING) {
+        *out = slot->value.string_val;
+        return 1;
+    }
+    if (!cJSON_IsString(item)) {
         return 0;
     }
     *out = cJSON_GetStringValue(item);
     return 1;
 }
 
-static int param_try_get_bool(mcp_param_accessor_t* self, const char* name, int* out) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsBool(item) || !out) {
+static int param_read_bool(const param_slot_t* slot, const cJSON* item, int* out) {
+    if (slot && slot->decoded && slot->value.type == MCP_PARAM_BOOL) {
+        *out = slot->value.bool_val;
+        return 1;
+    }
+    if (!cJSON_IsBool(item)) {
         return 0;
     }
     *out = cJSON_IsTrue(item) ? 1 : 0;
     return 1;
 }
 
+// Parameter accessor function implementations
+// Missing or invalid parameters read as 0, 0.0, "" and false
+static int64_t param_get_int(mcp_param_accessor_t* self, const char* name) {
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    int64_t value;
+    return param_read_int(slot, item, &value) ? value : 0;
+}
+
+static double param_get_double(mcp_param_accessor_t* self, const char* name) {
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    double value;
+    return param_read_double(slot, item, &value) ? value : 0.0;
+}
+
+static const char* param_get_string(mcp_param_accessor_t* self, const char* name) {
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    const char* value;
+    return param_read_string(slot, item, &value) ? value : "";
+}
+
+static int param_get_bool(mcp_param_accessor_t* self, const char* name) {
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    int value;
+    return param_read_bool(slot, item, &value) ? value : 0;
+}
+
+static int64_t param_get_int_at(mcp_param_accessor_t* self, size_t index) {
+    const cJSON* item;
+    const param_slot_t* slot = param_at(self, index, &item);
+    int64_t value;
+    return param_read_int(slot, item, &value) ? value : 0;
+}
+
+static double param_get_double_at(mcp_param_accessor_t* self, size_t index) {
+    const cJSON* item;
+    const param_slot_t* slot = param_at(self, index, &item);
+    double value;
+    return param_read_double(slot, item, &value) ? value : 0.0;
+}
+
+static const char* param_get_string_at(mcp_param_accessor_t* self, size_t index) {
+    const cJSON* item;
+    const param_slot_t* slot = param_at(self, index, &item);
+    const char* value;
+    return param_read_string(slot, item, &value) ? value : "";
+}
+
+static int param_get_bool_at(mcp_param_accessor_t* self, size_t index) {
+    const cJSON* item;
+    const param_slot_t* slot = param_at(self, index, &item);
+    int value;
+    return param_read_bool(slot, item, &value) ? value : 0;
+}
+
+static double* param_get_double_array(mcp_param_accessor_t* self, const char* name, size_t* count);
+static char** param_get_string_array(mcp_param_accessor_t* self, const char* name, size_t* count);
+static int64_t* param_get_int_array(mcp_param_accessor_t* self, const char* name, size_t* count);
+
+static int param_try_get_int(mcp_param_accessor_t* self, const char* name, int64_t* out) {
+    if (!out) {
+        return 0;
+    }
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    return param_read_int(slot, item, out);
+}
+
+static int param_try_get_double(mcp_param_accessor_t* self, const char* name, double* out) {
+    if (!out) {
+        return 0;
+    }
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    return param_read_double(slot, item, out);
+}
+
+static int param_try_get_string(mcp_param_accessor_t* self, const char* name, const char** out) {
+    if (!out) {
+        return 0;
+    }
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    return param_read_string(slot, item, out);
+}
+
+static int param_try_get_bool(mcp_param_accessor_t* self, const char* name, int* out) {
+    if (!out) {
+        return 0;
+    }
+    const cJSON* item;
+    const param_slot_t* slot = param_lookup(self, name, &item);
+    return param_read_bool(slot, item, out);
+}
+
 static int param_try_get_double_array(mcp_param_accessor_t* self, const char* name, double** out, size_t* count) {
     if (!out || !count) {
         return 0;
@@ -155,66 +417,244 @@ static int param_try_get_int_array(mcp_param_accessor_t* self, const char* name,
     return (*out != NULL);
 }
 
-static double* param_get_double_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
+// Array elements are visited in one walk of the child list; cJSON_GetArrayItem()
+// would start from the head again for every index
+static size_t param_array_size(const cJSON* item) {
+    size_t size = 0;
+    for (const cJSON* element = item->child; element; element = element->next) {
+        size++;
+    }
+    return size;
+}
+
+// The named array and its size, NULL if it is missing, not an array or empty
+static const cJSON* param_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    const cJSON* item = param_item(self, name);
+    *count = cJSON_IsArray(item) ? param_array_size(item) : 0;
+    return *count > 0 ? item : NULL;
+}
+
+// Fill up to capacity values; non-numeric elements read as 0
+static void param_fill_doubles(const cJSON* array, double* out, size_t capacity) {
+    size_t i = 0;
+    for (const cJSON* element = array->child; element && i < capacity; element = element->next) {
+        out[i++] = cJSON_IsNumber(element) ? element->valuedouble : 0.0;
+    }
+}
+
+static void param_fill_ints(const cJSON* array, int64_t* out, size_t capacity) {
+    size_t i = 0;
+    for (const cJSON* element = array->child; element && i < capacity; element = element->next) {
+        out[i++] = cJSON_IsNumber(element) ? (int64_t)element->valuedouble : 0;
+    }
+}
+
+// Memory for views, released when the tool function returns. Inside a request it is
+// carved from the request arena.
+static void* param_scratch_alloc(mcp_param_accessor_t* self, size_t count, size_t element_size) {
     param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsArray(item)) {
-        *count = 0;
+    if (count > (SIZE_MAX - sizeof(param_scratch_t)) / element_size) {
         return NULL;
     }
 
-    int array_size = cJSON_GetArraySize(item);
-    if (array_size <= 0) {
-        *count = 0;
+    param_scratch_t* block = cJSON_malloc(sizeof(param_scratch_t) + count * element_size);
+    if (!block) {
         return NULL;
     }
+    block->next = data->scratch;
+    data->scratch = block;
+    return block + 1;
+}
 
-    double* result = malloc(array_size * sizeof(double));
-    if (!result) {
-        *count = 0;
+static void param_scratch_release(param_accessor_data_t* data) {
+    while (data->scratch) {
+        param_scratch_t* next = data->scratch->next;
+        cJSON_free(data->scratch);
+        data->scratch = next;
+    }
+}
+
+// Packed parameters: the base64 text decodes into the tail of the output buffer, and
+// each element is then widened to 8 bytes front to back, so one buffer holds both
+// and no element needs a JSON node. A double parameter on a little-endian host is
+// decoded in place with nothing left to convert.
+static size_t packed_element_size(mcp_packed_type_t type) {
+    return (type == MCP_PACKED_INT32 || type == MCP_PACKED_FLOAT) ? 4 : 8;
+}
+
+static uint64_t packed_load(const unsigned char* bytes, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; i--) {
+        value = (value << 8) | bytes[i - 1];
+    }
+    return value;
+}
+
+// The named packed parameter, NULL if the name is not one
+static const cJSON* param_packed(mcp_param_accessor_t* self, const char* name, mcp_packed_type_t* type) {
+    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
+    int index = data->slots ? universal_param_index(data->func, name) : -1;
+    if (index < 0 || data->func->param_categories[index] != MCP_PARAM_PACKED) {
         return NULL;
     }
+    *type = data->func->packed_types[index];
+    return data->slots[index].item;
+}
+
+// Element count of a packed value, -1 unless it is base64 of whole elements
+static int packed_count(const cJSON* item, mcp_packed_type_t type, size_t* count) {
+    if (!cJSON_IsString(item)) {
+        return -1;
+    }
+    size_t length = strlen(item->valuestring);
+    if (length % 4 != 0) {
+        return -1;
+    }
+    size_t bytes = base64_decoded_size(item->valuestring, length);
+    if (bytes % packed_element_size(type) != 0) {
+        return -1;
+    }
+    *count = bytes / packed_element_size(type);
+    return 0;
+}
+
+// Decode count elements into out, as doubles or as int64_t
+static int packed_decode(const cJSON* item, mcp_packed_type_t type, bool as_double, void* out, size_t count) {
+    size_t size = packed_element_size(type);
+    size_t length = strlen(item->valuestring);
+    unsigned char* bytes = (unsigned char*)out + count * (8 - size);
+    if (count > 0 && base64_decode(item->valuestring, length, bytes, count * size) != count * size) {
+        return -1;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if ((type == MCP_PACKED_DOUBLE && as_double) || (type == MCP_PACKED_INT64 && !as_double)) {
+        return 0;
+    }
+#endif
 
-    *count = array_size;
-    for (int i = 0; i < array_size; i++) {
-        const cJSON* element = cJSON_GetArrayItem(item, i);
-        if (cJSON_IsNumber(element)) {
-            result[i] = cJSON_GetNumberValue(element);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t raw = packed_load(bytes + i * size, size);
+        double real = 0.0;
+        int64_t integer = 0;
+        switch (type) {
+            case MCP_PACKED_INT32:
+                integer = (int32_t)(uint32_t)raw;
+                real = (double)integer;
+                break;
+            case MCP_PACKED_INT64:
+                integer = (int64_t)raw;
+                real = (double)integer;
+                break;
+            case MCP_PACKED_FLOAT: {
+                uint32_t bits = (uint32_t)raw;
+                float value;
+                memcpy(&value, &bits, sizeof(value));
+                real = value;
+                integer = (int64_t)real;
+                break;
+            }
+            case MCP_PACKED_DOUBLE:
+                memcpy(&real, &raw, sizeof(real));
+                integer = (int64_t)real;
+                break;
+        }
+        if (as_double) {
+            ((double*)out)[i] = real;
         } else {
-            result[i] = 0.0;  // Default for invalid elements
+            ((int64_t*)out)[i] = integer;
         }
     }
+    return 0;
+}
 
+// Decoded packed array from the heap (owned by the caller) or scratch (a view);
+// NULL with *count 0 if it is empty or not valid base64
+static void* param_packed_array(mcp_param_accessor_t* self, const cJSON* item, mcp_packed_type_t type,
+                                bool as_double, bool view, size_t* count) {
+    size_t size;
+    void* result = NULL;
+    if (packed_count(item, type, &size) == 0 && size > 0) {
+        if (view) {
+            result = param_scratch_alloc(self, size, 8);
+        } else if (size <= SIZE_MAX / 8) {
+            result = malloc(size * 8);
+        }
+        if (result && packed_decode(item, type, as_double, result, size) != 0) {
+            if (!view) {
+                free(result);
+            }
+            result = NULL;
+        }
+    }
+    *count = result ? size : 0;
     return result;
 }
 
-static char** param_get_string_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsArray(item)) {
-        *count = 0;
+// Copy into a caller buffer; returns the element count, 0 if empty or invalid
+static size_t param_packed_copy(mcp_param_accessor_t* self, const cJSON* item, mcp_packed_type_t type,
+                                bool as_double, void* out, size_t capacity) {
+    size_t size;
+    if (packed_count(item, type, &size) != 0) {
+        return 0;
+    }
+    if (!out || capacity == 0) {
+        return size;
+    }
+    if (capacity >= size) {
+        return packed_decode(item, type, as_double, out, size) == 0 ? size : 0;
+    }
+
+    // Partial copy through a scratch buffer, which the decode needs room for
+    size_t decoded;
+    void* values = param_packed_array(self, item, type, as_double, true, &decoded);
+    if (!values) {
+        return 0;
+    }
+    memcpy(out, values, capacity * 8);
+    return size;
+}
+
+static double* param_get_double_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        return param_packed_array(self, packed, type, true, false, count);
+    }
+
+    const cJSON* item = param_array(self, name, count);
+    if (!item) {
         return NULL;
     }
 
-    int array_size = cJSON_GetArraySize(item);
-    if (array_size <= 0) {
+    double* result = malloc(*count * sizeof(double));
+    if (!result) {
         *count = 0;
         return NULL;
     }
 
-    char** result = malloc(array_size * sizeof(char*));
+    param_fill_doubles(item, result, *count);
+    return result;
+}
+
+static char** param_get_string_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    const cJSON* item = param_array(self, name, count);
+    if (!item) {
+        return NULL;
+    }
+
+    char** result = malloc(*count * sizeof(char*));
     if (!result) {
         *count = 0;
         return NULL;
     }
 
-    *count = array_size;
-    for (int i = 0; i < array_size; i++) {
-        const cJSON* element = cJSON_GetArrayItem(item, i);
+    size_t i = 0;
+    for (const cJSON* element = item->child; element; element = element->next) {
         if (cJSON_IsString(element)) {
-            result[i] = strdup(cJSON_GetStringValue(element));
+            result[i++] = strdup(cJSON_GetStringValue(element));
         } else {
-            result[i] = strdup("");  // Default for invalid elements
+            result[i++] = strdup("");  // Default for invalid elements
         }
     }
 
@@ -222,41 +662,122 @@ static char** param_get_string_array(mcp_param_accessor_t* self, const char* nam
 }
 
 static int64_t* param_get_int_array(mcp_param_accessor_t* self, const char* name, size_t* count) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    const cJSON* item = cJSON_GetObjectItem(data->args, name);
-    if (!item || !cJSON_IsArray(item)) {
-        *count = 0;
-        return NULL;
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        return param_packed_array(self, packed, type, false, false, count);
     }
 
-    int array_size = cJSON_GetArraySize(item);
-    if (array_size <= 0) {
-        *count = 0;
+    const cJSON* item = param_array(self, name, count);
+    if (!item) {
         return NULL;
     }
 
-    int64_t* result = malloc(array_size * sizeof(int64_t));
+    int64_t* result = malloc(*count * sizeof(int64_t));
     if (!result) {
         *count = 0;
         return NULL;
     }
 
-    *count = array_size;
-    for (int i = 0; i < array_size; i++) {
-        const cJSON* element = cJSON_GetArrayItem(item, i);
-        if (cJSON_IsNumber(element)) {
-            result[i] = (int64_t)cJSON_GetNumberValue(element);
-        } else {
-            result[i] = 0;  // Default for invalid elements
+    param_fill_ints(item, result, *count);
+    return result;
+}
+
+static const double* param_get_double_array_view(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    size_t size;
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        double* values = param_packed_array(self, packed, type, true, true, &size);
+        if (count) {
+            *count = size;
+        }
+        return values;
+    }
+
+    const cJSON* item = param_array(self, name, &size);
+    double* result = item ? param_scratch_alloc(self, size, sizeof(double)) : NULL;
+    if (count) {
+        *count = result ? size : 0;
+    }
+    if (result) {
+        param_fill_doubles(item, result, size);
+    }
+    return result;
+}
+
+static const int64_t* param_get_int_array_view(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    size_t size;
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        int64_t* values = param_packed_array(self, packed, type, false, true, &size);
+        if (count) {
+            *count = size;
         }
+        return values;
+    }
+
+    const cJSON* item = param_array(self, name, &size);
+    int64_t* result = item ? param_scratch_alloc(self, size, sizeof(int64_t)) : NULL;
+    if (count) {
+        *count = result ? size : 0;
+    }
+    if (result) {
+        param_fill_ints(item, result, size);
     }
+    return result;
+}
 
+static const char** param_get_string_array_view(mcp_param_accessor_t* self, const char* name, size_t* count) {
+    size_t size;
+    const cJSON* item = param_array(self, name, &size);
+    const char** result = item ? param_scratch_alloc(self, size, sizeof(char*)) : NULL;
+    if (count) {
+        *count = result ? size : 0;
+    }
+    if (result) {
+        // The strings themselves are the parsed arguments'
+        size_t i = 0;
+        for (const cJSON* element = item->child; element; element = element->next) {
+            result[i++] = cJSON_IsString(element) ? element->valuestring : "";
+        }
+    }
     return result;
 }
 
+static size_t param_copy_double_array(mcp_param_accessor_t* self, const char* name, double* out, size_t capacity) {
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        return param_packed_copy(self, packed, type, true, out, capacity);
+    }
+
+    size_t size;
+    const cJSON* item = param_array(self, name, &size);
+    if (item && out) {
+        param_fill_doubles(item, out, capacity);
+    }
+    return size;
+}
+
+static size_t param_copy_int_array(mcp_param_accessor_t* self, const char* name, int64_t* out, size_t capacity) {
+    mcp_packed_type_t type;
+    const cJSON* packed = param_packed(self, name, &type);
+    if (packed) {
+        return param_packed_copy(self, packed, type, false, out, capacity);
+    }
+
+    size_t size;
+    const cJSON* item = param_array(self, name, &size);
+    if (item && out) {
+        param_fill_ints(item, out, capacity);
+    }
+    return size;
+}
+
 static int param_has_param(mcp_param_accessor_t* self, const char* name) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    return cJSON_HasObjectItem(data->args, name) ? 1 : 0;
+    return param_item(self, name) ? 1 : 0;
 }
 
 static size_t param_get_param_count(mcp_param_accessor_t* self) {
@@ -268,14 +789,77 @@ static size_t param_get_param_count(mcp_param_accessor_t* self) {
 }
 
 static const cJSON* param_get_json(mcp_param_accessor_t* self, const char* name) {
-    param_accessor_data_t* data = (param_accessor_data_t*)self->data;
-    return cJSON_GetObjectItem(data->args, name);
+    return param_item(self, name);
+}
+
+static int param_is_cancelled(mcp_param_accessor_t* self) {
+    (void)self;
+    return embed_mcp_tool_cancelled();
+}
+
+static int param_report_progress(mcp_param_accessor_t* self, double progress, double total,
+                                 const char* message) {
+    (void)self;
+    return embed_mcp_report_progress(progress, total, message);
 }
 
 // Signal handler for graceful shutdown
+// Wake the main loop - async-signal-safe
+static void wake_main_loop(void) {
+    if (g_wakeup_pipe[1] >= 0) {
+        ssize_t written = write(g_wakeup_pipe[1], "w", 1);
+        (void)written;
+    }
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (hal && hal->network.network_wakeup) {
+        hal->network.network_wakeup();
+    }
+}
+
 static void signal_handler(int sig) {
     (void)sig;
     g_running = 0;
+    wake_main_loop();
+}
+
+static int wakeup_pipe_open(void) {
+    if (g_wakeup_pipe[0] >= 0) return 0;
+
+    if (pipe(g_wakeup_pipe) != 0) {
+        g_wakeup_pipe[0] = g_wakeup_pipe[1] = -1;
+        return -1;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        int flags = fcntl(g_wakeup_pipe[i], F_GETFL, 0);
+        fcntl(g_wakeup_pipe[i], F_SETFL, flags | O_NONBLOCK);
+    }
+    return 0;
+}
+
+static void wakeup_pipe_close(void) {
+    for (int i = 0; i < 2; i++) {
+        if (g_wakeup_pipe[i] >= 0) {
+            close(g_wakeup_pipe[i]);
+            g_wakeup_pipe[i] = -1;
+        }
+    }
+}
+
+// Block until woken or the idle timeout expires, then drain the pipe
+static void wakeup_pipe_wait(int timeout_ms) {
+    if (g_wakeup_pipe[0] < 0) {
+        usleep((useconds_t)timeout_ms * 1000);
+        return;
+    }
+
+    struct pollfd pfd = { .fd = g_wakeup_pipe[0], .events = POLLIN, .revents = 0 };
+    if (poll(&pfd, 1, timeout_ms) > 0) {
+        char drain[64];
+        while (read(g_wakeup_pipe[0], drain, sizeof(drain)) > 0) {
+        }
+    }
 }
 
 // Set error message
@@ -288,11 +872,18 @@ static void set_error(const char *message) {
 static int protocol_send_callback(const char *data, size_t length, void *user_data) {
     embed_mcp_server_t *server = (embed_mcp_server_t*)user_data;
     
-    if (!server || !server->current_connection) {
+    if (!server || !server->connection_key_created) {
         return -1;
     }
-    
-    return mcp_connection_send(server->current_connection, data, length);
+
+    // Requests may be handled concurrently by worker threads, so the reply
+    // connection is tracked per thread.
+    mcp_connection_t *connection = pthread_getspecific(server->connection_key);
+    if (!connection) {
+        return -1;
+    }
+
+    return mcp_connection_send(connection, data, length);
 }
 
 // Update dynamic capabilities based on registered features
@@ -323,6 +914,389 @@ static void update_dynamic_capabilities(embed_mcp_server_t *server) {
 }
 
 // Protocol request handler
+// Opaque list cursors: base64 of "<list>:<position>", so a cursor from one list is
+// rejected by the others. Positions come from the registries and stay valid while
+// entries are added.
+#define LIST_CURSOR_SIZE 48
+
+static void list_cursor_encode(char list, uint64_t position, char *out, size_t size) {
+    char plain[32];
+    int length = snprintf(plain, sizeof(plain), "%c:%llu", list, (unsigned long long)position);
+    if (length < 0 || base64_encode((const unsigned char*)plain, (size_t)length, out, size) == 0) {
+        out[0] = '\0';
+    }
+}
+
+// 0 with *position = 0 when params carry no cursor, -1 if the cursor is not one of ours
+static int list_cursor_decode(const cJSON *params, char list, uint64_t *position) {
+    *position = 0;
+
+    cJSON *cursor = params ? cJSON_GetObjectItem(params, "cursor") : NULL;
+    if (!cursor || cJSON_IsNull(cursor)) return 0;
+    if (!cJSON_IsString(cursor)) return -1;
+
+    const char *text = cursor->valuestring;
+    size_t length = strlen(text);
+    char plain[32];
+    if (length == 0 || length >= LIST_CURSOR_SIZE ||
+        strspn(text, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=") != length) {
+        return -1;
+    }
+
+    size_t plain_length = base64_decode(text, length, (unsigned char*)plain, sizeof(plain) - 1);
+    if (plain_length < 3 || plain[0] != list || plain[1] != ':') return -1;
+    plain[plain_length] = '\0';
+
+    char *end;
+    unsigned long long value = strtoull(plain + 2, &end, 10);
+    if (*end != '\0' || value == 0) return -1;
+
+    *position = value;
+    return 0;
+}
+
+static void list_cursor_add(cJSON *result, char list, uint64_t next_position) {
+    if (next_position == 0) return;
+
+    char cursor[LIST_CURSOR_SIZE];
+    list_cursor_encode(list, next_position, cursor, sizeof(cursor));
+    cJSON_AddStringToObject(result, "nextCursor", cursor);
+}
+
+// Built-in resource: registry totals plus counters and latency percentiles per tool
+static char *tool_stats_resource(void *user_data) {
+    embed_mcp_server_t *server = (embed_mcp_server_t*)user_data;
+
+    cJSON *stats = mcp_tool_registry_get_stats(server->tool_registry);
+    if (!stats) return NULL;
+
+    cJSON *tools = mcp_tool_registry_get_all_tool_stats(server->tool_registry);
+    if (tools) {
+        cJSON_AddItemToObject(stats, "tools", tools);
+    }
+
+    // The resource layer releases the text with free(), so copy it out of the render buffer
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    char *text = NULL;
+    if (buffer && mcp_json_buffer_print(buffer, stats, false) == 0) {
+        text = strdup(buffer->data);
+    }
+
+    cJSON_Delete(stats);
+    return text;
+}
+
+// Async tool replies
+static reply_gate_t *reply_gate_create(bool pretty_json) {
+    reply_gate_t *gate = calloc(1, sizeof(reply_gate_t));
+    if (!gate) return NULL;
+
+    if (pthread_mutex_init(&gate->mutex, NULL) != 0) {
+        free(gate);
+        return NULL;
+    }
+    gate->pretty_json = pretty_json;
+    gate->ref_count = 1;
+    return gate;
+}
+
+static void reply_gate_unref(reply_gate_t *gate) {
+    if (gate && MCP_REF_DEC(&gate->ref_count) == 0) {
+        pthread_mutex_destroy(&gate->mutex);
+        free(gate);
+    }
+}
+
+static void reply_gate_set_open(reply_gate_t *gate, int open) {
+    if (!gate) return;
+
+    pthread_mutex_lock(&gate->mutex);
+    gate->open = open;
+    if (!open) {
+        // The transport is about to stop: give back every connection still waiting
+        for (pending_reply_t *reply = gate->pending; reply; reply = reply->next) {
+            mcp_connection_release(reply->connection);
+            reply->connection = NULL;
+        }
+        gate->pending = NULL;
+    }
+    pthread_mutex_unlock(&gate->mutex);
+}
+
+// Tool call scope
+static void call_scope_key_create(void) {
+    g_call_scope_key_created = pthread_key_create(&g_call_scope_key, NULL) == 0;
+}
+
+// Returns the enclosing scope, to be restored by call_scope_leave()
+static tool_call_scope_t *call_scope_enter(tool_call_scope_t *scope) {
+    pthread_once(&g_call_scope_once, call_scope_key_create);
+    if (!g_call_scope_key_created) return NULL;
+
+    tool_call_scope_t *outer = pthread_getspecific(g_call_scope_key);
+    pthread_setspecific(g_call_scope_key, scope);
+    return outer;
+}
+
+static void call_scope_leave(tool_call_scope_t *outer) {
+    if (g_call_scope_key_created) {
+        pthread_setspecific(g_call_scope_key, outer);
+    }
+}
+
+static tool_call_scope_t *call_scope_current(void) {
+    pthread_once(&g_call_scope_once, call_scope_key_create);
+    return g_call_scope_key_created ? pthread_getspecific(g_call_scope_key) : NULL;
+}
+
+// Key under which a call is registered for cancellation: the client names the request
+// by its id alone, so the session keeps ids of different clients apart. Returns NULL
+// if the id cannot be a request id or the key does not fit.
+static const char *call_key_format(char *buffer, size_t size, const mcp_connection_t *connection,
+                                   const cJSON *id) {
+    const char *session = mcp_connection_get_session_id(connection);
+    int length;
+
+    if (cJSON_IsString(id)) {
+        length = snprintf(buffer, size, "%s\ns:%s", session ? session : "", id->valuestring);
+    } else if (cJSON_IsNumber(id)) {
+        length = snprintf(buffer, size, "%s\nn:%.17g", session ? session : "", id->valuedouble);
+    } else {
+        return NULL;
+    }
+
+    return length > 0 && (size_t)length < size ? buffer : NULL;
+}
+
+// Render and send notifications/progress; the caller keeps the connection alive
+static int send_progress(mcp_connection_t *connection, const cJSON *progress_token, bool pretty_json,
+                         double progress, double total, const char *message) {
+    if (!connection || !progress_token || !mcp_connection_can_notify(connection)) {
+        return -1;
+    }
+
+    cJSON *params = cJSON_CreateObject();
+    if (!params) return -1;
+    cJSON_AddItemToObject(params, "progressToken", cJSON_Duplicate(progress_token, 1));
+    cJSON_AddNumberToObject(params, "progress", progress);
+    if (total > 0) {
+        cJSON_AddNumberToObject(params, "total", total);
+    }
+    if (message) {
+        cJSON_AddStringToObject(params, "message", message);
+    }
+
+    mcp_request_t notification = {
+        .jsonrpc = JSONRPC_VERSION,
+        .id = NULL,
+        .method = (char*)MCP_METHOD_PROGRESS,
+        .params = params,
+        .is_notification = true
+    };
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    int result = -1;
+    if (buffer && jsonrpc_render_request(&notification, pretty_json, buffer) == 0) {
+        result = mcp_connection_send(connection, buffer->data, buffer->length) < 0 ? -1 : 0;
+        mcp_json_buffer_trim(buffer);
+    }
+    cJSON_Delete(params);
+
+    return result;
+}
+
+// Set up the reply to the request being handled; NULL if it cannot be deferred
+static pending_reply_t *pending_reply_create(embed_mcp_server_t *server, const cJSON *id,
+                                             const cJSON *progress_token) {
+    mcp_connection_t *request_connection = pthread_getspecific(server->connection_key);
+    reply_gate_t *gate = server->replies;
+    if (!gate || !request_connection) return NULL;
+
+    pending_reply_t *reply = calloc(1, sizeof(pending_reply_t));
+    if (!reply) return NULL;
+    reply->ref_count = 1;
+
+    // The id lives in the request document, which is gone when the reply is sent
+    bool saved = mcp_arena_suspend();
+    reply->id = cJSON_Duplicate(id, 1);
+    reply->progress_token = progress_token ? cJSON_Duplicate(progress_token, 1) : NULL;
+    mcp_arena_resume(saved);
+
+    pthread_mutex_lock(&gate->mutex);
+    if (gate->open && reply->id && (reply->progress_token || !progress_token)) {
+        reply->connection = mcp_connection_detach(request_connection);
+    }
+    if (reply->connection) {
+        reply->gate = gate;
+        MCP_REF_INC(&gate->ref_count);
+        reply->next = gate->pending;
+        if (gate->pending) gate->pending->prev = reply;
+        gate->pending = reply;
+    }
+    pthread_mutex_unlock(&gate->mutex);
+
+    if (!reply->connection) {
+        cJSON_Delete(reply->id);
+        cJSON_Delete(reply->progress_token);
+        free(reply);
+        return NULL;
+    }
+    return reply;
+}
+
+static void pending_reply_unref(pending_reply_t *reply) {
+    if (!reply || MCP_REF_DEC(&reply->ref_count) != 0) return;
+
+    reply_gate_t *gate = reply->gate;
+    cJSON_Delete(reply->id);
+    cJSON_Delete(reply->progress_token);
+    free(reply);
+    reply_gate_unref(gate);
+}
+
+// Sent under the gate mutex, so progress never overtakes the response
+static int pending_reply_progress(pending_reply_t *reply, double progress, double total,
+                                  const char *message) {
+    if (!reply || !reply->progress_token) return -1;
+
+    reply_gate_t *gate = reply->gate;
+    pthread_mutex_lock(&gate->mutex);
+    int result = send_progress(reply->connection, reply->progress_token, gate->pretty_json,
+                               progress, total, message);
+    pthread_mutex_unlock(&gate->mutex);
+
+    return result;
+}
+
+// Completion of an async tools/call, on whichever thread the tool finished.
+// A NULL result means the client cancelled the request, which then gets no response;
+// only plain HTTP, which holds the POST open until it is answered, gets an error.
+static void pending_reply_complete(cJSON *result, void *context) {
+    pending_reply_t *reply = (pending_reply_t*)context;
+    reply_gate_t *gate = reply->gate;
+
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    bool rendered = false;
+    if (result) {
+        mcp_response_t response = {
+            .jsonrpc = JSONRPC_VERSION,
+            .id = reply->id,
+            .result = result,
+            .error = NULL
+        };
+        rendered = buffer && jsonrpc_render_response(&response, gate->pretty_json, buffer) == 0;
+        cJSON_Delete(result);
+    }
+
+    pthread_mutex_lock(&gate->mutex);
+    mcp_connection_t *connection = reply->connection;
+    if (connection) {
+        if (reply->prev) reply->prev->next = reply->next;
+        else gate->pending = reply->next;
+        if (reply->next) reply->next->prev = reply->prev;
+        reply->connection = NULL;
+
+        if (!result) {
+            mcp_log_debug("Async tool call cancelled by the client");
+            if (!mcp_connection_can_notify(connection) && buffer &&
+                jsonrpc_render_error(reply->id, MCP_ERROR_REQUEST_CANCELLED, "Request cancelled",
+                                     NULL, gate->pretty_json, buffer) == 0) {
+                mcp_connection_send(connection, buffer->data, buffer->length);
+            }
+        } else if (!rendered || mcp_connection_send(connection, buffer->data, buffer->length) < 0) {
+            mcp_log_error("Failed to send async tool result");
+        }
+        mcp_connection_release(connection);
+    } else {
+        mcp_log_debug("Dropping async tool result: transport stopped");
+    }
+    pthread_mutex_unlock(&gate->mutex);
+
+    if (buffer) mcp_json_buffer_trim(buffer);
+    pending_reply_unref(reply);
+}
+
+// tools/call: async tools reply later through the gate, others right away. Synchronous
+// tools with a deadline also reply through the gate when the transport can deliver that
+// reply while the tool still holds this thread (STDIO, HTTP workers), so the deadline
+// can answer the client on time. Elsewhere the early answer would wait for the tool
+// anyway, and the direct reply saves the gate's allocations and the cross-thread post.
+// Within a batch every call is answered before the batch response goes out, so async
+// tools are waited for there, up to their deadline.
+static cJSON *call_tool(embed_mcp_server_t *server, const mcp_request_t *request,
+                        const char *name, const cJSON *arguments) {
+    mcp_tool_entry_t *entry = mcp_tool_registry_acquire_entry(server->tool_registry, name);
+    if (!entry) {
+        return mcp_tool_registry_create_tool_not_found_error(name);
+    }
+
+    const cJSON *meta = request->params ? cJSON_GetObjectItem(request->params, "_meta") : NULL;
+    const cJSON *progress_token = meta ? cJSON_GetObjectItem(meta, "progressToken") : NULL;
+    if (!cJSON_IsString(progress_token) && !cJSON_IsNumber(progress_token)) {
+        progress_token = NULL;
+    }
+
+    mcp_connection_t *connection = pthread_getspecific(server->connection_key);
+    char key_buffer[CALL_KEY_SIZE];
+    const char *call_key = call_key_format(key_buffer, sizeof(key_buffer), connection, request->id);
+
+    tool_call_scope_t scope = {
+        .connection = connection,
+        .progress_token = progress_token,
+        .pretty_json = server->protocol->config->pretty_json,
+        .reply = !request->in_batch &&
+                 (mcp_tool_is_async(entry->tool) ||
+                  (mcp_connection_can_reply_early(connection) &&
+                   mcp_tool_registry_get_call_budget_ms(server->tool_registry, entry) > 0)) ?
+                 pending_reply_create(server, request->id, progress_token) : NULL
+    };
+    tool_call_scope_t *outer = call_scope_enter(&scope);
+
+    cJSON *result = NULL;
+    if (scope.reply) {
+        // Held until the handler has taken its own reference; the reply may already be
+        // answered by then (deadline, cancellation)
+        MCP_REF_INC(&scope.reply->ref_count);
+        if (mcp_tool_registry_call_entry_async(server->tool_registry, entry, arguments, call_key,
+                                               pending_reply_complete, scope.reply) != 0) {
+            pending_reply_complete(mcp_tool_create_memory_error(), scope.reply);
+        }
+        pending_reply_unref(scope.reply);
+        result = MCP_PROTOCOL_RESPONSE_DEFERRED;
+    } else {
+        // Also the fallback when the transport cannot defer the reply
+        result = mcp_tool_registry_call_entry(server->tool_registry, entry, arguments, call_key);
+    }
+
+    call_scope_leave(outer);
+    mcp_tool_registry_release_entry(entry);
+    return result;
+}
+
+// notifications/cancelled: raise the cancellation flag of the named call. Requests
+// that are not (or no longer) running are ignored, as the specification asks.
+static void protocol_notification_handler(const mcp_request_t *notification, void *user_data) {
+    embed_mcp_server_t *server = (embed_mcp_server_t*)user_data;
+    if (!server || !notification || !notification->method ||
+        strcmp(notification->method, MCP_METHOD_CANCELLED) != 0) {
+        return;
+    }
+
+    const cJSON *request_id = notification->params ?
+                              cJSON_GetObjectItem(notification->params, "requestId") : NULL;
+    char key_buffer[CALL_KEY_SIZE];
+    const char *call_key = call_key_format(key_buffer, sizeof(key_buffer),
+                                           pthread_getspecific(server->connection_key), request_id);
+    if (!call_key) {
+        mcp_log_debug("Ignoring notifications/cancelled without a valid requestId");
+        return;
+    }
+
+    int found = mcp_tool_registry_cancel_call(server->tool_registry, call_key);
+    if (server->debug) {
+        mcp_log_debug("notifications/cancelled: %d call(s) cancelled", found);
+    }
+}
+
 static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_data) {
     embed_mcp_server_t *server = (embed_mcp_server_t*)user_data;
 
@@ -336,12 +1310,42 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
     }
     
     // Handle tools/list
+    // The array is spliced in from the registry's serialized snapshot. Its entity tag is
+    // returned in _meta.etag; a client that sends it back in _meta.ifNoneMatch gets an
+    // empty list with _meta.notModified instead of the unchanged tools.
     if (strcmp(request->method, "tools/list") == 0) {
-        cJSON *tools = mcp_tool_registry_list_tools(server->tool_registry);
+        cJSON *meta = request->params ? cJSON_GetObjectItem(request->params, "_meta") : NULL;
+        cJSON *if_none_match = meta ? cJSON_GetObjectItem(meta, "ifNoneMatch") : NULL;
+        bool not_modified = cJSON_IsString(if_none_match) &&
+                            mcp_tool_registry_tool_list_matches(server->tool_registry,
+                                                                if_none_match->valuestring);
+
+        uint64_t cursor, next_cursor = 0;
+        if (list_cursor_decode(request->params, 't', &cursor) != 0) {
+            mcp_log_debug("Invalid tools/list cursor");
+            return mcp_protocol_create_error_result(JSONRPC_INVALID_PARAMS, "Invalid params",
+                                                    "details", "Invalid cursor");
+        }
+
+        char etag[MCP_TOOL_LIST_ETAG_SIZE];
+        cJSON *tools;
+        if (not_modified) {
+            memcpy(etag, if_none_match->valuestring, sizeof(etag));
+            tools = cJSON_CreateArray();
+        } else {
+            tools = mcp_tool_registry_list_tools_page(server->tool_registry, cursor, server->list_page_size,
+                                                      &next_cursor, etag);
+        }
         if (!tools) return NULL;
         
         cJSON *result = cJSON_CreateObject();
         cJSON_AddItemToObject(result, "tools", tools);
+        list_cursor_add(result, 't', next_cursor);
+        cJSON *result_meta = cJSON_AddObjectToObject(result, "_meta");
+        cJSON_AddStringToObject(result_meta, "etag", etag);
+        if (not_modified) {
+            cJSON_AddTrueToObject(result_meta, "notModified");
+        }
         return result;
     }
     
@@ -354,7 +1358,7 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
         
         if (!name || !cJSON_IsString(name)) return NULL;
         
-        return mcp_tool_registry_call_tool(server->tool_registry, name->valuestring, arguments);
+        return call_tool(server, request, name->valuestring, arguments);
     }
 
     // Handle resources/list
@@ -363,7 +1367,16 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
             mcp_log_debug("Handling resources/list request");
         }
 
-        cJSON *resources = mcp_resource_registry_list_resources(server->resource_registry);
+        uint64_t cursor;
+        size_t next_cursor = 0;
+        if (list_cursor_decode(request->params, 'r', &cursor) != 0) {
+            mcp_log_debug("Invalid resources/list cursor");
+            return mcp_protocol_create_error_result(JSONRPC_INVALID_PARAMS, "Invalid params",
+                                                    "details", "Invalid cursor");
+        }
+
+        cJSON *resources = mcp_resource_registry_list_resources_page(server->resource_registry, (size_t)cursor,
+                                                                     server->list_page_size, &next_cursor);
         if (!resources) {
             if (server->debug) {
                 mcp_log_debug("mcp_resource_registry_list_resources returned NULL");
@@ -377,6 +1390,7 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
 
         cJSON *result = cJSON_CreateObject();
         cJSON_AddItemToObject(result, "resources", resources);
+        list_cursor_add(result, 'r', next_cursor);
         return result;
     }
 
@@ -433,7 +1447,16 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
             mcp_log_debug("Handling resources/templates/list request");
         }
 
-        cJSON *templates = mcp_resource_registry_list_templates(server->resource_registry);
+        uint64_t cursor;
+        size_t next_cursor = 0;
+        if (list_cursor_decode(request->params, 'p', &cursor) != 0) {
+            mcp_log_debug("Invalid resources/templates/list cursor");
+            return mcp_protocol_create_error_result(JSONRPC_INVALID_PARAMS, "Invalid params",
+                                                    "details", "Invalid cursor");
+        }
+
+        cJSON *templates = mcp_resource_registry_list_templates_page(server->resource_registry, (size_t)cursor,
+                                                                     server->list_page_size, &next_cursor);
         if (!templates) {
             if (server->debug) {
                 mcp_log_debug("mcp_resource_registry_list_templates returned NULL");
@@ -441,16 +1464,273 @@ static cJSON *protocol_request_handler(const mcp_request_t *request, void *user_
             return NULL;
         }
 
-        if (server->debug) {
-            mcp_log_debug("Creating result object for resources/templates/list");
+        if (server->debug) {
+            mcp_log_debug("Creating result object for resources/templates/list");
+        }
+
+        cJSON *result = cJSON_CreateObject();
+        cJSON_AddItemToObject(result, "resourceTemplates", templates);
+        list_cursor_add(result, 'p', next_cursor);
+        return result;
+    }
+
+    return NULL;
+}
+
+// JSON-RPC batches: the requests are split into units of work, run by the calling
+// thread together with helpers from the HTTP worker pool, when there is one
+#define BATCH_GROUPED_UNIT ((size_t)-1)
+
+typedef struct batch_dispatch batch_dispatch_t;
+
+// Pool job helping with a batch. Claimed by the job when it starts, or by the dispatcher
+// once the work has run out, so a job still queued by then does nothing.
+typedef struct {
+    batch_dispatch_t *dispatch;
+    int claimed;
+} batch_helper_t;
+
+// Shared by the dispatching thread and its helpers, freed by the last one out: a
+// retired helper may only run after the batch has been answered
+struct batch_dispatch {
+    embed_mcp_server_t *server;
+    mcp_protocol_t *protocol;
+    mcp_connection_t *connection;
+    const mcp_request_t *requests;
+    mcp_message_t *replies;
+    const size_t *units;            // Request answered by each unit, or BATCH_GROUPED_UNIT
+    size_t unit_count;
+    size_t next_unit;               // Claimed atomically
+    const size_t *grouped;          // Requests of the grouped unit
+    size_t grouped_count;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+    size_t helpers_finished;
+    int ref_count;
+    batch_helper_t helpers[];
+};
+
+// Name of the tool a tools/call request calls, NULL for other requests
+static const char *batch_tool_name(const mcp_request_t *request) {
+    if (strcmp(request->method, "tools/call") != 0 || !request->params) return NULL;
+
+    cJSON *name = cJSON_GetObjectItem(request->params, "name");
+    return cJSON_IsString(name) ? name->valuestring : NULL;
+}
+
+static bool batch_tool_accepts_batches(embed_mcp_server_t *server, const char *name) {
+    mcp_tool_entry_t *entry = mcp_tool_registry_acquire_entry(server->tool_registry, name);
+    if (!entry) return false;
+
+    bool accepts = entry->tool->execute_batch && !mcp_tool_is_async(entry->tool);
+    mcp_tool_registry_release_entry(entry);
+    return accepts;
+}
+
+// Calls of a tool with a batch handler go through the registry together when the tool
+// is called more than once (they cannot be cancelled one by one); every other request
+// is a unit of its own. state holds count bytes of scratch.
+static void batch_plan(embed_mcp_server_t *server, const mcp_request_t *requests, size_t count,
+                       size_t *units, size_t *unit_count, size_t *grouped, size_t *grouped_count,
+                       unsigned char *state) {
+    enum { BATCH_SINGLE, BATCH_CANDIDATE, BATCH_GROUPED };
+
+    for (size_t i = 0; i < count; i++) {
+        const char *name = batch_tool_name(&requests[i]);
+        state[i] = name && batch_tool_accepts_batches(server, name) ? BATCH_CANDIDATE : BATCH_SINGLE;
+    }
+
+    *grouped_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (state[i] != BATCH_CANDIDATE) continue;
+
+        const char *name = batch_tool_name(&requests[i]);
+        size_t first = *grouped_count;
+        for (size_t j = i; j < count; j++) {
+            if (state[j] == BATCH_CANDIDATE && strcmp(batch_tool_name(&requests[j]), name) == 0) {
+                state[j] = BATCH_GROUPED;
+                grouped[(*grouped_count)++] = j;
+            }
+        }
+        if (*grouped_count - first == 1) {
+            state[i] = BATCH_SINGLE;
+            *grouped_count = first;
+        }
+    }
+
+    // The grouped calls go first, as the largest unit
+    *unit_count = 0;
+    if (*grouped_count > 0) {
+        units[(*unit_count)++] = BATCH_GROUPED_UNIT;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (state[i] == BATCH_SINGLE) {
+            units[(*unit_count)++] = i;
+        }
+    }
+}
+
+static void batch_run_grouped(batch_dispatch_t *dispatch) {
+    size_t count = dispatch->grouped_count;
+    const char **names = malloc(count * (sizeof(char*) + 2 * sizeof(cJSON*)));
+    if (!names) {
+        for (size_t k = 0; k < count; k++) {
+            size_t index = dispatch->grouped[k];
+            mcp_protocol_answer_request(dispatch->protocol, &dispatch->requests[index],
+                                        &dispatch->replies[index]);
+        }
+        return;
+    }
+    const cJSON **arguments = (const cJSON**)(names + count);
+    cJSON **results = (cJSON**)(arguments + count);
+
+    for (size_t k = 0; k < count; k++) {
+        const mcp_request_t *request = &dispatch->requests[dispatch->grouped[k]];
+        names[k] = batch_tool_name(request);
+        arguments[k] = cJSON_GetObjectItem(request->params, "arguments");
+    }
+
+    mcp_tool_registry_call_batch(dispatch->server->tool_registry, names, arguments, count, results);
+
+    for (size_t k = 0; k < count; k++) {
+        size_t index = dispatch->grouped[k];
+        mcp_protocol_answer_with_result(dispatch->protocol, &dispatch->requests[index], results[k],
+                                        &dispatch->replies[index]);
+    }
+    free(names);
+}
+
+static void batch_run_units(batch_dispatch_t *dispatch) {
+    for (;;) {
+        size_t unit = MCP_ATOMIC_INC(&dispatch->next_unit) - 1;
+        if (unit >= dispatch->unit_count) break;
+
+        size_t index = dispatch->units[unit];
+        if (index == BATCH_GROUPED_UNIT) {
+            batch_run_grouped(dispatch);
+        } else {
+            mcp_protocol_answer_request(dispatch->protocol, &dispatch->requests[index],
+                                        &dispatch->replies[index]);
+        }
+    }
+}
+
+static void batch_dispatch_unref(batch_dispatch_t *dispatch) {
+    if (MCP_REF_DEC(&dispatch->ref_count) != 0) return;
+
+    pthread_cond_destroy(&dispatch->finished);
+    pthread_mutex_destroy(&dispatch->mutex);
+    free(dispatch);
+}
+
+static void batch_helper_job(void *arg) {
+    batch_helper_t *helper = (batch_helper_t*)arg;
+    batch_dispatch_t *dispatch = helper->dispatch;
+
+    if (MCP_ATOMIC_CLAIM(&helper->claimed) == 0) {
+        // Handlers look up the request's connection on their own thread
+        embed_mcp_server_t *server = dispatch->server;
+        void *outer = pthread_getspecific(server->connection_key);
+        pthread_setspecific(server->connection_key, dispatch->connection);
+        batch_run_units(dispatch);
+        pthread_setspecific(server->connection_key, outer);
+
+        pthread_mutex_lock(&dispatch->mutex);
+        dispatch->helpers_finished++;
+        pthread_cond_signal(&dispatch->finished);
+        pthread_mutex_unlock(&dispatch->mutex);
+    }
+
+    batch_dispatch_unref(dispatch);
+}
+
+static batch_dispatch_t *batch_dispatch_create(size_t helper_count) {
+    batch_dispatch_t *dispatch = calloc(1, sizeof(batch_dispatch_t) + helper_count * sizeof(batch_helper_t));
+    if (!dispatch) return NULL;
+
+    if (pthread_mutex_init(&dispatch->mutex, NULL) != 0) {
+        free(dispatch);
+        return NULL;
+    }
+    if (pthread_cond_init(&dispatch->finished, NULL) != 0) {
+        pthread_mutex_destroy(&dispatch->mutex);
+        free(dispatch);
+        return NULL;
+    }
+    dispatch->ref_count = 1;
+    return dispatch;
+}
+
+static void protocol_batch_handler(mcp_protocol_t *protocol, const mcp_request_t *requests,
+                                   size_t count, mcp_message_t *replies, void *user_data) {
+    embed_mcp_server_t *server = (embed_mcp_server_t*)user_data;
+
+    size_t *units = malloc(count * (2 * sizeof(size_t) + 1));
+    mcp_worker_pool_t *pool = server->transport && server->transport->type == MCP_TRANSPORT_HTTP ?
+                              mcp_http_transport_get_worker_pool(server->transport) : NULL;
+    size_t helper_count = 0;
+    batch_dispatch_t *dispatch = NULL;
+    if (units) {
+        size_t *grouped = units + count;
+        size_t unit_count, grouped_count;
+        batch_plan(server, requests, count, units, &unit_count, grouped, &grouped_count,
+                   (unsigned char*)(grouped + count));
+
+        // The calling thread works too, so one helper less than there are units
+        if (pool && unit_count > 1) {
+            helper_count = mcp_worker_pool_get_thread_count(pool);
+            if (helper_count > unit_count - 1) helper_count = unit_count - 1;
+        }
+        dispatch = batch_dispatch_create(helper_count);
+        if (dispatch) {
+            dispatch->server = server;
+            dispatch->protocol = protocol;
+            dispatch->connection = pthread_getspecific(server->connection_key);
+            dispatch->requests = requests;
+            dispatch->replies = replies;
+            dispatch->units = units;
+            dispatch->unit_count = unit_count;
+            dispatch->grouped = grouped;
+            dispatch->grouped_count = grouped_count;
+        }
+    }
+    if (!dispatch) {
+        for (size_t i = 0; i < count; i++) {
+            mcp_protocol_answer_request(protocol, &requests[i], &replies[i]);
+        }
+        free(units);
+        return;
+    }
+
+    // Helpers only go to idle workers: they never wait in the request queue or take
+    // its room, and a busy pool leaves the batch to the calling thread
+    for (size_t h = 0; h < helper_count; h++) {
+        dispatch->helpers[h].dispatch = dispatch;
+        MCP_REF_INC(&dispatch->ref_count);
+        if (mcp_worker_pool_submit_if_idle(pool, batch_helper_job, &dispatch->helpers[h]) != 0) {
+            MCP_REF_DEC(&dispatch->ref_count);
+            break;
         }
+    }
 
-        cJSON *result = cJSON_CreateObject();
-        cJSON_AddItemToObject(result, "resourceTemplates", templates);
-        return result;
+    batch_run_units(dispatch);
+
+    // Retire the helpers that have not started; wait for those that have
+    size_t started = 0;
+    for (size_t h = 0; h < helper_count; h++) {
+        if (MCP_ATOMIC_CLAIM(&dispatch->helpers[h].claimed) != 0) {
+            started++;
+        }
+    }
+    pthread_mutex_lock(&dispatch->mutex);
+    while (dispatch->helpers_finished < started) {
+        pthread_cond_wait(&dispatch->finished, &dispatch->mutex);
     }
+    pthread_mutex_unlock(&dispatch->mutex);
 
-    return NULL;
+    batch_dispatch_unref(dispatch);
+    free(units);
 }
 
 // Transport callbacks
@@ -462,18 +1742,23 @@ static void on_message_received(const char *message, size_t length,
         mcp_log_debug("Received message (%zu bytes): %.*s", length, (int)length, message);
     }
 
+    // Everything cJSON allocates for this request comes from the thread's arena
+    bool arena = server->request_arena && mcp_arena_request_begin() == 0;
+
+    // Parse once; the protocol layer and tool handlers work on borrowed views of this document
+    cJSON *document = jsonrpc_parse_document(server->protocol->parser, message, length);
+
     // Streamable HTTP: ensure a session id exists after initialize.
-    if (server->enable_sessions && server->session_manager && connection && !connection->session_id) {
-        cJSON *root = cJSON_ParseWithLength(message, length);
+    if (document && server->enable_sessions && server->session_manager && connection && !connection->session_id) {
         const cJSON *obj = NULL;
 
-        if (root && cJSON_IsObject(root)) {
-            obj = root;
-        } else if (root && cJSON_IsArray(root) && cJSON_GetArraySize(root) > 0) {
-            obj = cJSON_GetArrayItem(root, 0);
+        if (cJSON_IsObject(document)) {
+            obj = document;
+        } else if (cJSON_IsArray(document)) {
+            obj = document->child;
         }
 
-        const cJSON *method = obj ? cJSON_GetObjectItem((cJSON*)obj, "method") : NULL;
+        const cJSON *method = obj ? cJSON_GetObjectItem(obj, "method") : NULL;
         if (method && cJSON_IsString(method) && strcmp(method->valuestring, "initialize") == 0) {
             mcp_session_t *session = mcp_session_manager_create_session(server->session_manager, NULL);
             if (session) {
@@ -481,12 +1766,10 @@ static void on_message_received(const char *message, size_t length,
                 mcp_session_unref(session);
             }
         }
-
-        if (root) cJSON_Delete(root);
     }
     
-    server->current_connection = connection;
-    int result = mcp_protocol_handle_message(server->protocol, message);
+    pthread_setspecific(server->connection_key, connection);
+    int result = mcp_protocol_handle_document(server->protocol, document);
     // Keep connection available until after message handling is complete
     // Don't set to NULL immediately as response sending might be synchronous
     if (result < 0) {
@@ -494,7 +1777,19 @@ static void on_message_received(const char *message, size_t length,
     } else if (result > 0) {
         mcp_log_debug("Protocol message handled successfully, sent %d bytes", result);
     }
-    server->current_connection = NULL;
+    pthread_setspecific(server->connection_key, NULL);
+
+    cJSON_Delete(document);
+
+    // The response has been handed to the transport; drop the request's allocations at once
+    if (arena) {
+        mcp_arena_stats_t stats;
+        mcp_arena_request_end(&stats);
+        if (server->debug) {
+            mcp_log_debug("Request arena: %zu allocations (%zu bytes), %zu heap fallbacks",
+                          stats.allocations, stats.bytes_used, stats.heap_fallbacks);
+        }
+    }
 }
 
 static void on_connection_opened(mcp_connection_t *connection, void *user_data) {
@@ -578,6 +1873,25 @@ embed_mcp_server_t *embed_mcp_create(const embed_mcp_config_t *config) {
     server->session_timeout = config->session_timeout > 0 ? config->session_timeout : 3600;
     server->enable_sessions = config->enable_sessions != 0 ? config->enable_sessions : 1;
     server->auto_cleanup = config->auto_cleanup != 0 ? config->auto_cleanup : 1;
+    server->worker_threads = config->worker_threads > 0 ? config->worker_threads : 0;
+    server->event_loops = config->event_loops > 1 ? config->event_loops : 1;
+    server->request_arena = config->request_arena ? 1 : 0;
+    server->list_page_size = config->list_page_size > 0 ? (size_t)config->list_page_size : 0;
+    server->max_message_size = config->max_message_size > 0 ? (size_t)config->max_message_size
+                                                             : 1024 * 1024; // 1MB
+
+    // cJSON hooks are process-wide; install them before any request thread starts
+    if (server->request_arena && mcp_arena_install_cjson_hooks() != 0) {
+        mcp_log_warn("Request arena unavailable, using the heap");
+        server->request_arena = 0;
+    }
+
+    if (pthread_key_create(&server->connection_key, NULL) != 0) {
+        embed_mcp_destroy(server);
+        set_error("Failed to create connection key");
+        return NULL;
+    }
+    server->connection_key_created = 1;
 
     // This check was moved earlier in the function
     
@@ -587,7 +1901,8 @@ embed_mcp_server_t *embed_mcp_create(const embed_mcp_config_t *config) {
     registry_config.enable_builtin_tools = false;
     registry_config.enable_tool_stats = true;
     registry_config.strict_validation = true;
-    registry_config.tool_timeout = 30; // 30 seconds
+    registry_config.tool_timeout = config->tool_timeout > 0 ? config->tool_timeout
+                                 : (config->tool_timeout < 0 ? 0 : 30); // 30 seconds
 
     server->tool_registry = mcp_tool_registry_create(&registry_config);
     if (!server->tool_registry) {
@@ -609,6 +1924,16 @@ embed_mcp_server_t *embed_mcp_create(const embed_mcp_config_t *config) {
         mcp_resource_registry_set_logging(server->resource_registry, 1);
     }
 
+    if (config->tool_stats_resource &&
+        mcp_resource_registry_add_text_function(server->resource_registry, EMBED_MCP_TOOL_STATS_URI,
+                                                "Tool statistics",
+                                                "Call counts and wall-clock latency percentiles per tool",
+                                                "application/json", tool_stats_resource, server) != 0) {
+        embed_mcp_destroy(server);
+        set_error("Failed to register tool statistics resource");
+        return NULL;
+    }
+
     // Create protocol config with user settings
     mcp_protocol_config_t *protocol_config = mcp_protocol_config_create_default();
     if (protocol_config) {
@@ -619,6 +1944,9 @@ embed_mcp_server_t *embed_mcp_create(const embed_mcp_config_t *config) {
         if (config->instructions) {
             mcp_protocol_config_set_instructions(protocol_config, config->instructions);
         }
+
+        // The parser rejects anything the transport would have refused
+        protocol_config->max_message_size = server->max_message_size;
     }
 
     // Create protocol with user config
@@ -635,9 +1963,18 @@ embed_mcp_server_t *embed_mcp_create(const embed_mcp_config_t *config) {
         return NULL;
     }
     
+    server->replies = reply_gate_create(server->protocol->config->pretty_json);
+    if (!server->replies) {
+        embed_mcp_destroy(server);
+        set_error("Failed to create async reply gate");
+        return NULL;
+    }
+
     // Set protocol callbacks
     mcp_protocol_set_send_callback(server->protocol, protocol_send_callback, server);
     mcp_protocol_set_request_handler(server->protocol, protocol_request_handler, server);
+    mcp_protocol_set_notification_handler(server->protocol, protocol_notification_handler, server);
+    mcp_protocol_set_batch_handler(server->protocol, protocol_batch_handler, server);
 
     // Update capabilities based on registered features
     update_dynamic_capabilities(server);
@@ -702,6 +2039,13 @@ void embed_mcp_destroy(embed_mcp_server_t *server) {
         mcp_session_manager_destroy(server->session_manager);
     }
 
+    if (server->connection_key_created) {
+        pthread_key_delete(server->connection_key);
+    }
+
+    // Replies still pending keep the (closed) gate until their tools complete
+    reply_gate_unref(server->replies);
+
     // Use HAL memory deallocation
     hal_free(hal, server->name);
     hal_free(hal, server->version);
@@ -737,9 +2081,35 @@ int embed_mcp_run(embed_mcp_server_t *server, embed_mcp_transport_t transport) {
 
     // Create transport
     if (transport == EMBED_MCP_TRANSPORT_STDIO) {
-        server->transport = mcp_transport_create_stdio();
+        mcp_transport_config_t *stdio_config = mcp_transport_config_create_stdio();
+        if (stdio_config) {
+            stdio_config->max_message_size = server->max_message_size;
+
+            server->transport = mcp_transport_create(MCP_TRANSPORT_STDIO);
+            if (server->transport && mcp_transport_init(server->transport, stdio_config) != 0) {
+                mcp_transport_destroy(server->transport);
+                server->transport = NULL;
+            }
+            mcp_transport_config_destroy(stdio_config);
+        }
     } else {
-        server->transport = mcp_transport_create_http_with_path(server->port, server->host, server->path);
+        mcp_transport_config_t *http_config = mcp_transport_config_create_http(server->port, server->host);
+        if (http_config) {
+            const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+            hal_free(hal, http_config->config.http.endpoint_path);
+            http_config->config.http.endpoint_path = hal_strdup(hal, server->path);
+            http_config->config.http.worker_threads = server->worker_threads;
+            http_config->config.http.event_loops = server->event_loops;
+            http_config->max_message_size = server->max_message_size;
+            http_config->config.http.max_request_size = server->max_message_size;
+
+            server->transport = mcp_transport_create(MCP_TRANSPORT_HTTP);
+            if (server->transport && mcp_transport_init(server->transport, http_config) != 0) {
+                mcp_transport_destroy(server->transport);
+                server->transport = NULL;
+            }
+            mcp_transport_config_destroy(http_config);
+        }
     }
 
     if (!server->transport) {
@@ -765,13 +2135,19 @@ int embed_mcp_run(embed_mcp_server_t *server, embed_mcp_transport_t transport) {
         }
     }
 
-    // Start transport
+    // Start transport - the gate opens first, the STDIO reader handles requests as soon
+    // as it starts and must already be able to defer their replies
+    reply_gate_set_open(server->replies, 1);
     if (mcp_transport_start(server->transport) != 0) {
+        reply_gate_set_open(server->replies, 0);
         set_error("Failed to start transport");
         return -1;
     }
 
     // Setup signal handling
+    if (wakeup_pipe_open() != 0) {
+        mcp_log_warn("Failed to create wakeup pipe, falling back to timed polling");
+    }
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
@@ -788,18 +2164,27 @@ int embed_mcp_run(embed_mcp_server_t *server, embed_mcp_transport_t transport) {
         }
     }
 
-    // Main loop
+    // Main loop - blocks until there is work; embed_mcp_stop(), signals and
+    // worker completions wake it up
     while (g_running && server->running) {
-        // Poll transport for HTTP requests
-        if (server->transport && transport == EMBED_MCP_TRANSPORT_HTTP) {
-            extern int mcp_http_transport_poll(mcp_transport_t *transport);
-            mcp_http_transport_poll(server->transport);
+        if (transport == EMBED_MCP_TRANSPORT_HTTP) {
+            // Network events for HTTP requests
+            mcp_http_transport_poll_wait(server->transport, EMBED_MCP_LOOP_IDLE_MS);
+        } else {
+            // STDIO requests are handled by the reader thread
+            wakeup_pipe_wait(EMBED_MCP_LOOP_IDLE_MS);
         }
+    }
 
-        usleep(10000); // 10ms
+    // Requests already accepted by HTTP workers finish first; with a single event loop
+    // this thread has left its poll loop, so draining keeps polling until their replies
+    // (including deferred ones through the gate) are out
+    if (transport == EMBED_MCP_TRANSPORT_HTTP) {
+        mcp_http_transport_drain(server->transport);
     }
 
-    // Stop transport
+    // Stop transport - async tools completing from now on have nowhere to reply
+    reply_gate_set_open(server->replies, 0);
     mcp_transport_stop(server->transport);
 
     // Stop session manager if enabled
@@ -807,6 +2192,8 @@ int embed_mcp_run(embed_mcp_server_t *server, embed_mcp_transport_t transport) {
         mcp_session_manager_stop(server->session_manager);
     }
 
+    wakeup_pipe_close();
+
     if (server->debug) {
         mcp_log_info("Server stopped");
     }
@@ -817,6 +2204,7 @@ int embed_mcp_run(embed_mcp_server_t *server, embed_mcp_transport_t transport) {
 void embed_mcp_stop(embed_mcp_server_t *server) {
     if (server) {
         server->running = 0;
+        wake_main_loop();
     }
 }
 
@@ -843,6 +2231,16 @@ int embed_mcp_quick_start(const char *name, const char *version,
     return result;
 }
 
+// Element layout advertised for packed parameters
+static const char *packed_type_name(mcp_packed_type_t type) {
+    switch (type) {
+        case MCP_PACKED_INT32: return "int32le";
+        case MCP_PACKED_INT64: return "int64le";
+        case MCP_PACKED_FLOAT: return "float32le";
+        default: return "float64le";
+    }
+}
+
 // Helper function to create JSON Schema from parameter descriptions
 static cJSON *create_schema_from_params(mcp_param_desc_t *params, size_t param_count) {
     cJSON *schema = cJSON_CreateObject();
@@ -919,6 +2317,13 @@ static cJSON *create_schema_from_params(mcp_param_desc_t *params, size_t param_c
                     cJSON_AddStringToObject(param_schema, "type", "object");
                 }
                 break;
+
+            case MCP_PARAM_PACKED:
+                cJSON_AddStringToObject(param_schema, "type", "string");
+                cJSON_AddStringToObject(param_schema, "contentEncoding", "base64");
+                cJSON_AddStringToObject(param_schema, "contentMediaType", "application/octet-stream");
+                cJSON_AddStringToObject(param_schema, "x-packed", packed_type_name(params[i].packed_type));
+                break;
         }
 
         cJSON_AddItemToObject(properties, params[i].name, param_schema);
@@ -955,22 +2360,60 @@ const char *embed_mcp_get_error(void) {
     return g_error_message[0] ? g_error_message : "No error";
 }
 
-// Note: custom_func_data_t removed - replaced by universal wrapper system
+cJSON *embed_mcp_get_network_stats(embed_mcp_server_t *server) {
+    if (!server || !server->transport || server->transport->type != MCP_TRANSPORT_HTTP) {
+        return NULL;
+    }
 
-// Universal function wrapper data
-typedef struct {
-    mcp_universal_func_t wrapper_func;
-    const char** param_names;
-    mcp_param_type_t* param_types;
-    size_t param_count;
-    mcp_return_type_t return_type;
-    void* user_data;
-} universal_func_data_t;
+    mcp_hal_shard_stats_t stats[16];
+    int count = mcp_http_transport_get_shard_stats(server->transport, stats,
+                                                   (int)(sizeof(stats) / sizeof(stats[0])));
+    if (count < 0) {
+        return NULL;
+    }
+
+    cJSON *result = cJSON_CreateObject();
+    if (!result) return NULL;
+
+    cJSON_AddNumberToObject(result, "event_loops", count);
+    cJSON *shards = cJSON_AddArrayToObject(result, "shards");
+    for (int i = 0; i < count; i++) {
+        cJSON *shard = cJSON_CreateObject();
+        if (!shard) break;
+        cJSON_AddNumberToObject(shard, "shard", stats[i].shard);
+        cJSON_AddNumberToObject(shard, "cpu", stats[i].cpu);
+        cJSON_AddNumberToObject(shard, "connections_accepted", (double)stats[i].connections_accepted);
+        cJSON_AddNumberToObject(shard, "connections_active", (double)stats[i].connections_active);
+        cJSON_AddNumberToObject(shard, "requests", (double)stats[i].requests);
+        cJSON_AddNumberToObject(shard, "responses_sent", (double)stats[i].responses_sent);
+        cJSON_AddNumberToObject(shard, "bytes_sent", (double)stats[i].bytes_sent);
+        cJSON_AddNumberToObject(shard, "wakeups", (double)stats[i].wakeups);
+        cJSON_AddItemToArray(shards, shard);
+    }
+
+    return result;
+}
+
+// Note: custom_func_data_t removed - replaced by universal wrapper system
 
 typedef struct {
     embed_mcp_tool_handler_t handler;
+    bool structured_only;
 } schema_handler_data_t;
 
+typedef struct {
+    embed_mcp_async_tool_handler_t handler;
+    void *user_data;
+    bool structured_only;
+} async_handler_data_t;
+
+// Handed to async handlers; wraps the tool layer's completion with the result format
+struct embed_mcp_completion {
+    mcp_tool_completion_t *completion;
+    bool structured_only;
+    pending_reply_t *reply;             // Referenced for progress; NULL if not deferred
+};
+
 typedef enum {
     TOOL_PARAM_MODE_TRADITIONAL,
     TOOL_PARAM_MODE_ADVANCED
@@ -992,9 +2435,8 @@ static bool is_mcp_result(const cJSON *result) {
     return cJSON_IsArray(content) && cJSON_IsBool(is_error);
 }
 
-static cJSON* wrap_success_payload(cJSON *payload) {
-    cJSON *mcp_result = mcp_tool_create_success_result(payload);
-    cJSON_Delete(payload);
+static cJSON* wrap_success_payload(cJSON *payload, bool structured_only) {
+    cJSON *mcp_result = mcp_tool_create_structured_result(payload, !structured_only);
     if (!mcp_result) {
         return mcp_tool_create_memory_error();
     }
@@ -1026,7 +2468,9 @@ static cJSON* convert_universal_result_to_json(void *result, mcp_return_type_t r
         case MCP_RETURN_STRING:
             if (result) {
                 result_data = cJSON_CreateString((char*)result);
-                free(result);
+                // The *_ARRAY_RETURN helpers hand back cJSON_Print output, which may live in
+                // the request arena; cJSON_free() also releases plain malloc'd strings
+                cJSON_free(result);
             } else {
                 result_data = cJSON_CreateString("");
             }
@@ -1050,24 +2494,81 @@ static cJSON* convert_universal_result_to_json(void *result, mcp_return_type_t r
     return result_data;
 }
 
+// Same for a result written into a value: nothing was boxed, only a string is released
+static cJSON* convert_universal_value_to_json(mcp_param_value_t *value, mcp_return_type_t return_type) {
+    double number;
+    switch (value->type) {
+        case MCP_PARAM_INT:
+            number = (double)value->int_val;
+            break;
+        case MCP_PARAM_BOOL:
+            number = value->bool_val;
+            break;
+        default:
+            number = value->double_val;
+            break;
+    }
+
+    switch (return_type) {
+        case MCP_RETURN_INT:
+        case MCP_RETURN_DOUBLE:
+            return cJSON_CreateNumber(number);
+
+        case MCP_RETURN_STRING:
+            if (value->type == MCP_PARAM_STRING && value->string_val) {
+                cJSON *result_data = cJSON_CreateString(value->string_val);
+                cJSON_free(value->string_val);
+                return result_data;
+            }
+            return cJSON_CreateString("");
+
+        case MCP_RETURN_VOID:
+            return cJSON_CreateString("Operation completed");
+
+        default:
+            return cJSON_CreateString("Unknown result type");
+    }
+}
+
+// Initial type of a result written into a value
+static mcp_param_type_t universal_value_type(mcp_return_type_t return_type) {
+    return return_type == MCP_RETURN_INT ? MCP_PARAM_INT :
+           return_type == MCP_RETURN_STRING ? MCP_PARAM_STRING : MCP_PARAM_DOUBLE;
+}
+
 // Note: custom_function_wrapper removed - replaced by universal wrapper system
 
 // Universal function wrapper that calls user-provided wrapper function
 static cJSON* universal_function_wrapper(const cJSON *args, void *user_data) {
     universal_func_data_t* data = (universal_func_data_t*)user_data;
-    if (!data || !data->wrapper_func) {
+    if (!data || (!data->wrapper_func && !data->value_func)) {
         return mcp_tool_create_error_result(MCP_TOOL_ERROR_INTERNAL,
                                             "Universal handler is not initialized",
                                             NULL);
     }
 
+    // Decode the arguments into slots, on the stack for the usual few parameters
+    param_slot_t local_slots[UNIVERSAL_LOCAL_SLOTS];
+    param_slot_t* slots = local_slots;
+    if (data->param_count > UNIVERSAL_LOCAL_SLOTS) {
+        slots = malloc(data->param_count * sizeof(param_slot_t));
+        if (!slots) {
+            return mcp_tool_create_memory_error();
+        }
+    }
+    param_slots_decode(data, args, slots);
+
     // Create parameter accessor
-    param_accessor_data_t accessor_data = { .args = args };
+    param_accessor_data_t accessor_data = { .args = args, .func = data, .slots = slots };
     mcp_param_accessor_t accessor = {
         .get_int = param_get_int,
         .get_double = param_get_double,
         .get_string = param_get_string,
         .get_bool = param_get_bool,
+        .get_int_at = param_get_int_at,
+        .get_double_at = param_get_double_at,
+        .get_string_at = param_get_string_at,
+        .get_bool_at = param_get_bool_at,
         .try_get_int = param_try_get_int,
         .try_get_double = param_try_get_double,
         .try_get_string = param_try_get_string,
@@ -1078,21 +2579,143 @@ static cJSON* universal_function_wrapper(const cJSON *args, void *user_data) {
         .get_double_array = param_get_double_array,
         .get_string_array = param_get_string_array,
         .get_int_array = param_get_int_array,
+        .get_double_array_view = param_get_double_array_view,
+        .get_int_array_view = param_get_int_array_view,
+        .get_string_array_view = param_get_string_array_view,
+        .copy_double_array = param_copy_double_array,
+        .copy_int_array = param_copy_int_array,
         .has_param = param_has_param,
         .get_param_count = param_get_param_count,
         .get_json = param_get_json,
+        .is_cancelled = param_is_cancelled,
+        .report_progress = param_report_progress,
         .data = &accessor_data
     };
 
     // Call the user's wrapper function with the parameter accessor
-    void* result = data->wrapper_func(&accessor, data->user_data);
+    cJSON *result_data;
+    if (data->value_func) {
+        // Scalar results come back in place, without a heap box
+        mcp_param_value_t value;
+        memset(&value, 0, sizeof(value));
+        value.type = universal_value_type(data->return_type);
+        data->value_func(&accessor, data->user_data, &value);
+        param_scratch_release(&accessor_data);
+        result_data = convert_universal_value_to_json(&value, data->return_type);
+    } else {
+        void* result = data->wrapper_func(&accessor, data->user_data);
+        param_scratch_release(&accessor_data);
+        result_data = convert_universal_result_to_json(result, data->return_type);
+    }
+    if (slots != local_slots) {
+        free(slots);
+    }
 
-    cJSON *result_data = convert_universal_result_to_json(result, data->return_type);
     if (!result_data) {
         return mcp_tool_create_memory_error();
     }
 
-    return wrap_success_payload(result_data);
+    return wrap_success_payload(result_data, data->structured_only);
+}
+
+// Cell of a batch column: wide enough for any column type
+typedef union {
+    int64_t int_val;
+    double double_val;
+    const char* string_val;
+    int bool_val;
+} batch_cell_t;
+
+// Decode each argument object into the columns, run the batch function once over all
+// rows, and convert every row's result
+static void universal_batch_run(const universal_func_data_t* data, const cJSON* const* args,
+                                size_t count, cJSON** results) {
+    size_t column_count = data->param_count;
+    size_t size = count * sizeof(mcp_param_value_t) +
+                  column_count * (sizeof(mcp_batch_column_t) + sizeof(param_slot_t)) +
+                  column_count * count * (sizeof(batch_cell_t) + 1);
+    unsigned char* block = malloc(size);
+    if (!block) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = mcp_tool_create_memory_error();
+        }
+        return;
+    }
+    mcp_param_value_t* values = (mcp_param_value_t*)block;
+    mcp_batch_column_t* columns = (mcp_batch_column_t*)(values + count);
+    param_slot_t* slots = (param_slot_t*)(columns + column_count);
+    batch_cell_t* cells = (batch_cell_t*)(slots + column_count);
+    unsigned char* present = (unsigned char*)(cells + column_count * count);
+
+    for (size_t j = 0; j < column_count; j++) {
+        columns[j].name = data->param_names[j];
+        columns[j].type = data->param_types[j];
+        columns[j].int_values = (const int64_t*)(cells + j * count);
+        columns[j].present = present + j * count;
+    }
+
+    // Rows are decoded one argument object at a time, through the same slots as a call
+    for (size_t i = 0; i < count; i++) {
+        param_slots_decode(data, args[i], slots);
+        for (size_t j = 0; j < column_count; j++) {
+            void* column = cells + j * count;
+            present[j * count + i] = slots[j].decoded;
+            switch (data->param_types[j]) {
+                case MCP_PARAM_INT:
+                    ((int64_t*)column)[i] = slots[j].value.int_val;
+                    break;
+                case MCP_PARAM_DOUBLE:
+                    ((double*)column)[i] = slots[j].value.double_val;
+                    break;
+                case MCP_PARAM_STRING:
+                    ((const char**)column)[i] = slots[j].value.string_val;
+                    break;
+                case MCP_PARAM_BOOL:
+                    ((int*)column)[i] = slots[j].value.bool_val;
+                    break;
+            }
+        }
+
+        memset(&values[i], 0, sizeof(mcp_param_value_t));
+        values[i].type = universal_value_type(data->return_type);
+    }
+
+    mcp_batch_t batch = {
+        .count = count,
+        .column_count = column_count,
+        .columns = columns,
+        .results = values
+    };
+    data->batch_func(&batch, data->user_data);
+
+    for (size_t i = 0; i < count; i++) {
+        cJSON* result_data = convert_universal_value_to_json(&values[i], data->return_type);
+        results[i] = result_data ? wrap_success_payload(result_data, data->structured_only) :
+                                   mcp_tool_create_memory_error();
+    }
+    free(block);
+}
+
+// A lone call is a batch of one row
+static cJSON* universal_batch_wrapper(const cJSON *args, void *user_data) {
+    universal_func_data_t* data = (universal_func_data_t*)user_data;
+    if (!data || !data->batch_func) {
+        return mcp_tool_create_error_result(MCP_TOOL_ERROR_INTERNAL,
+                                            "Batch handler is not initialized",
+                                            NULL);
+    }
+
+    cJSON* result = NULL;
+    universal_batch_run(data, &args, 1, &result);
+    return result;
+}
+
+static void universal_batch_execute(const cJSON *const *parameters, size_t count,
+                                    cJSON **results, void *user_data) {
+    universal_func_data_t* data = (universal_func_data_t*)user_data;
+    if (data && data->batch_func) {
+        universal_batch_run(data, parameters, count, results);
+    }
 }
 
 static void universal_function_cleanup(void *user_data) {
@@ -1112,6 +2735,10 @@ static void universal_function_cleanup(void *user_data) {
         free(data->param_types);
     }
 
+    free(data->param_categories);
+    free(data->packed_types);
+    free(data->param_hashes);
+    free(data->name_index);
     free(data);
 }
 
@@ -1138,7 +2765,44 @@ static cJSON* schema_handler_wrapper(const cJSON *args, void *user_data) {
         return handler_result;
     }
 
-    return wrap_success_payload(handler_result);
+    return wrap_success_payload(handler_result, data->structured_only);
+}
+
+static void async_handler_cleanup(void *user_data) {
+    free(user_data);
+}
+
+static void async_handler_wrapper(const cJSON *args, mcp_tool_completion_t *completion,
+                                  void *user_data) {
+    async_handler_data_t *data = (async_handler_data_t*)user_data;
+    embed_mcp_completion_t *handle = malloc(sizeof(embed_mcp_completion_t));
+    if (!handle) {
+        mcp_tool_complete(completion, mcp_tool_create_memory_error());
+        return;
+    }
+    handle->completion = completion;
+    handle->structured_only = data->structured_only;
+
+    // The handler runs inside call_tool(), which holds the reply for it
+    tool_call_scope_t *scope = call_scope_current();
+    handle->reply = scope ? scope->reply : NULL;
+    if (handle->reply) {
+        MCP_REF_INC(&handle->reply->ref_count);
+    }
+
+    data->handler(args, handle, data->user_data);
+}
+
+static int register_created_tool(embed_mcp_server_t *server, mcp_tool_t *tool,
+                                 const char *register_error) {
+    if (mcp_tool_registry_register_tool(server->tool_registry, tool) != 0) {
+        mcp_tool_destroy(tool);
+        set_error(register_error ? register_error : "Failed to register tool");
+        return -1;
+    }
+
+    update_dynamic_capabilities(server);
+    return 0;
 }
 
 static int register_tool_internal(embed_mcp_server_t *server,
@@ -1172,14 +2836,7 @@ static int register_tool_internal(embed_mcp_server_t *server,
         return -1;
     }
 
-    if (mcp_tool_registry_register_tool(server->tool_registry, tool) != 0) {
-        mcp_tool_destroy(tool);
-        set_error(register_error ? register_error : "Failed to register tool");
-        return -1;
-    }
-
-    update_dynamic_capabilities(server);
-    return 0;
+    return register_created_tool(server, tool, register_error);
 }
 
 static int fail_with_error(const char *message) {
@@ -1203,6 +2860,7 @@ static universal_func_data_t* create_universal_func_data(const char **traditiona
                                                          bool advanced_mode,
                                                          mcp_return_type_t return_type,
                                                          mcp_universal_func_t wrapper_func,
+                                                         mcp_universal_value_func_t value_func,
                                                          void *user_data) {
     universal_func_data_t *func_data = malloc(sizeof(universal_func_data_t));
     if (!func_data) {
@@ -1210,21 +2868,44 @@ static universal_func_data_t* create_universal_func_data(const char **traditiona
     }
 
     func_data->wrapper_func = wrapper_func;
+    func_data->value_func = value_func;
+    func_data->batch_func = NULL;
     func_data->param_count = param_count;
     func_data->return_type = return_type;
     func_data->user_data = user_data;
+    func_data->structured_only = false;
     func_data->param_names = NULL;
     func_data->param_types = NULL;
+    func_data->param_categories = NULL;
+    func_data->packed_types = NULL;
+    func_data->param_hashes = NULL;
+    func_data->name_index = NULL;
+    func_data->name_index_mask = 0;
 
     if (param_count == 0) {
         return func_data;
     }
 
-    func_data->param_names = malloc(param_count * sizeof(char*));
+    // Name index at most half full
+    size_t index_size = 4;
+    while (index_size < param_count * 2) {
+        index_size *= 2;
+    }
+
+    func_data->param_names = calloc(param_count, sizeof(char*));
     func_data->param_types = malloc(param_count * sizeof(mcp_param_type_t));
-    if (!func_data->param_names || !func_data->param_types) {
+    func_data->param_categories = malloc(param_count * sizeof(mcp_param_category_t));
+    func_data->packed_types = calloc(param_count, sizeof(mcp_packed_type_t));
+    func_data->param_hashes = malloc(param_count * sizeof(uint32_t));
+    func_data->name_index = malloc(index_size * sizeof(int));
+    if (!func_data->param_names || !func_data->param_types || !func_data->param_categories ||
+        !func_data->packed_types || !func_data->param_hashes || !func_data->name_index) {
         return fail_universal_data(func_data, "Memory allocation failed");
     }
+    func_data->name_index_mask = index_size - 1;
+    for (size_t i = 0; i < index_size; i++) {
+        func_data->name_index[i] = -1;
+    }
 
     for (size_t i = 0; i < param_count; i++) {
         const char *name = advanced_mode ? advanced_params[i].name : traditional_names[i];
@@ -1233,11 +2914,27 @@ static universal_func_data_t* create_universal_func_data(const char **traditiona
             return fail_universal_data(func_data, "Memory allocation failed");
         }
 
+        // A repeated name keeps the first position
+        func_data->param_hashes[i] = param_name_hash(name);
+        if (universal_param_index(func_data, name) < 0) {
+            size_t bucket = func_data->param_hashes[i] & func_data->name_index_mask;
+            while (func_data->name_index[bucket] >= 0) {
+                bucket = (bucket + 1) & func_data->name_index_mask;
+            }
+            func_data->name_index[bucket] = (int)i;
+        }
+
+        func_data->param_categories[i] = advanced_mode ? advanced_params[i].category : MCP_PARAM_SINGLE;
         if (advanced_mode) {
             if (advanced_params[i].category == MCP_PARAM_SINGLE) {
                 func_data->param_types[i] = advanced_params[i].single_type;
             } else if (advanced_params[i].category == MCP_PARAM_ARRAY) {
                 func_data->param_types[i] = advanced_params[i].array_desc.element_type;
+            } else if (advanced_params[i].category == MCP_PARAM_PACKED) {
+                mcp_packed_type_t packed_type = advanced_params[i].packed_type;
+                func_data->packed_types[i] = packed_type;
+                func_data->param_types[i] = (packed_type == MCP_PACKED_INT32 || packed_type == MCP_PACKED_INT64) ?
+                                            MCP_PARAM_INT : MCP_PARAM_DOUBLE;
             } else {
                 func_data->param_types[i] = MCP_PARAM_STRING;
             }
@@ -1498,21 +3195,24 @@ size_t embed_mcp_get_resource_template_count(embed_mcp_server_t *server) {
     return mcp_resource_registry_template_count(server->resource_registry);
 }
 
-int embed_mcp_add_tool(embed_mcp_server_t *server,
-                       const char *name,
-                       const char *description,
-                       const void *param_names,
-                       const char *param_descriptions[],
-                       mcp_param_type_t param_types[],
-                       size_t param_count,
-                       mcp_return_type_t return_type,
-                       mcp_universal_func_t wrapper_func,
-                       void *user_data) {
+// Exactly one of wrapper_func, value_func and batch_func is set
+static int add_universal_tool(embed_mcp_server_t *server,
+                              const char *name,
+                              const char *description,
+                              const void *param_names,
+                              const char *param_descriptions[],
+                              mcp_param_type_t param_types[],
+                              size_t param_count,
+                              mcp_return_type_t return_type,
+                              mcp_universal_func_t wrapper_func,
+                              mcp_universal_value_func_t value_func,
+                              mcp_batch_func_t batch_func,
+                              void *user_data) {
     if (!server || !server->tool_registry) {
         return fail_with_error("Invalid server or tool registry not initialized");
     }
 
-    if (!name || !description || !wrapper_func) {
+    if (!name || !description || (!wrapper_func && !value_func && !batch_func)) {
         return fail_with_error("Invalid parameters: name, description, and wrapper_func are required");
     }
 
@@ -1534,11 +3234,23 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
                                                                    advanced_mode,
                                                                    return_type,
                                                                    wrapper_func,
+                                                                   value_func,
                                                                    user_data);
     if (!func_data) {
         return -1;
     }
 
+    // Batch rows are laid out in columns of scalars
+    if (batch_func) {
+        func_data->batch_func = batch_func;
+        for (size_t i = 0; i < param_count; i++) {
+            if (func_data->param_categories[i] != MCP_PARAM_SINGLE) {
+                universal_function_cleanup(func_data);
+                return fail_with_error("Batch tools only take scalar parameters");
+            }
+        }
+    }
+
     cJSON *input_schema = create_input_schema_for_registration(strategy.advanced_params,
                                                                 param_descriptions,
                                                                 param_types,
@@ -1550,6 +3262,18 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
         return -1;
     }
 
+    if (batch_func) {
+        mcp_tool_t *tool = mcp_tool_create_full(name, name, description, input_schema, NULL,
+                                                universal_batch_wrapper, NULL,
+                                                universal_function_cleanup, func_data);
+        if (!tool) {
+            universal_function_cleanup(func_data);
+            return fail_with_error("Failed to create batch tool");
+        }
+        mcp_tool_set_batch_handler(tool, universal_batch_execute);
+        return register_created_tool(server, tool, "Failed to register batch tool");
+    }
+
     return register_tool_internal(server,
                                   name,
                                   description,
@@ -1561,6 +3285,82 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
                                   "Failed to register tool");
 }
 
+int embed_mcp_add_tool(embed_mcp_server_t *server,
+                       const char *name,
+                       const char *description,
+                       const void *param_names,
+                       const char *param_descriptions[],
+                       mcp_param_type_t param_types[],
+                       size_t param_count,
+                       mcp_return_type_t return_type,
+                       mcp_universal_func_t wrapper_func,
+                       void *user_data) {
+    return add_universal_tool(server, name, description, param_names, param_descriptions,
+                              param_types, param_count, return_type, wrapper_func, NULL, NULL, user_data);
+}
+
+int embed_mcp_add_value_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const void *param_names,
+                             const char *param_descriptions[],
+                             mcp_param_type_t param_types[],
+                             size_t param_count,
+                             mcp_return_type_t return_type,
+                             mcp_universal_value_func_t value_func,
+                             void *user_data) {
+    if (!value_func) {
+        return fail_with_error("Invalid parameters: name, description, and value_func are required");
+    }
+    return add_universal_tool(server, name, description, param_names, param_descriptions,
+                              param_types, param_count, return_type, NULL, value_func, NULL, user_data);
+}
+
+int embed_mcp_add_batch_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const void *param_names,
+                             const char *param_descriptions[],
+                             mcp_param_type_t param_types[],
+                             size_t param_count,
+                             mcp_return_type_t return_type,
+                             mcp_batch_func_t batch_func,
+                             void *user_data) {
+    if (!batch_func) {
+        return fail_with_error("Invalid parameters: name, description, and batch_func are required");
+    }
+    return add_universal_tool(server, name, description, param_names, param_descriptions,
+                              param_types, param_count, return_type, NULL, NULL, batch_func, user_data);
+}
+
+int embed_mcp_set_tool_structured_only(embed_mcp_server_t *server,
+                                      const char *name,
+                                      int structured_only) {
+    if (!server || !server->tool_registry || !name) {
+        return fail_with_error("Invalid parameters: server and name are required");
+    }
+
+    mcp_tool_t *tool = mcp_tool_registry_find_tool(server->tool_registry, name);
+    if (!tool) {
+        return fail_with_error("Tool not found");
+    }
+
+    // Only tools registered through this API build their results here
+    int result = 0;
+    if (tool->execute == universal_function_wrapper || tool->execute == universal_batch_wrapper) {
+        ((universal_func_data_t*)tool->user_data)->structured_only = structured_only != 0;
+    } else if (tool->execute == schema_handler_wrapper) {
+        ((schema_handler_data_t*)tool->user_data)->structured_only = structured_only != 0;
+    } else if (tool->execute_async == async_handler_wrapper) {
+        ((async_handler_data_t*)tool->user_data)->structured_only = structured_only != 0;
+    } else {
+        result = fail_with_error("Tool does not use a built-in result wrapper");
+    }
+
+    mcp_tool_unref(tool);
+    return result;
+}
+
 int embed_mcp_add_tool_with_schema(embed_mcp_server_t *server,
                                    const char *name,
                                    const char *description,
@@ -1575,6 +3375,7 @@ int embed_mcp_add_tool_with_schema(embed_mcp_server_t *server,
         return fail_with_error("Memory allocation failed");
     }
     handler_data->handler = handler;
+    handler_data->structured_only = false;
 
     return register_tool_internal(server,
                                   name,
@@ -1586,3 +3387,104 @@ int embed_mcp_add_tool_with_schema(embed_mcp_server_t *server,
                                   "Failed to create tool with schema",
                                   "Failed to register schema tool");
 }
+
+int embed_mcp_add_async_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const cJSON *schema,
+                             embed_mcp_async_tool_handler_t handler,
+                             void *user_data) {
+    if (!name || !description || !handler) {
+        return fail_with_error("Invalid parameters: name, description, and handler are required");
+    }
+    if (!server || !server->tool_registry) {
+        return fail_with_error("Invalid server or tool registry not initialized");
+    }
+
+    async_handler_data_t *handler_data = malloc(sizeof(async_handler_data_t));
+    if (!handler_data) {
+        return fail_with_error("Memory allocation failed");
+    }
+    handler_data->handler = handler;
+    handler_data->user_data = user_data;
+    handler_data->structured_only = false;
+
+    mcp_tool_t *tool = mcp_tool_create_async(name, name, description, schema,
+                                             async_handler_wrapper, handler_data);
+    if (!tool) {
+        free(handler_data);
+        return fail_with_error("Failed to create async tool");
+    }
+    tool->cleanup = async_handler_cleanup;
+
+    return register_created_tool(server, tool, "Failed to register async tool");
+}
+
+int embed_mcp_complete_tool(embed_mcp_completion_t *completion, cJSON *result) {
+    if (!completion) return -1;
+
+    mcp_tool_completion_t *inner = completion->completion;
+    pending_reply_t *reply = completion->reply;
+    if (result && !is_mcp_result(result)) {
+        result = wrap_success_payload(result, completion->structured_only);
+    }
+    free(completion);
+
+    int status = mcp_tool_complete(inner, result);
+    pending_reply_unref(reply);
+    return status;
+}
+
+int embed_mcp_completion_report_progress(embed_mcp_completion_t *completion,
+                                         double progress, double total, const char *message) {
+    return completion ? pending_reply_progress(completion->reply, progress, total, message) : -1;
+}
+
+int embed_mcp_completion_cancelled(const embed_mcp_completion_t *completion) {
+    return completion && mcp_tool_completion_cancelled(completion->completion) ? 1 : 0;
+}
+
+int embed_mcp_tool_cancelled(void) {
+    return mcp_tool_cancel_requested() ? 1 : 0;
+}
+
+int embed_mcp_report_progress(double progress, double total, const char *message) {
+    tool_call_scope_t *scope = call_scope_current();
+    if (!scope) return -1;
+
+    // A deferred reply may already be answered (deadline), which ends its progress
+    if (scope->reply) {
+        return pending_reply_progress(scope->reply, progress, total, message);
+    }
+    return send_progress(scope->connection, scope->progress_token, scope->pretty_json,
+                         progress, total, message);
+}
+
+int embed_mcp_set_tool_timeout(embed_mcp_server_t *server, const char *name, int timeout_ms) {
+    if (!server || !server->tool_registry || !name || timeout_ms < 0) {
+        return fail_with_error("Invalid parameters: server, name and a non-negative timeout are required");
+    }
+
+    mcp_tool_t *tool = mcp_tool_registry_find_tool(server->tool_registry, name);
+    if (!tool) {
+        return fail_with_error("Tool not found");
+    }
+
+    // Read by calls on other threads when they start
+    MCP_ATOMIC_STORE(&tool->max_execution_time_ms, (size_t)timeout_ms);
+
+    mcp_tool_unref(tool);
+    return 0;
+}
+
+int embed_mcp_set_tool_cache(embed_mcp_server_t *server, const char *name,
+                             size_t max_bytes, int ttl_ms) {
+    if (!server || !server->tool_registry || !name || ttl_ms < 0) {
+        return fail_with_error("Invalid parameters: server, name and a non-negative TTL are required");
+    }
+
+    if (mcp_tool_registry_set_cache(server->tool_registry, name, max_bytes, (uint32_t)ttl_ms) != 0) {
+        return fail_with_error("Failed to set tool cache (unknown or async tool)");
+    }
+    return 0;
+}
@@ -28,6 +28,17 @@ typedef struct embed_mcp_server embed_mcp_server_t;
 // Returns: JSON object with tool result (caller must free)
 typedef cJSON* (*embed_mcp_tool_handler_t)(const cJSON *args);
 
+// Pending result of an async tool call, finished with embed_mcp_complete_tool()
+typedef struct embed_mcp_completion embed_mcp_completion_t;
+
+// Async tool handler function type
+// Parameters: args (JSON object with tool arguments, valid until the call completes),
+//             completion (pass to embed_mcp_complete_tool exactly once, from any thread),
+//             user_data (as given to embed_mcp_add_async_tool)
+typedef void (*embed_mcp_async_tool_handler_t)(const cJSON *args,
+                                               embed_mcp_completion_t *completion,
+                                               void *user_data);
+
 // Parameter types
 typedef enum {
     MCP_PARAM_INT,
@@ -71,6 +82,12 @@ struct mcp_param_accessor {
     const char* (*get_string)(mcp_param_accessor_t* self, const char* name);
     int (*get_bool)(mcp_param_accessor_t* self, const char* name);
 
+    // Getters by registration position (0 = first registered parameter): no name lookup
+    int64_t (*get_int_at)(mcp_param_accessor_t* self, size_t index);
+    double (*get_double_at)(mcp_param_accessor_t* self, size_t index);
+    const char* (*get_string_at)(mcp_param_accessor_t* self, size_t index);
+    int (*get_bool_at)(mcp_param_accessor_t* self, size_t index);
+
     // Strict getters with explicit success/failure
     int (*try_get_int)(mcp_param_accessor_t* self, const char* name, int64_t* out);
     int (*try_get_double)(mcp_param_accessor_t* self, const char* name, double* out);
@@ -85,6 +102,17 @@ struct mcp_param_accessor {
     char** (*get_string_array)(mcp_param_accessor_t* self, const char* name, size_t* count);
     int64_t* (*get_int_array)(mcp_param_accessor_t* self, const char* name, size_t* count);
 
+    // Borrowed array views: nothing to free, valid until the tool function returns.
+    // Strings point into the parsed arguments; non-string elements read as "".
+    const double* (*get_double_array_view)(mcp_param_accessor_t* self, const char* name, size_t* count);
+    const int64_t* (*get_int_array_view)(mcp_param_accessor_t* self, const char* name, size_t* count);
+    const char** (*get_string_array_view)(mcp_param_accessor_t* self, const char* name, size_t* count);
+
+    // Decode into a caller buffer, at most capacity elements; returns the array's size
+    // (0 if missing), so a larger result means the buffer was too small
+    size_t (*copy_double_array)(mcp_param_accessor_t* self, const char* name, double* out, size_t capacity);
+    size_t (*copy_int_array)(mcp_param_accessor_t* self, const char* name, int64_t* out, size_t capacity);
+
     // Utility functions
     int (*has_param)(mcp_param_accessor_t* self, const char* name);
     size_t (*get_param_count)(mcp_param_accessor_t* self);
@@ -92,6 +120,10 @@ struct mcp_param_accessor {
     // For rare complex cases: direct JSON access
     const cJSON* (*get_json)(mcp_param_accessor_t* self, const char* name);
 
+    // Long-running calls: embed_mcp_tool_cancelled() and embed_mcp_report_progress()
+    int (*is_cancelled)(mcp_param_accessor_t* self);
+    int (*report_progress)(mcp_param_accessor_t* self, double progress, double total, const char* message);
+
     // Internal data
     void* data;
 };
@@ -99,6 +131,40 @@ struct mcp_param_accessor {
 // Universal function signature - all pure functions use this
 typedef void* (*mcp_universal_func_t)(mcp_param_accessor_t* params, void* user_data);
 
+// Same, writing the result into *result instead of returning it boxed on the heap.
+// result->type starts as the registered return type (MCP_PARAM_INT, MCP_PARAM_DOUBLE
+// or MCP_PARAM_STRING) and may be changed to any scalar type; a string_val result is
+// heap-allocated and released by the framework, like a STRING_RETURN result.
+typedef void (*mcp_universal_value_func_t)(mcp_param_accessor_t* params, void* user_data,
+                                           mcp_param_value_t* result);
+
+// One registered parameter across the rows of a batch: the values of row i are at
+// index i. present[i] is 0 where the argument is missing or not of the column's type,
+// and the value then reads as 0 (NULL for strings). Strings are borrowed.
+typedef struct {
+    const char* name;
+    mcp_param_type_t type;
+    union {
+        const int64_t* int_values;
+        const double* double_values;
+        const char* const* string_values;
+        const int* bool_values;
+    };
+    const unsigned char* present;
+} mcp_batch_column_t;
+
+// Calls of a batch tool in columnar form: columns[j] is registered parameter j, and
+// results[i] receives the result of row i as in mcp_universal_value_func_t
+typedef struct {
+    size_t count;
+    size_t column_count;
+    const mcp_batch_column_t* columns;
+    mcp_param_value_t* results;
+} mcp_batch_t;
+
+// Batch function signature: computes every row of the batch in one call
+typedef void (*mcp_batch_func_t)(const mcp_batch_t* batch, void* user_data);
+
 
 
 /**
@@ -107,9 +173,22 @@ typedef void* (*mcp_universal_func_t)(mcp_param_accessor_t* params, void* user_d
 typedef enum {
     MCP_PARAM_SINGLE,    // Single value parameter (int, double, string, bool)
     MCP_PARAM_ARRAY,     // Array of values parameter
-    MCP_PARAM_OBJECT     // Complex JSON object parameter
+    MCP_PARAM_OBJECT,    // Complex JSON object parameter
+    MCP_PARAM_PACKED     // Numeric array sent as one base64 string of packed elements
 } mcp_param_category_t;
 
+/**
+ * Element types of packed array parameters, little-endian on the wire.
+ * Integer elements are read with the int array getters and floating-point elements
+ * with the double array getters; either getter converts the other kind.
+ */
+typedef enum {
+    MCP_PACKED_INT32,
+    MCP_PACKED_INT64,
+    MCP_PACKED_FLOAT,
+    MCP_PACKED_DOUBLE
+} mcp_packed_type_t;
+
 /**
  * Array parameter description - used for array-type parameters
  */
@@ -132,6 +211,7 @@ typedef struct {
         mcp_param_type_t single_type;   // For single-value parameters
         mcp_array_desc_t array_desc;    // For array parameters
         const char *object_schema;      // JSON Schema string for complex objects
+        mcp_packed_type_t packed_type;  // For packed array parameters
     };
 } mcp_param_desc_t;
 
@@ -169,8 +249,30 @@ typedef struct {
     int session_timeout;        // Session timeout in seconds (default: 3600)
     int enable_sessions;        // Enable session management (0=off, 1=on, default: 1)
     int auto_cleanup;           // Auto cleanup expired sessions (0=off, 1=on, default: 1)
+
+    // Concurrency
+    int worker_threads;         // HTTP request worker threads (0=handle on the poll thread, default: 0)
+                                // Tool functions must be thread-safe when > 0
+    int event_loops;            // HTTP event loops sharing the port via SO_REUSEPORT, one thread per
+                                // loop pinned to a core (0/1=single loop, default: 0)
+                                // Tool functions must be thread-safe when > 1
+    int request_arena;          // Serve each request's cJSON allocations from a per-thread arena that is
+                                // reset once the response is sent (0=off, 1=on, default: 0)
+                                // Tool functions must not keep cJSON objects they create past the call
+    int list_page_size;         // Maximum entries per tools/list, resources/list and resources/templates/list
+                                // response; longer lists return a nextCursor (0=no limit, default: 0)
+    int tool_stats_resource;    // Publish per-tool call counts and latency percentiles as the
+                                // EMBED_MCP_TOOL_STATS_URI resource (0=off, 1=on, default: 0)
+    int tool_timeout;           // Seconds a tool call may run before it fails with a timeout error; caps
+                                // the per-tool limits of embed_mcp_set_tool_timeout (-1=no cap, default: 30)
+    int max_message_size;       // Largest JSON-RPC message accepted, in bytes: an HTTP request body or one
+                                // STDIO line (0=default: 1MB). Packed parameters travel as base64, 4/3 of
+                                // their raw size - 1M doubles need about 10.7MB
 } embed_mcp_config_t;
 
+// URI of the built-in tool statistics resource (application/json)
+#define EMBED_MCP_TOOL_STATS_URI "embedmcp://stats/tools"
+
 // =============================================================================
 // Core API Functions
 // =============================================================================
@@ -282,6 +384,68 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
                        mcp_universal_func_t wrapper_func,
                        void *user_data);
 
+/**
+ * Register a tool whose function writes its result into a value
+ *
+ * Same as embed_mcp_add_tool(), but INT and DOUBLE results need no malloc/free per
+ * call. EMBED_MCP_WRAPPER and EMBED_MCP_WRAPPER_INDEXED generate such a function
+ * next to each wrapper, named with a _value suffix:
+ *
+ * ```c
+ * EMBED_MCP_WRAPPER(add_wrapper, add, INT, INT, a, INT, b)
+ *
+ * embed_mcp_add_value_tool(server, "add", "Add two numbers",
+ *                          param_names, param_descriptions, param_types, 2,
+ *                          MCP_RETURN_INT, add_wrapper_value, NULL);
+ * ```
+ *
+ * @param value_func Function writing the result; see mcp_universal_value_func_t
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_add_value_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const void *param_names,
+                             const char *param_descriptions[],
+                             mcp_param_type_t param_types[],
+                             size_t param_count,
+                             mcp_return_type_t return_type,
+                             mcp_universal_value_func_t value_func,
+                             void *user_data);
+
+/**
+ * Register a tool that computes many calls at once
+ *
+ * Calls of the tool that arrive together (e.g. in one JSON-RPC batch) reach
+ * batch_func in a single invocation, their arguments laid out one column per
+ * parameter, so the function can loop over plain arrays (and vectorize). A lone
+ * call is a batch of one row. Parameters are declared as for embed_mcp_add_tool()
+ * but must be scalars.
+ *
+ * ```c
+ * static void scale_batch(const mcp_batch_t *batch, void *user_data) {
+ *     const double *x = batch->columns[0].double_values;
+ *     const double *k = batch->columns[1].double_values;
+ *     for (size_t i = 0; i < batch->count; i++) {
+ *         batch->results[i].double_val = x[i] * k[i];
+ *     }
+ * }
+ * ```
+ *
+ * @param batch_func Function computing the rows; see mcp_batch_t
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_add_batch_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const void *param_names,
+                             const char *param_descriptions[],
+                             mcp_param_type_t param_types[],
+                             size_t param_count,
+                             mcp_return_type_t return_type,
+                             mcp_batch_func_t batch_func,
+                             void *user_data);
+
 
 
 
@@ -402,6 +566,35 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
 #define GET_PARAM_NAMES_19() // Invalid
 #define GET_PARAM_NAMES_20(t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8, t9, n9, t10, n10) n1, n2, n3, n4, n5, n6, n7, n8, n9, n10
 
+// Same with each pair's position, for getters that skip the name lookup
+#define PROCESS_PARAM_PAIR_AT(type, name, index) type##_EXTRACT_AT(name, index, params);
+
+#define FOR_EACH_PAIR_INDEXED(macro, ...) FOR_EACH_PAIR_INDEXED_IMPL(GET_ARG_COUNT(__VA_ARGS__), macro, __VA_ARGS__)
+#define FOR_EACH_PAIR_INDEXED_IMPL(count, macro, ...) CONCAT(FOR_EACH_PAIR_INDEXED_, count)(macro, __VA_ARGS__)
+
+// FOR_EACH_PAIR_INDEXED implementations: macro(type, name, position)
+#define FOR_EACH_PAIR_INDEXED_0(macro)
+#define FOR_EACH_PAIR_INDEXED_1(macro, t1) // Invalid - single argument without pair
+#define FOR_EACH_PAIR_INDEXED_2(macro, t1, n1) macro(t1, n1, 0)
+#define FOR_EACH_PAIR_INDEXED_3(macro, t1, n1, t2) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_4(macro, t1, n1, t2, n2) macro(t1, n1, 0) macro(t2, n2, 1)
+#define FOR_EACH_PAIR_INDEXED_5(macro, t1, n1, t2, n2, t3) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_6(macro, t1, n1, t2, n2, t3, n3) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2)
+#define FOR_EACH_PAIR_INDEXED_7(macro, t1, n1, t2, n2, t3, n3, t4) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_8(macro, t1, n1, t2, n2, t3, n3, t4, n4) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3)
+#define FOR_EACH_PAIR_INDEXED_9(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_10(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4)
+#define FOR_EACH_PAIR_INDEXED_11(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_12(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4) macro(t6, n6, 5)
+#define FOR_EACH_PAIR_INDEXED_13(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_14(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4) macro(t6, n6, 5) macro(t7, n7, 6)
+#define FOR_EACH_PAIR_INDEXED_15(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_16(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4) macro(t6, n6, 5) macro(t7, n7, 6) macro(t8, n8, 7)
+#define FOR_EACH_PAIR_INDEXED_17(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8, t9) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_18(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8, t9, n9) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4) macro(t6, n6, 5) macro(t7, n7, 6) macro(t8, n8, 7) macro(t9, n9, 8)
+#define FOR_EACH_PAIR_INDEXED_19(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8, t9, n9, t10) // Invalid - odd number
+#define FOR_EACH_PAIR_INDEXED_20(macro, t1, n1, t2, n2, t3, n3, t4, n4, t5, n5, t6, n6, t7, n7, t8, n8, t9, n9, t10, n10) macro(t1, n1, 0) macro(t2, n2, 1) macro(t3, n3, 2) macro(t4, n4, 3) macro(t5, n5, 4) macro(t6, n6, 5) macro(t7, n7, 6) macro(t8, n8, 7) macro(t9, n9, 8) macro(t10, n10, 9)
+
 // Function call generation
 #define CALL_FUNCTION_WITH_PARAMS(func, ...) func(CONCAT(GET_PARAM_NAMES_, GET_ARG_COUNT(__VA_ARGS__))(__VA_ARGS__))
 
@@ -415,6 +608,12 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
 #define STRING_EXTRACT(name, params) const char* name = params->get_string(params, #name)
 #define BOOL_EXTRACT(name, params) bool name = params->get_bool(params, #name)
 
+// Extraction by registration position
+#define INT_EXTRACT_AT(name, index, params) int name = (int)params->get_int_at(params, index)
+#define DOUBLE_EXTRACT_AT(name, index, params) double name = params->get_double_at(params, index)
+#define STRING_EXTRACT_AT(name, index, params) const char* name = params->get_string_at(params, index)
+#define BOOL_EXTRACT_AT(name, index, params) bool name = params->get_bool_at(params, index)
+
 // Array type extraction helpers
 #define INT_ARRAY_EXTRACT(name, params) \
     size_t name##_count; \
@@ -448,6 +647,12 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
         free(name##_raw); \
     }
 
+// Positional extraction of arrays falls back to the name
+#define INT_ARRAY_EXTRACT_AT(name, index, params) INT_ARRAY_EXTRACT(name, params)
+#define DOUBLE_ARRAY_EXTRACT_AT(name, index, params) DOUBLE_ARRAY_EXTRACT(name, params)
+#define STRING_ARRAY_EXTRACT_AT(name, index, params) STRING_ARRAY_EXTRACT(name, params)
+#define BOOL_ARRAY_EXTRACT_AT(name, index, params) BOOL_ARRAY_EXTRACT(name, params)
+
 // Return value helpers
 #define INT_RETURN(result) do { int* ret = malloc(sizeof(int)); *ret = (result); return ret; } while(0)
 #define DOUBLE_RETURN(result) do { double* ret = malloc(sizeof(double)); *ret = (result); return ret; } while(0)
@@ -455,6 +660,13 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
 #define BOOL_RETURN(result) do { int* ret = malloc(sizeof(int)); *ret = (result); return ret; } while(0)
 #define VOID_RETURN(result) do { (void)(result); return NULL; } while(0)
 
+// Return value helpers for the _value functions: no allocation for scalars
+#define INT_VALUE_RETURN(out, result) do { (out)->type = MCP_PARAM_INT; (out)->int_val = (result); } while(0)
+#define DOUBLE_VALUE_RETURN(out, result) do { (out)->type = MCP_PARAM_DOUBLE; (out)->double_val = (result); } while(0)
+#define STRING_VALUE_RETURN(out, result) do { (out)->type = MCP_PARAM_STRING; (out)->string_val = (char*)(result); } while(0)
+#define BOOL_VALUE_RETURN(out, result) do { (out)->type = MCP_PARAM_BOOL; (out)->bool_val = (result) ? 1 : 0; } while(0)
+#define VOID_VALUE_RETURN(out, result) do { (void)(out); (void)(result); } while(0)
+
 // Array return value helpers
 #define INT_ARRAY_RETURN(result, count) do { \
     cJSON* array = cJSON_CreateArray(); \
@@ -523,12 +735,41 @@ int embed_mcp_add_tool(embed_mcp_server_t *server,
  * EMBED_MCP_WRAPPER(add_wrapper, add, INT, INT, a, INT, b)
  * EMBED_MCP_WRAPPER(complex_wrapper, complex_func, DOUBLE, INT, x, DOUBLE, y, STRING, mode, BOOL, flag)
  * EMBED_MCP_WRAPPER(no_param_wrapper, no_param_func, INT)
+ *
+ * Each wrapper comes with wrapper_name##_value, the same call for
+ * embed_mcp_add_value_tool(), which returns scalars without a heap allocation.
  */
 #define EMBED_MCP_WRAPPER(wrapper_name, func_name, return_type, ...) \
     void* wrapper_name(mcp_param_accessor_t* params, void* user_data) { \
         (void)user_data; \
         FOR_EACH_PAIR(PROCESS_PARAM_PAIR, __VA_ARGS__) \
         return_type##_RETURN(CALL_FUNCTION_WITH_PARAMS(func_name, __VA_ARGS__)); \
+    } \
+    void wrapper_name##_value(mcp_param_accessor_t* params, void* user_data, mcp_param_value_t* result) { \
+        (void)user_data; \
+        FOR_EACH_PAIR(PROCESS_PARAM_PAIR, __VA_ARGS__) \
+        return_type##_VALUE_RETURN(result, CALL_FUNCTION_WITH_PARAMS(func_name, __VA_ARGS__)); \
+    }
+
+/**
+ * Same as EMBED_MCP_WRAPPER, but scalar parameters are read by position instead of
+ * by name, so each one is a direct slot read. The parameters must be registered in
+ * the order they are listed here; array parameters are still read by name.
+ *
+ * Example:
+ * EMBED_MCP_WRAPPER_INDEXED(add_wrapper, add, INT, INT, a, INT, b)
+ * // registered with names {"a", "b"}
+ */
+#define EMBED_MCP_WRAPPER_INDEXED(wrapper_name, func_name, return_type, ...) \
+    void* wrapper_name(mcp_param_accessor_t* params, void* user_data) { \
+        (void)user_data; \
+        FOR_EACH_PAIR_INDEXED(PROCESS_PARAM_PAIR_AT, __VA_ARGS__) \
+        return_type##_RETURN(CALL_FUNCTION_WITH_PARAMS(func_name, __VA_ARGS__)); \
+    } \
+    void wrapper_name##_value(mcp_param_accessor_t* params, void* user_data, mcp_param_value_t* result) { \
+        (void)user_data; \
+        FOR_EACH_PAIR_INDEXED(PROCESS_PARAM_PAIR_AT, __VA_ARGS__) \
+        return_type##_VALUE_RETURN(result, CALL_FUNCTION_WITH_PARAMS(func_name, __VA_ARGS__)); \
     }
 
 
@@ -607,6 +848,125 @@ int embed_mcp_add_tool_with_schema(embed_mcp_server_t *server,
                                    const cJSON *schema,
                                    embed_mcp_tool_handler_t handler);
 
+/**
+ * Add a tool that finishes its work after the handler returns
+ * The handler starts the work (on another thread, a device callback, ...) and returns
+ * at once; the server thread that dispatched the call is free for other requests
+ * while it runs. The response is sent when embed_mcp_complete_tool() is called.
+ * Results completed after the server stopped are dropped.
+ * @param server Server instance
+ * @param name Tool name (must be unique)
+ * @param description Tool description
+ * @param schema JSON Schema for input validation (can be NULL for no validation)
+ * @param handler Handler that starts the call
+ * @param user_data Passed to every handler call
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_add_async_tool(embed_mcp_server_t *server,
+                             const char *name,
+                             const char *description,
+                             const cJSON *schema,
+                             embed_mcp_async_tool_handler_t handler,
+                             void *user_data);
+
+/**
+ * Deliver the result of an async tool call
+ * Takes ownership of result. A plain JSON value is wrapped like the result of a
+ * schema tool; an MCP result (content + isError) is sent as is; NULL reports an
+ * execution error. The completion is freed and must not be used again.
+ * @param completion Completion passed to the async handler
+ * @param result Tool result
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_complete_tool(embed_mcp_completion_t *completion, cJSON *result);
+
+/**
+ * Check whether the async call was abandoned (its deadline passed, or the client
+ * sent notifications/cancelled for it)
+ * Long-running work should poll this and stop early; the result it completes with
+ * afterwards is discarded, but embed_mcp_complete_tool() must still be called.
+ * @param completion Completion passed to the async handler
+ * @return 1 if cancelled, 0 otherwise
+ */
+int embed_mcp_completion_cancelled(const embed_mcp_completion_t *completion);
+
+/**
+ * Check whether the tool call running on this thread was abandoned (its deadline
+ * passed, or the client sent notifications/cancelled for it)
+ * For synchronous tools: a server thread stays busy until the tool returns, so loops
+ * should poll this and return early. Past the deadline, whatever the tool returns is
+ * replaced with a timeout error; after a client cancellation it is sent as is.
+ * @return 1 if cancelled, 0 otherwise (also outside tool calls)
+ */
+int embed_mcp_tool_cancelled(void);
+
+/**
+ * Send a notifications/progress message for the tool call running on this thread
+ * Only calls whose request carried params._meta.progressToken get progress, and only
+ * over transports that can send more than the response (STDIO; plain HTTP answers
+ * each request with a single message). progress must increase from one report to
+ * the next.
+ * @param progress Work done so far
+ * @param total Total amount of work, or 0 if unknown
+ * @param message Human-readable status (can be NULL)
+ * @return 0 if sent, -1 otherwise
+ */
+int embed_mcp_report_progress(double progress, double total, const char *message);
+
+/**
+ * Send a notifications/progress message for an async call
+ * Same rules as embed_mcp_report_progress(); may be called from any thread until
+ * the call is completed. Reports after the call was answered are dropped.
+ * @param completion Completion passed to the async handler
+ * @param progress Work done so far
+ * @param total Total amount of work, or 0 if unknown
+ * @param message Human-readable status (can be NULL)
+ * @return 0 if sent, -1 otherwise
+ */
+int embed_mcp_completion_report_progress(embed_mcp_completion_t *completion,
+                                         double progress, double total, const char *message);
+
+/**
+ * Set how long a tool may run before the call fails with a timeout error
+ * The limit is capped by embed_mcp_config_t.tool_timeout. Async tools are answered
+ * as soon as it passes; synchronous tools when they return.
+ * @param server Server instance
+ * @param name Tool name
+ * @param timeout_ms Limit in milliseconds (0 = only the server-wide limit, default: 30000)
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_set_tool_timeout(embed_mcp_server_t *server, const char *name, int timeout_ms);
+
+/**
+ * Memoize the results of a pure tool
+ * For tools whose result depends only on their arguments (no I/O, no clock, no state).
+ * A call with the same arguments as an earlier successful call gets a copy of that
+ * result without running the handler; argument objects match regardless of member
+ * order. Error results are never cached. Hits and misses appear in the tool's stats.
+ * @param server Server instance
+ * @param name Name of a synchronous tool
+ * @param max_bytes Memory budget; least recently used results are evicted beyond it
+ *                  (0 = disable the cache and drop its results)
+ * @param ttl_ms How long a result may be reused (0 = until evicted)
+ * @return 0 on success, -1 on error (unknown or async tool)
+ */
+int embed_mcp_set_tool_cache(embed_mcp_server_t *server, const char *name,
+                             size_t max_bytes, int ttl_ms);
+
+/**
+ * Stop mirroring a tool's structuredContent as JSON text in its content array
+ * Use this for tools with large results when clients read structuredContent
+ * (protocol 2025-06-18 and later); the text copy doubles the response size.
+ * @param server Server instance
+ * @param name Name of a tool added with embed_mcp_add_tool, embed_mcp_add_tool_with_schema
+ *             or embed_mcp_add_async_tool
+ * @param structured_only 1 to return structuredContent only, 0 to restore the text mirror
+ * @return 0 on success, -1 on error
+ */
+int embed_mcp_set_tool_structured_only(embed_mcp_server_t *server,
+                                      const char *name,
+                                      int structured_only);
+
 
 
 /**
@@ -653,6 +1013,14 @@ int embed_mcp_quick_start(const char *name, const char *version,
  */
 const char *embed_mcp_get_error(void);
 
+/**
+ * Get per event-loop network statistics of a running HTTP server
+ * @param server Server instance
+ * @return JSON object {"event_loops": N, "shards": [...]} (caller must free with cJSON_Delete),
+ *         or NULL if the server is not running over HTTP
+ */
+cJSON *embed_mcp_get_network_stats(embed_mcp_server_t *server);
+
 // =============================================================================
 // Convenience Macros for Parameter Definitions
 // =============================================================================
@@ -683,6 +1051,20 @@ const char *embed_mcp_get_error(void);
 #define MCP_PARAM_ARRAY_BOOL_DEF(name, desc, elem_desc, req) \
     {name, desc, MCP_PARAM_ARRAY, req, .array_desc = {MCP_PARAM_BOOL, elem_desc}}
 
+// Packed array parameter macros: base64 of the little-endian elements, decoded
+// without a JSON node per element (e.g. for large sensor buffers)
+#define MCP_PARAM_PACKED_INT32_DEF(name, desc, req) \
+    {name, desc, MCP_PARAM_PACKED, req, .packed_type = MCP_PACKED_INT32}
+
+#define MCP_PARAM_PACKED_INT64_DEF(name, desc, req) \
+    {name, desc, MCP_PARAM_PACKED, req, .packed_type = MCP_PACKED_INT64}
+
+#define MCP_PARAM_PACKED_FLOAT_DEF(name, desc, req) \
+    {name, desc, MCP_PARAM_PACKED, req, .packed_type = MCP_PACKED_FLOAT}
+
+#define MCP_PARAM_PACKED_DOUBLE_DEF(name, desc, req) \
+    {name, desc, MCP_PARAM_PACKED, req, .packed_type = MCP_PACKED_DOUBLE}
+
 // Object parameter macro
 #define MCP_PARAM_OBJECT_DEF(name, desc, schema, req) \
     {name, desc, MCP_PARAM_OBJECT, req, .object_schema = schema}
@@ -150,6 +150,7 @@ static const mcp_platform_hal_t custom_platform_hal = {
     .time = {
         .get_tick_ms = NULL,        // 平台特定获取时钟
         .get_time_us = NULL,        // 平台特定获取微秒时间
+        .get_monotonic_ns = NULL,   // 平台特定单调纳秒时间（可选）
         .delay_ms = NULL,           // 平台特定毫秒延时
         .delay_us = NULL            // 平台特定微秒延时
     },
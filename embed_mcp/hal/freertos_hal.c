@@ -169,6 +169,10 @@ static uint64_t freertos_get_time_us(void) {
     return (uint64_t)xTaskGetTickCount() * portTICK_PERIOD_MS * 1000;
 }
 
+static uint64_t freertos_get_monotonic_ns(void) {
+    return (uint64_t)xTaskGetTickCount() * portTICK_PERIOD_MS * 1000000ull;
+}
+
 static void freertos_delay_ms(uint32_t ms) {
     vTaskDelay(ms / portTICK_PERIOD_MS);
 }
@@ -269,6 +273,7 @@ static const mcp_platform_hal_t freertos_hal = {
     .time = {
         .get_tick_ms = freertos_get_tick_ms,
         .get_time_us = freertos_get_time_us,
+        .get_monotonic_ns = freertos_get_monotonic_ns,
         .delay_ms = freertos_delay_ms,
         .delay_us = freertos_delay_us
     },
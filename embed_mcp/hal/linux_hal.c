@@ -5,31 +5,80 @@
 
 #include <stdlib.h>
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/socket.h>
 #include <stdint.h>
 #include <netinet/in.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "utils/atomic.h"
+
 // Mongoose HAL实现 - mongoose就是我们的跨平台HAL层
 // mongoose内部支持Linux/FreeRTOS/ESP32等15+平台，我们只需要封装统一接口
 #include "../platform/linux/mongoose.h"
 
-// 全局mongoose管理器 - 这就是我们的HAL核心
-static struct mg_mgr g_mongoose_mgr;
+// 最大事件循环分片数
+#define HAL_MAX_SHARDS 16
+
+// HAL连接ID = mongoose连接ID * HAL_MAX_SHARDS + 分片序号
+// 每个mg_mgr各自从1开始分配连接ID，编码分片序号后才能全局唯一
+#define HAL_CONN_ID(shard, c) ((unsigned long)(c)->id * HAL_MAX_SHARDS + (unsigned long)(shard)->index)
+
+// 跨线程投递的待发送响应 - 由所属分片的轮询线程统一发送
+// 投递线程预先格式化好完整的HTTP响应，节点本身放在同一次分配的data末尾，
+// 发送缓冲区为空时整块移交给c->send，轮询线程无需再复制
+typedef struct hal_posted_reply {
+    unsigned long connection_id;    // mongoose连接ID（已去掉分片序号）
+    unsigned char* data;            // 状态行 + 头部 + 正文
+    size_t len;
+    size_t body_len;
+    struct hal_posted_reply* next;
+} hal_posted_reply_t;
+
+// 事件循环分片 - 每个分片拥有独立的mg_mgr、监听连接和投递队列
+typedef struct {
+    struct mg_mgr mgr;
+    struct mg_connection* listener;
+    unsigned long wakeup_conn_id;   // 监听连接ID，用于mg_wakeup唤醒
+    int index;
+    void* thread;                   // 分片线程；单循环模式下为NULL，由network_poll驱动
+    volatile bool running;
+    bool disabled;                  // 线程未能启动，mg_mgr已释放；停止和投递时跳过
+
+    mcp_hal_http_handler_t handler;
+    void* user_data;
+
+    pthread_mutex_t posted_mutex;
+    hal_posted_reply_t* posted_head;
+    hal_posted_reply_t* posted_tail;
+
+    mcp_hal_shard_stats_t stats;
+} hal_shard_t;
+
+// 全局分片表 - 单循环模式下只使用g_shards[0]
+static hal_shard_t g_shards[HAL_MAX_SHARDS];
+static int g_shard_count = 0;
 static bool g_mongoose_initialized = false;
+static bool g_sharded = false;  // true: 每个分片在自己的线程上轮询
+
+// 分片模式下network_poll等待的控制管道（I/O由分片线程处理）
+static int g_control_pipe[2] = {-1, -1};
 
-// Helper: convert mg_str to a stable C string (rotating buffers).
-static const char* mg_str_to_cstr(struct mg_str str) {
-    static char buffers[4][1024];
-    static int current = 0;
+// 请求体上限（0: 只受MG_MAX_RECV_SIZE限制），服务器启动前设置
+static size_t g_hal_max_body_size = 0;
 
-    char* buf = buffers[current];
-    current = (current + 1) % 4;
+// 接收缓冲区同时容纳请求头和请求体，为请求头预留的空间
+#define HAL_HTTP_HEAD_RESERVE (64 * 1024)
 
-    size_t len = str.len < (sizeof(buffers[0]) - 1) ? str.len : (sizeof(buffers[0]) - 1);
+// Helper: copy an mg_str into a caller-provided buffer (thread-safe).
+static const char* mg_str_to_cstr(struct mg_str str, char* buf, size_t buf_size) {
+    size_t len = str.len < (buf_size - 1) ? str.len : (buf_size - 1);
     memcpy(buf, str.buf, len);
     buf[len] = '\0';
     return buf;
@@ -140,6 +189,12 @@ static uint64_t linux_get_time_us(void) {
     return (uint64_t)(tv.tv_sec * 1000000 + tv.tv_usec);
 }
 
+static uint64_t linux_get_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 static void linux_delay_ms(uint32_t ms) {
     usleep(ms * 1000);
 }
@@ -148,91 +203,621 @@ static void linux_delay_us(uint32_t us) {
     usleep(us);
 }
 
+// HTTP状态码对应的原因短语
+static const char* hal_http_status_text(int status_code) {
+    switch (status_code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "OK";
+    }
+}
+
+// HTTP响应头部：状态行 + 调用方头部 + Content-Length
+typedef struct {
+    char status_line[64];
+    char length_line[48];
+    size_t status_len;
+    size_t length_len;
+    const char* headers;
+    size_t headers_len;
+} hal_http_head_t;
+
+// 准备响应头部，返回头部总字节数
+static size_t hal_http_head_init(hal_http_head_t* head, int status_code,
+                                 const char* headers, size_t body_len) {
+    head->status_len = (size_t)snprintf(head->status_line, sizeof(head->status_line), "HTTP/1.1 %d %s\r\n",
+                                        status_code, hal_http_status_text(status_code));
+    head->length_len = (size_t)snprintf(head->length_line, sizeof(head->length_line),
+                                        "Content-Length: %lu\r\n\r\n", (unsigned long)body_len);
+    head->headers = headers;
+    head->headers_len = headers ? strlen(headers) : 0;
+    return head->status_len + head->headers_len + head->length_len;
+}
+
+// 写出头部，返回写入位置的末尾
+static unsigned char* hal_http_head_write(const hal_http_head_t* head, unsigned char* p) {
+    memcpy(p, head->status_line, head->status_len);
+    p += head->status_len;
+    if (head->headers_len > 0) {
+        memcpy(p, head->headers, head->headers_len);
+        p += head->headers_len;
+    }
+    memcpy(p, head->length_line, head->length_len);
+    return p + head->length_len;
+}
+
+// 直接写入发送缓冲区的HTTP响应
+// 状态行和头部按长度拼接，正文只做一次memcpy；不经过mg_http_reply的printf格式化
+static bool hal_send_http_response(struct mg_connection* c, int status_code, const char* headers,
+                                   const char* body, size_t body_len) {
+    hal_http_head_t head;
+    size_t total = hal_http_head_init(&head, status_code, headers, body_len) + body_len;
+
+    // 一次扩容到位，避免逐段追加时重复分配和搬移
+    struct mg_iobuf* io = &c->send;
+    if (io->len + total > io->size && !mg_iobuf_resize(io, io->len + total)) {
+        c->is_closing = 1;
+        return false;
+    }
+
+    unsigned char* p = hal_http_head_write(&head, io->buf + io->len);
+    if (body_len > 0) {
+        memcpy(p, body, body_len);
+    }
+    io->len += total;
+
+    c->is_resp = 0;
+    return true;
+}
+
+// 发送一个已格式化的投递响应，之后reply不可再访问
+static bool hal_send_posted_reply(struct mg_connection* c, hal_posted_reply_t* reply) {
+    struct mg_iobuf* io = &c->send;
+
+    if (io->len == 0) {
+        // 发送缓冲区为空：直接移交所有权 (Linux上mg_free即free)
+        mg_iobuf_free(io);
+        io->buf = reply->data;
+        io->len = io->size = reply->len;
+    } else {
+        bool ok = io->len + reply->len <= io->size || mg_iobuf_resize(io, io->len + reply->len);
+        if (ok) {
+            memcpy(io->buf + io->len, reply->data, reply->len);
+            io->len += reply->len;
+        }
+        free(reply->data);
+        if (!ok) {
+            c->is_closing = 1;
+            return false;
+        }
+    }
+
+    c->is_resp = 0;
+    return true;
+}
+
+// 发送分片中所有已投递的响应（仅在该分片的轮询线程调用）
+static void hal_flush_posted_replies(hal_shard_t* shard) {
+    pthread_mutex_lock(&shard->posted_mutex);
+    hal_posted_reply_t* reply = shard->posted_head;
+    shard->posted_head = shard->posted_tail = NULL;
+    pthread_mutex_unlock(&shard->posted_mutex);
+
+    while (reply) {
+        hal_posted_reply_t* next = reply->next;
+        size_t body_len = reply->body_len;
+
+        struct mg_connection* c;
+        for (c = shard->mgr.conns; c != NULL; c = c->next) {
+            if (c->id == reply->connection_id) break;
+        }
+
+        // 客户端可能已断开，此时直接丢弃
+        if (c && !c->is_closing) {
+            if (hal_send_posted_reply(c, reply)) {
+                MCP_ATOMIC_INC(&shard->stats.responses_sent);
+                MCP_ATOMIC_ADD(&shard->stats.bytes_sent, (uint64_t)body_len);
+            }
+        } else {
+            free(reply->data);
+        }
+
+        reply = next;
+    }
+}
+
+// 丢弃尚未发送的投递响应（分片停止后调用）
+static void hal_discard_posted_replies(hal_shard_t* shard) {
+    pthread_mutex_lock(&shard->posted_mutex);
+    hal_posted_reply_t* reply = shard->posted_head;
+    shard->posted_head = shard->posted_tail = NULL;
+    pthread_mutex_unlock(&shard->posted_mutex);
+
+    while (reply) {
+        hal_posted_reply_t* next = reply->next;
+        free(reply->data);
+        reply = next;
+    }
+}
+
 // mongoose事件处理器 - 将mongoose事件转换为HAL回调
 static void hal_mongoose_event_handler(struct mg_connection *c, int ev, void *ev_data) {
-    if (ev == MG_EV_HTTP_MSG) {
+    hal_shard_t* shard = (hal_shard_t*)c->mgr->userdata;
+
+    if (ev == MG_EV_WAKEUP) {
+        MCP_ATOMIC_INC(&shard->stats.wakeups);
+        hal_flush_posted_replies(shard);
+    } else if (ev == MG_EV_ACCEPT) {
+        MCP_ATOMIC_INC(&shard->stats.connections_accepted);
+        MCP_ATOMIC_INC(&shard->stats.connections_active);
+    } else if (ev == MG_EV_CLOSE) {
+        if (c->is_accepted) {
+            MCP_ATOMIC_DEC(&shard->stats.connections_active);
+        }
+    } else if (ev == MG_EV_HTTP_HDRS) {
+        // 请求头已到达：声明的或已收到的请求体超过上限时直接回复413并关闭，不再继续缓冲
+        struct mg_http_message *hm = (struct mg_http_message *)ev_data;
+        size_t received = (size_t)((char *)c->recv.buf + c->recv.len - hm->body.buf);
+        bool declared_too_large = hm->body.len != (size_t)~0 && hm->body.len > g_hal_max_body_size;
+
+        if (g_hal_max_body_size > 0 && (declared_too_large || received > g_hal_max_body_size)) {
+            static const char body[] = "{\"error\":\"Request too large\"}";
+            hal_send_http_response(c, 413, "Content-Type: application/json\r\nConnection: close\r\n",
+                                   body, sizeof(body) - 1);
+            c->recv.len = 0;
+            c->is_draining = 1;
+        }
+    } else if (ev == MG_EV_HTTP_MSG) {
         struct mg_http_message *hm = (struct mg_http_message *)ev_data;
-        mcp_hal_http_handler_t handler = (mcp_hal_http_handler_t)c->fn_data;
-        void* user_data = c->mgr->userdata;
 
-        if (handler) {
+        MCP_ATOMIC_INC(&shard->stats.requests);
+
+        if (shard->handler) {
+            char method[16];
+            char uri[1024];
+
             // 转换mongoose请求到HAL请求
             mcp_hal_http_request_t hal_req = {
-                .method = mg_str_to_cstr(hm->method),
-                .uri = mg_str_to_cstr(hm->uri),
+                .method = mg_str_to_cstr(hm->method, method, sizeof(method)),
+                .uri = mg_str_to_cstr(hm->uri, uri, sizeof(uri)),
                 .head = hm->head.buf,
                 .head_len = hm->head.len,
                 .body = hm->body.buf,
                 .body_len = hm->body.len,
-                .connection = (mcp_hal_connection_t)c
+                .connection = (mcp_hal_connection_t)c,
+                .connection_id = HAL_CONN_ID(shard, c)
             };
 
             // 创建HAL响应
             mcp_hal_http_response_t hal_resp = {0};
 
             // 调用HAL处理器
-            handler(&hal_req, &hal_resp, user_data);
+            shard->handler(&hal_req, &hal_resp, shard->user_data);
 
             // 发送响应
-            if (hal_resp.status_code > 0) {
-                mg_http_reply(c, hal_resp.status_code,
-                             hal_resp.headers ? hal_resp.headers : "Content-Type: application/json\r\n",
-                             "%.*s", (int)hal_resp.body_len, hal_resp.body ? hal_resp.body : "");
+            if (hal_resp.status_code > 0 &&
+                hal_send_http_response(c, hal_resp.status_code,
+                                       hal_resp.headers ? hal_resp.headers : "Content-Type: application/json\r\n",
+                                       hal_resp.body, hal_resp.body ? hal_resp.body_len : 0)) {
+                MCP_ATOMIC_INC(&shard->stats.responses_sent);
+                MCP_ATOMIC_ADD(&shard->stats.bytes_sent, (uint64_t)hal_resp.body_len);
             }
         }
     }
 }
 
+// 初始化分片：独立的mg_mgr和唤醒通道
+static void hal_shard_init(hal_shard_t* shard, int index,
+                           mcp_hal_http_handler_t handler, void* user_data) {
+    memset(shard, 0, sizeof(*shard));
+    shard->index = index;
+    shard->handler = handler;
+    shard->user_data = user_data;
+    shard->stats.shard = index;
+    shard->stats.cpu = -1;
+    pthread_mutex_init(&shard->posted_mutex, NULL);
+
+    mg_mgr_init(&shard->mgr);
+    mg_wakeup_init(&shard->mgr);
+    shard->mgr.userdata = shard;
+}
+
+static void hal_shard_cleanup(hal_shard_t* shard) {
+    hal_discard_posted_replies(shard);
+    pthread_mutex_destroy(&shard->posted_mutex);
+}
+
+// 创建带SO_REUSEPORT的监听连接
+// mongoose在bind之前没有设置套接字选项的钩子：先用mg_http_listen在回环临时端口上
+// 建立带HTTP协议处理的监听连接，再把它的套接字换成预先绑定好的SO_REUSEPORT套接字。
+// 依赖mongoose以select模式编译 (MG_ENABLE_EPOLL=0)，换fd后无需重新注册。
+static struct mg_connection* hal_reuseport_listen(struct mg_mgr* mgr, const char* url) {
+    struct mg_addr addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.port = mg_htons(mg_url_port(url));
+    if (!mg_aton(mg_url_host(url), &addr)) {
+        return NULL;
+    }
+
+    struct sockaddr_storage ss;
+    socklen_t ss_len;
+    memset(&ss, 0, sizeof(ss));
+    if (addr.is_ip6) {
+        struct sockaddr_in6* sin6 = (struct sockaddr_in6*)&ss;
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = addr.port;
+        memcpy(&sin6->sin6_addr, addr.ip, sizeof(sin6->sin6_addr));
+        ss_len = sizeof(*sin6);
+    } else {
+        struct sockaddr_in* sin = (struct sockaddr_in*)&ss;
+        sin->sin_family = AF_INET;
+        sin->sin_port = addr.port;
+        memcpy(&sin->sin_addr, addr.ip, sizeof(sin->sin_addr));
+        ss_len = sizeof(*sin);
+    }
+
+    int fd = socket(ss.ss_family, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0 ||
+        bind(fd, (struct sockaddr*)&ss, ss_len) != 0 ||
+        listen(fd, SOMAXCONN) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close(fd);
+        return NULL;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    struct mg_connection* c = mg_http_listen(mgr, addr.is_ip6 ? "http://[::1]:0" : "http://127.0.0.1:0",
+                                             hal_mongoose_event_handler, NULL);
+    if (!c) {
+        close(fd);
+        return NULL;
+    }
+
+    close((int)(size_t)c->fd);
+    c->fd = (void*)(size_t)fd;
+    c->loc = addr;
+
+    return c;
+}
+
+// 分片线程：绑定CPU后独立运行自己的事件循环
+static void* hal_shard_thread(void* arg) {
+    hal_shard_t* shard = (hal_shard_t*)arg;
+
+    if (shard->stats.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(shard->stats.cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            shard->stats.cpu = -1;
+        }
+    }
+
+    while (shard->running) {
+        mg_mgr_poll(&shard->mgr, 1000);
+        hal_flush_posted_replies(shard);
+    }
+
+    mg_mgr_free(&shard->mgr);
+    return NULL;
+}
+
+// 设置请求体上限；mongoose整个请求都在接收缓冲区内，上限不能超过MG_MAX_RECV_SIZE
+static int linux_hal_http_set_max_body_size(size_t max_size) {
+    size_t ceiling = (size_t)MG_MAX_RECV_SIZE - HAL_HTTP_HEAD_RESERVE;
+
+    if (max_size > ceiling) {
+        g_hal_max_body_size = ceiling;
+        return -1;
+    }
+    g_hal_max_body_size = max_size;
+    return 0;
+}
+
 // HAL网络接口实现 - 基于mongoose
 static mcp_hal_server_t linux_hal_http_listen(const char* url, mcp_hal_http_handler_t handler, void* user_data) {
     if (!g_mongoose_initialized) {
-        mg_mgr_init(&g_mongoose_mgr);
+        hal_shard_init(&g_shards[0], 0, handler, user_data);
+        g_shard_count = 1;
         g_mongoose_initialized = true;
+    } else if (g_sharded) {
+        return NULL;  // 已经以分片模式运行
     }
 
+    hal_shard_t* shard = &g_shards[0];
+
     // 创建HTTP监听器，使用mongoose
-    struct mg_connection* conn = mg_http_listen(&g_mongoose_mgr, url, hal_mongoose_event_handler, NULL);
+    struct mg_connection* conn = mg_http_listen(&shard->mgr, url, hal_mongoose_event_handler, NULL);
     if (!conn) {
         return NULL;
     }
 
     // 保存用户回调和数据
-    conn->fn_data = handler;
-    conn->mgr->userdata = user_data;
+    shard->handler = handler;
+    shard->user_data = user_data;
+    shard->listener = conn;
+    shard->wakeup_conn_id = conn->id;
 
     return (mcp_hal_server_t)conn;
 }
 
+// 多事件循环：每个分片一个SO_REUSEPORT监听套接字，由内核在分片间分配新连接
+static mcp_hal_server_t linux_hal_http_listen_sharded(const char* url, int shard_count,
+                                                      mcp_hal_http_handler_t handler, void* user_data) {
+    if (shard_count <= 1) {
+        return linux_hal_http_listen(url, handler, user_data);
+    }
+    if (g_mongoose_initialized) {
+        return NULL;
+    }
+    if (shard_count > HAL_MAX_SHARDS) {
+        shard_count = HAL_MAX_SHARDS;
+    }
+
+    if (pipe(g_control_pipe) != 0) {
+        g_control_pipe[0] = g_control_pipe[1] = -1;
+        return NULL;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(g_control_pipe[i], F_SETFL, fcntl(g_control_pipe[i], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(g_control_pipe[i], F_SETFD, FD_CLOEXEC);
+    }
+
+    int created = 0;
+    for (; created < shard_count; created++) {
+        hal_shard_t* shard = &g_shards[created];
+        hal_shard_init(shard, created, handler, user_data);
+
+        shard->listener = hal_reuseport_listen(&shard->mgr, url);
+        if (!shard->listener) {
+            mg_mgr_free(&shard->mgr);
+            hal_shard_cleanup(shard);
+            break;
+        }
+        shard->wakeup_conn_id = shard->listener->id;
+    }
+
+    if (created < shard_count) {
+        for (int i = 0; i < created; i++) {
+            mg_mgr_free(&g_shards[i].mgr);
+            hal_shard_cleanup(&g_shards[i]);
+        }
+        close(g_control_pipe[0]);
+        close(g_control_pipe[1]);
+        g_control_pipe[0] = g_control_pipe[1] = -1;
+        return NULL;
+    }
+
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count < 1) cpu_count = 1;
+
+    g_shard_count = shard_count;
+    g_sharded = true;
+    g_mongoose_initialized = true;
+
+    for (int i = 0; i < shard_count; i++) {
+        hal_shard_t* shard = &g_shards[i];
+        shard->stats.cpu = (int)(i % cpu_count);
+        shard->running = true;
+
+        if (linux_thread_create(&shard->thread, hal_shard_thread, shard, 0) != 0) {
+            shard->running = false;
+            shard->thread = NULL;
+            shard->stats.cpu = -1;
+
+            // 服务器句柄和单循环唤醒都依赖分片0，它无法运行时整体启动失败；
+            // 分片0最先启动，此时还没有其他分片线程
+            if (i == 0) {
+                for (int j = 0; j < shard_count; j++) {
+                    mg_mgr_free(&g_shards[j].mgr);
+                    hal_shard_cleanup(&g_shards[j]);
+                }
+                close(g_control_pipe[0]);
+                close(g_control_pipe[1]);
+                g_control_pipe[0] = g_control_pipe[1] = -1;
+                g_shard_count = 0;
+                g_sharded = false;
+                g_mongoose_initialized = false;
+                return NULL;
+            }
+
+            // 其余分片在调用线程上释放并停用，其他分片继续服务
+            shard->listener->is_closing = 1;
+            mg_mgr_free(&shard->mgr);
+            shard->listener = NULL;
+            shard->wakeup_conn_id = 0;
+            shard->disabled = true;
+        }
+    }
+
+    return (mcp_hal_server_t)g_shards[0].listener;
+}
+
 static int linux_hal_http_reply(mcp_hal_connection_t conn, const mcp_hal_http_response_t* response) {
     struct mg_connection* c = (struct mg_connection*)conn;
     if (!c || !response) {
         return -1;
     }
 
-    mg_http_reply(c, response->status_code,
-                 response->headers ? response->headers : "Content-Type: application/json\r\n",
-                 "%.*s", (int)response->body_len, response->body ? response->body : "");
+    hal_shard_t* shard = (hal_shard_t*)c->mgr->userdata;
+
+    size_t body_len = response->body ? response->body_len : 0;
+    if (!hal_send_http_response(c, response->status_code,
+                                response->headers ? response->headers : "Content-Type: application/json\r\n",
+                                response->body, body_len)) {
+        return -1;
+    }
+
+    MCP_ATOMIC_INC(&shard->stats.responses_sent);
+    MCP_ATOMIC_ADD(&shard->stats.bytes_sent, (uint64_t)response->body_len);
 
     return (int)response->body_len;
 }
 
+// 唤醒阻塞中的network_poll - 只调用send()/write()，可在信号处理函数中使用
+static int linux_hal_wakeup(void) {
+    if (!g_mongoose_initialized) {
+        return -1;
+    }
+
+    if (g_sharded) {
+        return write(g_control_pipe[1], "w", 1) == 1 ? 0 : -1;
+    }
+
+    if (g_shards[0].wakeup_conn_id == 0) {
+        return -1;
+    }
+    return mg_wakeup(&g_shards[0].mgr, g_shards[0].wakeup_conn_id, "", 0) ? 0 : -1;
+}
+
+// 线程安全的延迟响应：复制响应内容后唤醒所属分片的轮询线程发送
+static int linux_hal_http_post(unsigned long connection_id, const mcp_hal_http_response_t* response) {
+    if (!g_mongoose_initialized || !response || connection_id == 0) {
+        return -1;
+    }
+
+    int shard_index = (int)(connection_id % HAL_MAX_SHARDS);
+    if (shard_index >= g_shard_count) {
+        return -1;
+    }
+    hal_shard_t* shard = &g_shards[shard_index];
+    if (shard->disabled) {
+        return -1;
+    }
+
+    const char* headers = response->headers ? response->headers : "Content-Type: application/json\r\n";
+    size_t body_len = response->body ? response->body_len : 0;
+
+    // 在投递线程上格式化完整响应，节点放在数据之后（按指针大小对齐）
+    hal_http_head_t head;
+    size_t len = hal_http_head_init(&head, response->status_code, headers, body_len) + body_len;
+    size_t node_offset = (len + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    unsigned char* data = malloc(node_offset + sizeof(hal_posted_reply_t));
+    if (!data) {
+        return -1;
+    }
+
+    unsigned char* p = hal_http_head_write(&head, data);
+    if (body_len > 0) memcpy(p, response->body, body_len);
+
+    hal_posted_reply_t* reply = (hal_posted_reply_t*)(data + node_offset);
+    reply->connection_id = connection_id / HAL_MAX_SHARDS;
+    reply->data = data;
+    reply->len = len;
+    reply->body_len = body_len;
+    reply->next = NULL;
+
+    pthread_mutex_lock(&shard->posted_mutex);
+    if (shard->posted_tail) {
+        shard->posted_tail->next = reply;
+    } else {
+        shard->posted_head = reply;
+    }
+    shard->posted_tail = reply;
+    pthread_mutex_unlock(&shard->posted_mutex);
+
+    // 唤醒分片的mg_mgr_poll；即使唤醒丢失，下一次轮询也会发送
+    mg_wakeup(&shard->mgr, shard->wakeup_conn_id, "", 0);
+
+    return (int)body_len;
+}
+
 static int linux_hal_poll(int timeout_ms) {
     if (!g_mongoose_initialized) {
         return -1;
     }
 
-    mg_mgr_poll(&g_mongoose_mgr, timeout_ms);
+    // 单循环模式：在调用线程上处理I/O
+    if (!g_sharded) {
+        mg_mgr_poll(&g_shards[0].mgr, timeout_ms);
+        hal_flush_posted_replies(&g_shards[0]);
+        return 0;
+    }
+
+    // 分片模式：I/O由分片线程处理，这里只等待唤醒
+    struct pollfd pfd = { .fd = g_control_pipe[0], .events = POLLIN, .revents = 0 };
+    if (poll(&pfd, 1, timeout_ms) > 0) {
+        char buf[64];
+        while (read(g_control_pipe[0], buf, sizeof(buf)) > 0) {
+        }
+    }
     return 0;
 }
 
 static int linux_hal_server_stop(mcp_hal_server_t server) {
     struct mg_connection* conn = (struct mg_connection*)server;
-    if (conn) {
-        conn->is_closing = 1;
+
+    if (!g_mongoose_initialized || !g_sharded) {
+        if (conn) {
+            conn->is_closing = 1;
+        }
+        return 0;
+    }
+
+    // 分片模式：通知所有分片线程退出并等待其释放各自的mg_mgr
+    for (int i = 0; i < g_shard_count; i++) {
+        if (g_shards[i].disabled) continue;
+        g_shards[i].running = false;
+        mg_wakeup(&g_shards[i].mgr, g_shards[i].wakeup_conn_id, "", 0);
+    }
+    for (int i = 0; i < g_shard_count; i++) {
+        if (g_shards[i].thread) {
+            linux_thread_join(g_shards[i].thread);
+            g_shards[i].thread = NULL;
+        }
+        hal_shard_cleanup(&g_shards[i]);
     }
+
+    close(g_control_pipe[0]);
+    close(g_control_pipe[1]);
+    g_control_pipe[0] = g_control_pipe[1] = -1;
+    g_shard_count = 0;
+    g_sharded = false;
+    g_mongoose_initialized = false;
+
     return 0;
 }
 
+static int linux_hal_get_shard_stats(mcp_hal_shard_stats_t* stats, int max_shards) {
+    if (!stats || max_shards <= 0 || !g_mongoose_initialized) {
+        return -1;
+    }
+
+    int count = g_shard_count < max_shards ? g_shard_count : max_shards;
+    for (int i = 0; i < count; i++) {
+        const mcp_hal_shard_stats_t* src = &g_shards[i].stats;
+        stats[i].shard = src->shard;
+        stats[i].cpu = src->cpu;
+        stats[i].connections_accepted = MCP_ATOMIC_LOAD(&src->connections_accepted);
+        stats[i].connections_active = MCP_ATOMIC_LOAD(&src->connections_active);
+        stats[i].requests = MCP_ATOMIC_LOAD(&src->requests);
+        stats[i].responses_sent = MCP_ATOMIC_LOAD(&src->responses_sent);
+        stats[i].bytes_sent = MCP_ATOMIC_LOAD(&src->bytes_sent);
+        stats[i].wakeups = MCP_ATOMIC_LOAD(&src->wakeups);
+    }
+
+    return count;
+}
+
 // 注意：传输清理现在由传输层直接处理
 
 // Linux平台初始化
@@ -286,6 +871,7 @@ static const mcp_platform_hal_t linux_hal = {
     .time = {
         .get_tick_ms = linux_get_tick_ms,
         .get_time_us = linux_get_time_us,
+        .get_monotonic_ns = linux_get_monotonic_ns,
         .delay_ms = linux_delay_ms,
         .delay_us = linux_delay_us
     },
@@ -294,8 +880,13 @@ static const mcp_platform_hal_t linux_hal = {
         // HTTP服务器接口 - 通用接口名称，当前使用mongoose实现
         .http_server_start = linux_hal_http_listen,
         .http_response_send = linux_hal_http_reply,
+        .http_server_start_sharded = linux_hal_http_listen_sharded,
+        .http_response_post = linux_hal_http_post,
         .network_poll = linux_hal_poll,
+        .network_wakeup = linux_hal_wakeup,
         .http_server_stop = linux_hal_server_stop,
+        .http_set_max_body_size = linux_hal_http_set_max_body_size,
+        .network_get_shard_stats = linux_hal_get_shard_stats,
 
         // 底层网络接口 - 用于不支持高级HTTP库的平台
         .socket_create = NULL,  // 当前使用mongoose，不需要直接socket操作
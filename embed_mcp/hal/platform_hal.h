@@ -51,6 +51,7 @@ typedef struct {
 typedef struct {
     uint32_t (*get_tick_ms)(void);
     uint64_t (*get_time_us)(void);
+    uint64_t (*get_monotonic_ns)(void);     // Never steps backwards; optional (NULL: get_time_us)
     void (*delay_ms)(uint32_t ms);
     void (*delay_us)(uint32_t us);
 } mcp_platform_time_t;
@@ -118,6 +119,8 @@ typedef struct {
     const char* body;
     size_t body_len;
     mcp_hal_connection_t connection;
+    // Stable connection id, valid after the handler returns (for http_response_post)
+    unsigned long connection_id;
 } mcp_hal_http_request_t;
 
 // HTTP response structure
@@ -133,6 +136,18 @@ typedef void (*mcp_hal_http_handler_t)(const mcp_hal_http_request_t* request,
                                       mcp_hal_http_response_t* response,
                                       void* user_data);
 
+// Per event-loop statistics (one entry per shard, see http_server_start_sharded)
+typedef struct {
+    int shard;                      // Shard index
+    int cpu;                        // CPU the loop thread is pinned to (-1: not pinned)
+    uint64_t connections_accepted;
+    uint64_t connections_active;
+    uint64_t requests;
+    uint64_t responses_sent;
+    uint64_t bytes_sent;
+    uint64_t wakeups;
+} mcp_hal_shard_stats_t;
+
 // HAL network interface - generic network abstraction interface
 // Note: Uses generic names, underlying can be mongoose, lwIP, or other network libraries
 typedef struct {
@@ -140,12 +155,38 @@ typedef struct {
     mcp_hal_server_t (*http_server_start)(const char* url, mcp_hal_http_handler_t handler, void* user_data);
     int (*http_response_send)(mcp_hal_connection_t conn, const mcp_hal_http_response_t* response);
 
+    // Start shard_count independent event loops listening on the same address
+    // (SO_REUSEPORT), each running on its own thread pinned to a core. The handler
+    // is called concurrently from the loop threads. network_poll then only waits
+    // for network_wakeup. Optional (NULL: only the single-loop server is available).
+    mcp_hal_server_t (*http_server_start_sharded)(const char* url, int shard_count,
+                                                  mcp_hal_http_handler_t handler, void* user_data);
+
+    // Thread-safe deferred reply: may be called from any thread, the response is copied
+    // and sent from the polling thread. Replies to closed connections are dropped.
+    // Optional (NULL if the platform cannot hand responses across threads).
+    int (*http_response_post)(unsigned long connection_id, const mcp_hal_http_response_t* response);
+
     // Network event polling - generic interface names
     int (*network_poll)(int timeout_ms);
 
+    // Wake a blocked network_poll early. Must be safe to call from any thread and
+    // from signal handlers. Optional (NULL: callers fall back to short poll timeouts).
+    int (*network_wakeup)(void);
+
     // Server management - generic interface names
     int (*http_server_stop)(mcp_hal_server_t server);
 
+    // Largest request body to accept (0: platform default). Larger requests are answered
+    // with 413 before their body is buffered. Call before starting the server. Returns -1
+    // if the platform cannot buffer that much; the limit is then capped at what it can.
+    // Optional.
+    int (*http_set_max_body_size)(size_t max_size);
+
+    // Snapshot of per-loop counters. Returns the number of entries written, or -1.
+    // Optional.
+    int (*network_get_shard_stats)(mcp_hal_shard_stats_t* stats, int max_shards);
+
     // Low-level network interface (for platforms that don't support high-level HTTP libraries)
     int (*socket_create)(int domain, int type, int protocol);
     int (*socket_bind)(int sockfd, const char* address, uint16_t port);
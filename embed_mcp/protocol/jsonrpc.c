@@ -1,6 +1,7 @@
 #include "protocol/jsonrpc.h"
 #include "hal/platform_hal.h"
 #include "hal/hal_common.h"
+#include "utils/atomic.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -45,15 +46,15 @@ mcp_message_t *jsonrpc_parse_message(jsonrpc_parser_t *parser, const char *json_
     
     size_t data_len = strlen(json_data);
     if (data_len > parser->config.max_message_size) {
-        parser->parse_errors++;
+        MCP_ATOMIC_INC(&parser->parse_errors);
         return NULL;
     }
     
     mcp_message_t *message = mcp_message_parse(json_data);
     if (message) {
-        parser->messages_parsed++;
+        MCP_ATOMIC_INC(&parser->messages_parsed);
     } else {
-        parser->parse_errors++;
+        MCP_ATOMIC_INC(&parser->parse_errors);
     }
     
     return message;
@@ -89,87 +90,139 @@ mcp_response_t *jsonrpc_parse_response(jsonrpc_parser_t *parser, const char *jso
     return response;
 }
 
-// Message serialization functions
-char *jsonrpc_serialize_message(const mcp_message_t *message) {
-    return mcp_message_serialize(message);
-}
+cJSON *jsonrpc_parse_document(jsonrpc_parser_t *parser, const char *json_data, size_t length) {
+    if (!parser || !json_data) return NULL;
 
-char *jsonrpc_serialize_request(const mcp_request_t *request) {
-    if (!request || !mcp_request_validate(request)) return NULL;
-    
-    cJSON *json = cJSON_CreateObject();
-    if (!json) return NULL;
-    
-    cJSON_AddStringToObject(json, JSONRPC_FIELD_JSONRPC, request->jsonrpc ? request->jsonrpc : JSONRPC_VERSION);
-    
-    if (request->id) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_ID, cJSON_Duplicate(request->id, 1));
+    if (length > parser->config.max_message_size) {
+        MCP_ATOMIC_INC(&parser->parse_errors);
+        return NULL;
     }
-    
-    cJSON_AddStringToObject(json, JSONRPC_FIELD_METHOD, request->method);
-    
-    if (request->params) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_PARAMS, cJSON_Duplicate(request->params, 1));
+
+    cJSON *document = cJSON_ParseWithLength(json_data, length);
+    if (!document) {
+        MCP_ATOMIC_INC(&parser->parse_errors);
     }
-    
-    char *json_string = cJSON_Print(json);
-    cJSON_Delete(json);
-    
-    return json_string;
+
+    return document;
 }
 
-char *jsonrpc_serialize_response(const mcp_response_t *response) {
-    if (!response || !mcp_response_validate(response)) return NULL;
-    
-    cJSON *json = cJSON_CreateObject();
-    if (!json) return NULL;
-    
-    cJSON_AddStringToObject(json, JSONRPC_FIELD_JSONRPC, response->jsonrpc ? response->jsonrpc : JSONRPC_VERSION);
-    
-    if (response->id) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_ID, cJSON_Duplicate(response->id, 1));
+int jsonrpc_message_view(jsonrpc_parser_t *parser, const cJSON *document, mcp_message_t *view) {
+    if (!parser || !document || !view) return -1;
+
+    if (mcp_message_view_init(view, document) != 0) {
+        MCP_ATOMIC_INC(&parser->parse_errors);
+        return -1;
     }
-    
-    if (response->result) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_RESULT, cJSON_Duplicate(response->result, 1));
+
+    MCP_ATOMIC_INC(&parser->messages_parsed);
+    return 0;
+}
+
+// Message serialization functions
+int jsonrpc_render_request(const mcp_request_t *request, bool formatted, mcp_json_buffer_t *buffer) {
+    if (!request || !mcp_request_validate(request)) return -1;
+
+    mcp_message_t view = {
+        .type = request->is_notification ? MCP_MESSAGE_NOTIFICATION : MCP_MESSAGE_REQUEST,
+        .jsonrpc = JSONRPC_VERSION,
+        .id = request->id,
+        .method = request->method,
+        .params = request->params
+    };
+
+    return mcp_message_render(&view, formatted, buffer);
+}
+
+int jsonrpc_render_response(const mcp_response_t *response, bool formatted, mcp_json_buffer_t *buffer) {
+    if (!response || !mcp_response_validate(response)) return -1;
+
+    mcp_message_t view = {
+        .type = response->error ? MCP_MESSAGE_ERROR : MCP_MESSAGE_RESPONSE,
+        .jsonrpc = JSONRPC_VERSION,
+        .id = response->id,
+        .result = response->result,
+        .error = response->error
+    };
+
+    return mcp_message_render(&view, formatted, buffer);
+}
+
+int jsonrpc_render_error(cJSON *id, int code, const char *message, cJSON *data,
+                         bool formatted, mcp_json_buffer_t *buffer) {
+    // Error object and null id live on the stack; data is borrowed
+    cJSON null_id;
+    cJSON error_obj;
+    cJSON fields[3];
+    memset(&null_id, 0, sizeof(null_id));
+    memset(&error_obj, 0, sizeof(error_obj));
+    memset(fields, 0, sizeof(fields));
+    null_id.type = cJSON_NULL;
+    error_obj.type = cJSON_Object;
+
+    fields[0].type = cJSON_Number | cJSON_StringIsConst;
+    fields[0].string = JSONRPC_FIELD_ERROR_CODE;
+    fields[0].valueint = code;
+    fields[0].valuedouble = code;
+
+    fields[1].type = cJSON_String | cJSON_StringIsConst;
+    fields[1].string = JSONRPC_FIELD_ERROR_MESSAGE;
+    fields[1].valuestring = (char*)(message ? message : "Unknown error");
+
+    error_obj.child = &fields[0];
+    fields[0].next = &fields[1];
+    fields[1].prev = &fields[0];
+    fields[0].prev = &fields[1];
+
+    if (data) {
+        fields[2] = *data;
+        fields[2].type |= cJSON_StringIsConst;
+        fields[2].string = JSONRPC_FIELD_ERROR_DATA;
+        fields[2].next = NULL;
+        fields[2].prev = &fields[1];
+        fields[1].next = &fields[2];
+        fields[0].prev = &fields[2];
     }
-    
-    if (response->error) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_ERROR, cJSON_Duplicate(response->error, 1));
+
+    mcp_message_t view = {
+        .type = MCP_MESSAGE_ERROR,
+        .jsonrpc = JSONRPC_VERSION,
+        .id = id ? id : &null_id,
+        .error = &error_obj
+    };
+
+    return mcp_message_render(&view, formatted, buffer);
+}
+
+// Copy the calling thread's rendering into a caller-owned string
+static char *jsonrpc_take_thread_buffer(mcp_json_buffer_t *buffer) {
+    char *json_string = malloc(buffer->length + 1);
+    if (json_string) {
+        memcpy(json_string, buffer->data, buffer->length + 1);
     }
-    
-    char *json_string = cJSON_Print(json);
-    cJSON_Delete(json);
-    
+    mcp_json_buffer_trim(buffer);
     return json_string;
 }
 
+char *jsonrpc_serialize_message(const mcp_message_t *message) {
+    return mcp_message_serialize(message);
+}
+
+char *jsonrpc_serialize_request(const mcp_request_t *request) {
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_request(request, false, buffer) != 0) return NULL;
+    return jsonrpc_take_thread_buffer(buffer);
+}
+
+char *jsonrpc_serialize_response(const mcp_response_t *response) {
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_response(response, false, buffer) != 0) return NULL;
+    return jsonrpc_take_thread_buffer(buffer);
+}
+
 char *jsonrpc_serialize_error(cJSON *id, int code, const char *message, cJSON *data) {
-    cJSON *json = cJSON_CreateObject();
-    if (!json) return NULL;
-    
-    cJSON_AddStringToObject(json, JSONRPC_FIELD_JSONRPC, JSONRPC_VERSION);
-    
-    if (id) {
-        cJSON_AddItemToObject(json, JSONRPC_FIELD_ID, cJSON_Duplicate(id, 1));
-    } else {
-        cJSON_AddNullToObject(json, JSONRPC_FIELD_ID);
-    }
-    
-    cJSON *error_obj = cJSON_CreateObject();
-    cJSON_AddNumberToObject(error_obj, JSONRPC_FIELD_ERROR_CODE, code);
-    cJSON_AddStringToObject(error_obj, JSONRPC_FIELD_ERROR_MESSAGE, message ? message : "Unknown error");
-    
-    if (data) {
-        cJSON_AddItemToObject(error_obj, JSONRPC_FIELD_ERROR_DATA, cJSON_Duplicate(data, 1));
-    }
-    
-    cJSON_AddItemToObject(json, JSONRPC_FIELD_ERROR, error_obj);
-    
-    char *json_string = cJSON_Print(json);
-    cJSON_Delete(json);
-    
-    return json_string;
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_error(id, code, message, data, false, buffer) != 0) return NULL;
+    return jsonrpc_take_thread_buffer(buffer);
 }
 
 // Validation functions
@@ -343,6 +396,92 @@ char *jsonrpc_create_error_response(cJSON *id, int code, const char *message, cJ
     return jsonrpc_serialize_error(id, code, message, data);
 }
 
+// Batch processing
+jsonrpc_batch_t *jsonrpc_batch_create(void) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    jsonrpc_batch_t *batch = hal->memory.alloc(sizeof(jsonrpc_batch_t));
+    if (!batch) return NULL;
+    memset(batch, 0, sizeof(jsonrpc_batch_t));
+
+    return batch;
+}
+
+void jsonrpc_batch_destroy(jsonrpc_batch_t *batch) {
+    if (!batch) return;
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        mcp_message_destroy(batch->messages[i]);
+    }
+    hal_free(hal, batch->messages);
+    hal->memory.free(batch);
+}
+
+int jsonrpc_batch_add_message(jsonrpc_batch_t *batch, mcp_message_t *message) {
+    if (!batch || !message) return -1;
+
+    if (batch->count == batch->capacity) {
+        const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+        if (!hal) return -1;
+
+        size_t capacity = batch->capacity > 0 ? batch->capacity * 2 : 8;
+        mcp_message_t **messages = hal->memory.realloc(batch->messages, capacity * sizeof(mcp_message_t*));
+        if (!messages) return -1;
+        batch->messages = messages;
+        batch->capacity = capacity;
+    }
+
+    batch->messages[batch->count++] = message;
+    return 0;
+}
+
+int jsonrpc_render_batch(const mcp_message_t *const *messages, size_t count, bool formatted,
+                         mcp_json_buffer_t *buffer) {
+    return mcp_message_render_array(messages, count, formatted, buffer);
+}
+
+char *jsonrpc_batch_serialize(const jsonrpc_batch_t *batch) {
+    if (!batch) return NULL;
+
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_batch((const mcp_message_t *const *)batch->messages, batch->count,
+                                        false, buffer) != 0) {
+        return NULL;
+    }
+    return jsonrpc_take_thread_buffer(buffer);
+}
+
+jsonrpc_batch_t *jsonrpc_batch_parse(jsonrpc_parser_t *parser, const char *json_data) {
+    if (!parser || !json_data) return NULL;
+
+    cJSON *document = jsonrpc_parse_document(parser, json_data, strlen(json_data));
+    if (!cJSON_IsArray(document) || !document->child) {
+        cJSON_Delete(document);
+        return NULL;
+    }
+
+    jsonrpc_batch_t *batch = jsonrpc_batch_create();
+    for (cJSON *element = document->child; batch && element; element = element->next) {
+        mcp_message_t *message = mcp_message_from_json(element);
+        if (!message || jsonrpc_batch_add_message(batch, message) != 0) {
+            mcp_message_destroy(message);
+            jsonrpc_batch_destroy(batch);
+            batch = NULL;
+        }
+    }
+
+    if (batch) {
+        MCP_ATOMIC_ADD(&parser->messages_parsed, batch->count);
+    } else {
+        MCP_ATOMIC_INC(&parser->parse_errors);
+    }
+    cJSON_Delete(document);
+    return batch;
+}
+
 // Configuration helpers
 jsonrpc_parser_config_t *jsonrpc_config_create_default(void) {
     const mcp_platform_hal_t *hal = mcp_platform_get_hal();
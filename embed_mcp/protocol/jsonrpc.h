@@ -39,7 +39,18 @@ mcp_message_t *jsonrpc_parse_message(jsonrpc_parser_t *parser, const char *json_
 mcp_request_t *jsonrpc_parse_request(jsonrpc_parser_t *parser, const char *json_data);
 mcp_response_t *jsonrpc_parse_response(jsonrpc_parser_t *parser, const char *json_data);
 
-// Message serialization functions
+// Single-pass parsing: parse the raw data once, then build borrowed views over the document
+cJSON *jsonrpc_parse_document(jsonrpc_parser_t *parser, const char *json_data, size_t length);
+int jsonrpc_message_view(jsonrpc_parser_t *parser, const cJSON *document, mcp_message_t *view);
+
+// Message rendering into a reusable buffer (compact unless formatted is set).
+// buffer->data holds the result until the buffer is used again.
+int jsonrpc_render_request(const mcp_request_t *request, bool formatted, mcp_json_buffer_t *buffer);
+int jsonrpc_render_response(const mcp_response_t *response, bool formatted, mcp_json_buffer_t *buffer);
+int jsonrpc_render_error(cJSON *id, int code, const char *message, cJSON *data,
+                         bool formatted, mcp_json_buffer_t *buffer);
+
+// Message serialization functions - compact JSON strings, free with free()
 char *jsonrpc_serialize_message(const mcp_message_t *message);
 char *jsonrpc_serialize_request(const mcp_request_t *request);
 char *jsonrpc_serialize_response(const mcp_response_t *response);
@@ -66,7 +77,7 @@ char *jsonrpc_id_to_string(const cJSON *id);
 cJSON *jsonrpc_create_error_object(int code, const char *message, cJSON *data);
 char *jsonrpc_create_error_response(cJSON *id, int code, const char *message, cJSON *data);
 
-// Batch processing (for future extension)
+// Batch processing: a JSON array of messages
 typedef struct {
     mcp_message_t **messages;
     size_t count;
@@ -75,9 +86,14 @@ typedef struct {
 
 jsonrpc_batch_t *jsonrpc_batch_create(void);
 void jsonrpc_batch_destroy(jsonrpc_batch_t *batch);
+// The batch takes ownership of the message
 int jsonrpc_batch_add_message(jsonrpc_batch_t *batch, mcp_message_t *message);
 char *jsonrpc_batch_serialize(const jsonrpc_batch_t *batch);
+// NULL unless json_data is a non-empty array of valid messages
 jsonrpc_batch_t *jsonrpc_batch_parse(jsonrpc_parser_t *parser, const char *json_data);
+// Render messages (e.g. borrowed views) as one array into buffer, in a single pass
+int jsonrpc_render_batch(const mcp_message_t *const *messages, size_t count, bool formatted,
+                         mcp_json_buffer_t *buffer);
 
 // Configuration helpers
 jsonrpc_parser_config_t *jsonrpc_config_create_default(void);
@@ -5,6 +5,15 @@
 #include <string.h>
 #include <stdio.h>
 
+// Only its address is used
+cJSON mcp_protocol_deferred_response;
+
+// Marks a handler result as an error object: set as its (constant) key, which a
+// top-level result never has
+static const char protocol_error_tag[] = "error";
+
+static int mcp_protocol_send_buffer(mcp_protocol_t *protocol, mcp_json_buffer_t *buffer);
+
 // Protocol lifecycle
 mcp_protocol_t *mcp_protocol_create(const mcp_protocol_config_t *config) {
     const mcp_platform_hal_t *hal = mcp_platform_get_hal();
@@ -192,14 +201,44 @@ void mcp_protocol_set_request_handler(mcp_protocol_t *protocol,
     protocol->user_data = user_data;
 }
 
+void mcp_protocol_set_notification_handler(mcp_protocol_t *protocol,
+                                          mcp_notification_handler_t handler, void *user_data) {
+    if (!protocol) return;
+    
+    protocol->notification_handler = handler;
+    protocol->user_data = user_data;
+}
+
+void mcp_protocol_set_batch_handler(mcp_protocol_t *protocol,
+                                   mcp_batch_handler_t handler, void *user_data) {
+    if (!protocol) return;
+    
+    protocol->batch_handler = handler;
+    protocol->user_data = user_data;
+}
+
 // Message handling
 int mcp_protocol_handle_message(mcp_protocol_t *protocol, const char *json_data) {
     if (!protocol || !json_data) return -1;
+
+    cJSON *document = jsonrpc_parse_document(protocol->parser, json_data, strlen(json_data));
+    int result = mcp_protocol_handle_document(protocol, document);
+    cJSON_Delete(document);
+
+    return result;
+}
+
+int mcp_protocol_handle_document(mcp_protocol_t *protocol, const cJSON *document) {
+    if (!protocol) return -1;
+    
+    if (cJSON_IsArray(document)) {
+        return mcp_protocol_handle_batch(protocol, document);
+    }
     
     protocol->last_activity = time(NULL);
     
-    mcp_message_t *message = jsonrpc_parse_message(protocol->parser, json_data);
-    if (!message) {
+    mcp_message_t message;
+    if (!document || jsonrpc_message_view(protocol->parser, document, &message) != 0) {
         if (protocol->error_callback) {
             protocol->error_callback(JSONRPC_PARSE_ERROR, "Failed to parse JSON-RPC message", protocol->user_data);
         }
@@ -208,48 +247,107 @@ int mcp_protocol_handle_message(mcp_protocol_t *protocol, const char *json_data)
     
     int result = 0;
     
-    switch (message->type) {
-        case MCP_MESSAGE_REQUEST: {
-            mcp_request_t *request = mcp_message_to_request(message);
-            if (request) {
-                result = mcp_protocol_handle_request(protocol, request);
-                mcp_request_destroy(request);
-            } else {
-                result = mcp_protocol_send_invalid_request_error(protocol, message->id);
-            }
-            break;
-        }
-        
+    // Requests and responses are borrowed views over the document - nothing is copied
+    switch (message.type) {
+        case MCP_MESSAGE_REQUEST:
         case MCP_MESSAGE_NOTIFICATION: {
-            mcp_request_t *notification = mcp_message_to_request(message);
-            if (notification) {
-                result = mcp_protocol_handle_notification(protocol, notification);
-                mcp_request_destroy(notification);
+            mcp_request_t request = {
+                .jsonrpc = message.jsonrpc,
+                .id = message.id,
+                .method = message.method,
+                .params = message.params,
+                .is_notification = (message.type == MCP_MESSAGE_NOTIFICATION)
+            };
+            if (request.is_notification) {
+                result = mcp_protocol_handle_notification(protocol, &request);
+            } else {
+                result = mcp_protocol_handle_request(protocol, &request);
             }
             break;
         }
         
         case MCP_MESSAGE_RESPONSE:
         case MCP_MESSAGE_ERROR: {
-            mcp_response_t *response = mcp_message_to_response(message);
-            if (response) {
-                result = mcp_protocol_handle_response(protocol, response);
-                mcp_response_destroy(response);
-            }
+            mcp_response_t response = {
+                .jsonrpc = message.jsonrpc,
+                .id = message.id,
+                .result = message.result,
+                .error = message.error
+            };
+            result = mcp_protocol_handle_response(protocol, &response);
             break;
         }
         
         default:
-            result = mcp_protocol_send_invalid_request_error(protocol, message->id);
+            result = mcp_protocol_send_invalid_request_error(protocol, message.id);
             break;
     }
     
-    mcp_message_destroy(message);
     return result;
 }
 
-int mcp_protocol_handle_request(mcp_protocol_t *protocol, const mcp_request_t *request) {
-    if (!protocol || !request) return -1;
+// Error object; detail (optional) goes into the error data under detail_key
+static cJSON *protocol_error_object(int code, const char *message,
+                                    const char *detail_key, const char *detail) {
+    cJSON *error = jsonrpc_create_error_object(code, message, NULL);
+    if (error && detail) {
+        cJSON *data = cJSON_AddObjectToObject(error, JSONRPC_FIELD_ERROR_DATA);
+        cJSON_AddStringToObject(data, detail_key, detail);
+    }
+    return error;
+}
+
+static void protocol_error_reply(mcp_message_t *reply, cJSON *id, int code, const char *message,
+                                 const char *detail_key, const char *detail) {
+    memset(reply, 0, sizeof(mcp_message_t));
+    reply->type = MCP_MESSAGE_ERROR;
+    reply->jsonrpc = (char*)JSONRPC_VERSION;
+    reply->id = id;
+    reply->error = protocol_error_object(code, message, detail_key, detail);
+}
+
+cJSON *mcp_protocol_create_error_result(int code, const char *message,
+                                        const char *detail_key, const char *detail) {
+    cJSON *error = protocol_error_object(code, message, detail_key, detail);
+    if (error) {
+        error->string = (char*)protocol_error_tag;
+        error->type |= cJSON_StringIsConst;
+    }
+    return error;
+}
+
+int mcp_protocol_answer_with_result(mcp_protocol_t *protocol, const mcp_request_t *request,
+                                    cJSON *result, mcp_message_t *reply) {
+    if (!protocol || !request || !reply) return -1;
+
+    if (result == MCP_PROTOCOL_RESPONSE_DEFERRED) {
+        memset(reply, 0, sizeof(mcp_message_t));
+        return 1;
+    }
+    if (!result) {
+        protocol_error_reply(reply, request->id, JSONRPC_INTERNAL_ERROR, "Internal error",
+                             "details", "Request handler returned null");
+        return 0;
+    }
+
+    memset(reply, 0, sizeof(mcp_message_t));
+    reply->jsonrpc = (char*)JSONRPC_VERSION;
+    reply->id = request->id;
+    if (result->string == protocol_error_tag) {
+        result->string = NULL;
+        result->type &= ~cJSON_StringIsConst;
+        reply->type = MCP_MESSAGE_ERROR;
+        reply->error = result;
+    } else {
+        reply->type = MCP_MESSAGE_RESPONSE;
+        reply->result = result;
+    }
+    return 0;
+}
+
+int mcp_protocol_answer_request(mcp_protocol_t *protocol, const mcp_request_t *request,
+                                mcp_message_t *reply) {
+    if (!protocol || !request || !reply) return -1;
 
     cJSON *result = NULL;
 
@@ -262,16 +360,151 @@ int mcp_protocol_handle_request(mcp_protocol_t *protocol, const mcp_request_t *r
         // Delegate to application-level handler (tools/list, tools/call, etc.)
         result = protocol->request_handler(request, protocol->user_data);
     } else {
-        return mcp_protocol_send_method_not_found_error(protocol, request->id, request->method);
+        protocol_error_reply(reply, request->id, JSONRPC_METHOD_NOT_FOUND, "Method not found",
+                             "method", request->method);
+        return 0;
     }
 
-    if (result) {
-        int send_result = mcp_protocol_send_response(protocol, request->id, result);
-        cJSON_Delete(result);
-        return send_result;
-    } else {
-        return mcp_protocol_send_internal_error(protocol, request->id, "Request handler returned null");
+    return mcp_protocol_answer_with_result(protocol, request, result, reply);
+}
+
+void mcp_protocol_reply_clear(mcp_message_t *reply) {
+    if (!reply) return;
+
+    cJSON_Delete(reply->result);
+    cJSON_Delete(reply->error);
+    memset(reply, 0, sizeof(mcp_message_t));
+}
+
+int mcp_protocol_handle_request(mcp_protocol_t *protocol, const mcp_request_t *request) {
+    if (!protocol || !request) return -1;
+
+    mcp_message_t reply;
+    if (mcp_protocol_answer_request(protocol, request, &reply) != 0) {
+        return 0;
+    }
+    
+    int send_result = -1;
+    if (reply.result || reply.error) {
+        mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+        if (protocol->send_callback && buffer &&
+            mcp_message_render(&reply, protocol->config->pretty_json, buffer) == 0) {
+            send_result = mcp_protocol_send_buffer(protocol, buffer);
+        }
     }
+    mcp_protocol_reply_clear(&reply);
+    return send_result;
+}
+
+int mcp_protocol_handle_batch(mcp_protocol_t *protocol, const cJSON *batch) {
+    if (!protocol || !cJSON_IsArray(batch)) return -1;
+    
+    protocol->last_activity = time(NULL);
+    
+    size_t count = (size_t)cJSON_GetArraySize(batch);
+    if (count == 0) {
+        return mcp_protocol_send_invalid_request_error(protocol, NULL);
+    }
+    
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return -1;
+    
+    // Replies in element order, the requests with their own replies for the batch
+    // handler, where those go, and the replies to render
+    size_t block_size = count * (2 * sizeof(mcp_message_t) + sizeof(mcp_request_t) +
+                                 sizeof(size_t) + sizeof(mcp_message_t*));
+    unsigned char *block = hal->memory.alloc(block_size);
+    if (!block) {
+        return mcp_protocol_send_internal_error(protocol, NULL, "Out of memory");
+    }
+    memset(block, 0, block_size);
+    mcp_message_t *replies = (mcp_message_t*)block;
+    mcp_message_t *answers = replies + count;
+    mcp_request_t *requests = (mcp_request_t*)(answers + count);
+    size_t *positions = (size_t*)(requests + count);
+    const mcp_message_t **rendered = (const mcp_message_t**)(positions + count);
+    
+    cJSON null_id;
+    memset(&null_id, 0, sizeof(null_id));
+    null_id.type = cJSON_NULL;
+    
+    // Notifications and responses are handled right away, in order
+    size_t request_count = 0;
+    size_t index = 0;
+    for (const cJSON *element = batch->child; element; element = element->next, index++) {
+        mcp_message_t message;
+        if (jsonrpc_message_view(protocol->parser, element, &message) != 0) {
+            cJSON *id = cJSON_IsObject(element) ? cJSON_GetObjectItem(element, JSONRPC_FIELD_ID) : NULL;
+            if (!cJSON_IsString(id) && !cJSON_IsNumber(id)) {
+                id = &null_id;
+            }
+            protocol_error_reply(&replies[index], id, JSONRPC_INVALID_REQUEST, "Invalid request", NULL, NULL);
+            continue;
+        }
+        
+        if (message.type == MCP_MESSAGE_REQUEST || message.type == MCP_MESSAGE_NOTIFICATION) {
+            mcp_request_t request = {
+                .jsonrpc = message.jsonrpc,
+                .id = message.id,
+                .method = message.method,
+                .params = message.params,
+                .is_notification = (message.type == MCP_MESSAGE_NOTIFICATION),
+                .in_batch = true
+            };
+            if (request.is_notification) {
+                mcp_protocol_handle_notification(protocol, &request);
+            } else {
+                requests[request_count] = request;
+                positions[request_count++] = index;
+            }
+        } else {
+            mcp_response_t response = {
+                .jsonrpc = message.jsonrpc,
+                .id = message.id,
+                .result = message.result,
+                .error = message.error
+            };
+            mcp_protocol_handle_response(protocol, &response);
+        }
+    }
+    
+    if (request_count > 0) {
+        if (protocol->batch_handler) {
+            protocol->batch_handler(protocol, requests, request_count, answers, protocol->user_data);
+        } else {
+            for (size_t i = 0; i < request_count; i++) {
+                mcp_protocol_answer_request(protocol, &requests[i], &answers[i]);
+            }
+        }
+        for (size_t i = 0; i < request_count; i++) {
+            replies[positions[i]] = answers[i];
+        }
+    }
+    
+    size_t rendered_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (replies[i].result || replies[i].error) {
+            rendered[rendered_count++] = &replies[i];
+        }
+    }
+    
+    int result = 0;
+    if (rendered_count > 0) {
+        mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+        if (!protocol->send_callback || !buffer ||
+            jsonrpc_render_batch(rendered, rendered_count, protocol->config->pretty_json, buffer) != 0) {
+            result = -1;
+        } else {
+            result = mcp_protocol_send_buffer(protocol, buffer);
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        mcp_protocol_reply_clear(&replies[i]);
+    }
+    hal->memory.free(block);
+    
+    return result;
 }
 
 int mcp_protocol_handle_response(mcp_protocol_t *protocol, const mcp_response_t *response) {
@@ -295,15 +528,28 @@ int mcp_protocol_handle_notification(mcp_protocol_t *protocol, const mcp_request
         return mcp_protocol_handle_initialized(protocol, notification);
     }
     
-    // For other notifications, just log them for now
     if (protocol->config->enable_logging) {
         fprintf(stderr, "Received notification: %s\n", notification->method);
     }
     
+    // Others (e.g. notifications/cancelled) go to the application; notifications never
+    // get a response, so there is nothing to report back
+    if (protocol->notification_handler) {
+        protocol->notification_handler(notification, protocol->user_data);
+    }
+    
     return 0;
 }
 
 // Message sending
+// Outgoing messages are rendered into the calling thread's reusable buffer;
+// the transport copies what it needs before send_callback returns.
+static int mcp_protocol_send_buffer(mcp_protocol_t *protocol, mcp_json_buffer_t *buffer) {
+    int send_result = protocol->send_callback(buffer->data, buffer->length, protocol->user_data);
+    mcp_json_buffer_trim(buffer);
+    return send_result;
+}
+
 int mcp_protocol_send_response(mcp_protocol_t *protocol, cJSON *id, cJSON *result) {
     if (!protocol || !protocol->send_callback) return -1;
     
@@ -314,26 +560,25 @@ int mcp_protocol_send_response(mcp_protocol_t *protocol, cJSON *id, cJSON *resul
         .error = NULL
     };
     
-    char *json_str = jsonrpc_serialize_response(&response);
-    if (!json_str) return -1;
-    
-    int send_result = protocol->send_callback(json_str, strlen(json_str), protocol->user_data);
-    free(json_str);
-    
-    return send_result;
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_response(&response, protocol->config->pretty_json, buffer) != 0) {
+        return -1;
+    }
+
+    return mcp_protocol_send_buffer(protocol, buffer);
 }
 
 int mcp_protocol_send_error_response(mcp_protocol_t *protocol, cJSON *id, 
                                     int code, const char *message, cJSON *data) {
     if (!protocol || !protocol->send_callback) return -1;
     
-    char *json_str = jsonrpc_serialize_error(id, code, message, data);
-    if (!json_str) return -1;
-    
-    int send_result = protocol->send_callback(json_str, strlen(json_str), protocol->user_data);
-    free(json_str);
-    
-    return send_result;
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_error(id, code, message, data,
+                                        protocol->config->pretty_json, buffer) != 0) {
+        return -1;
+    }
+
+    return mcp_protocol_send_buffer(protocol, buffer);
 }
 
 int mcp_protocol_send_request(mcp_protocol_t *protocol, cJSON *id,
@@ -348,11 +593,12 @@ int mcp_protocol_send_request(mcp_protocol_t *protocol, cJSON *id,
         .is_notification = false
     };
 
-    char *json_str = jsonrpc_serialize_request(&request);
-    if (!json_str) return -1;
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_request(&request, protocol->config->pretty_json, buffer) != 0) {
+        return -1;
+    }
 
-    int send_result = protocol->send_callback(json_str, strlen(json_str), protocol->user_data);
-    free(json_str);
+    int send_result = mcp_protocol_send_buffer(protocol, buffer);
 
     if (send_result == 0) {
         protocol->pending_requests++;
@@ -523,11 +769,10 @@ int mcp_protocol_send_notification(mcp_protocol_t *protocol, const char *method,
         .is_notification = true
     };
     
-    char *json_str = jsonrpc_serialize_request(&notification);
-    if (!json_str) return -1;
-    
-    int send_result = protocol->send_callback(json_str, strlen(json_str), protocol->user_data);
-    free(json_str);
-    
-    return send_result;
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || jsonrpc_render_request(&notification, protocol->config->pretty_json, buffer) != 0) {
+        return -1;
+    }
+
+    return mcp_protocol_send_buffer(protocol, buffer);
 }
@@ -14,6 +14,8 @@ typedef struct mcp_protocol mcp_protocol_t;
 // MCP Method Names
 #define MCP_METHOD_INITIALIZE "initialize"
 #define MCP_METHOD_INITIALIZED "notifications/initialized"
+#define MCP_METHOD_CANCELLED "notifications/cancelled"
+#define MCP_METHOD_PROGRESS "notifications/progress"
 #define MCP_METHOD_PING "ping"
 #define MCP_METHOD_LIST_TOOLS "tools/list"
 #define MCP_METHOD_CALL_TOOL "tools/call"
@@ -31,11 +33,30 @@ typedef void (*mcp_state_change_callback_t)(mcp_protocol_state_t old_state,
 
 // Request handler callback
 typedef cJSON *(*mcp_request_handler_t)(const mcp_request_t *request, void *user_data);
+// Notification handler callback, for notifications the protocol does not handle itself
+typedef void (*mcp_notification_handler_t)(const mcp_request_t *notification, void *user_data);
+
+// Batch handler: answers the requests of one JSON-RPC batch at once, filling replies[i]
+// for requests[i] (see mcp_protocol_answer_request()); replies left empty are not sent.
+// The requests are borrowed from the batch document for the duration of the call.
+typedef void (*mcp_batch_handler_t)(mcp_protocol_t *protocol, const mcp_request_t *requests,
+                                    size_t count, mcp_message_t *replies, void *user_data);
+
+// Returned by a request handler that sends the response itself later (e.g. when an
+// async tool completes); nothing is sent for the request now
+extern cJSON mcp_protocol_deferred_response;
+#define MCP_PROTOCOL_RESPONSE_DEFERRED (&mcp_protocol_deferred_response)
+
+// Returned by a request handler to answer with a JSON-RPC error instead of a result.
+// detail (optional) goes into the error data under detail_key. NULL if out of memory.
+cJSON *mcp_protocol_create_error_result(int code, const char *message,
+                                        const char *detail_key, const char *detail);
 
 // Protocol configuration
 typedef struct {
     bool strict_mode;           // Enforce strict protocol compliance
     bool enable_logging;        // Enable protocol-level logging
+    bool pretty_json;           // Indent outgoing JSON for debugging (compact by default)
     size_t max_message_size;    // Maximum message size
     size_t max_pending_requests; // Maximum pending requests
     time_t request_timeout;     // Request timeout in seconds
@@ -65,6 +86,8 @@ struct mcp_protocol {
     mcp_error_callback_t error_callback;
     mcp_state_change_callback_t state_change_callback;
     mcp_request_handler_t request_handler;
+    mcp_notification_handler_t notification_handler;
+    mcp_batch_handler_t batch_handler;      // NULL: batch requests are answered in order
     void *user_data;
     
     // Internal state
@@ -94,13 +117,36 @@ void mcp_protocol_set_state_change_callback(mcp_protocol_t *protocol,
                                            mcp_state_change_callback_t callback, void *user_data);
 void mcp_protocol_set_request_handler(mcp_protocol_t *protocol,
                                      mcp_request_handler_t handler, void *user_data);
+void mcp_protocol_set_notification_handler(mcp_protocol_t *protocol,
+                                          mcp_notification_handler_t handler, void *user_data);
+void mcp_protocol_set_batch_handler(mcp_protocol_t *protocol,
+                                   mcp_batch_handler_t handler, void *user_data);
 
 // Message handling
 int mcp_protocol_handle_message(mcp_protocol_t *protocol, const char *json_data);
+// Handle an already parsed message. The document is borrowed for the duration of the
+// call; request fields handed to the handlers point into it. NULL sends a parse error.
+// An array is handled as a batch.
+int mcp_protocol_handle_document(mcp_protocol_t *protocol, const cJSON *document);
+// Batch request: every element is handled on its own, and the responses go out together
+// as one array, rendered in a single pass. Notifications and responses get none; nothing
+// is sent if no element needs a response.
+int mcp_protocol_handle_batch(mcp_protocol_t *protocol, const cJSON *batch);
 int mcp_protocol_handle_request(mcp_protocol_t *protocol, const mcp_request_t *request);
 int mcp_protocol_handle_response(mcp_protocol_t *protocol, const mcp_response_t *response);
 int mcp_protocol_handle_notification(mcp_protocol_t *protocol, const mcp_request_t *notification);
 
+// Answer a request without sending anything: reply becomes its response or error
+// response, with the id borrowed from the request and the result or error owned by the
+// reply until mcp_protocol_reply_clear(). Returns 1 if the handler deferred the response
+// (reply stays empty), 0 otherwise.
+int mcp_protocol_answer_request(mcp_protocol_t *protocol, const mcp_request_t *request,
+                                mcp_message_t *reply);
+// Same with a result the application computed itself (taken over; NULL is an error)
+int mcp_protocol_answer_with_result(mcp_protocol_t *protocol, const mcp_request_t *request,
+                                    cJSON *result, mcp_message_t *reply);
+void mcp_protocol_reply_clear(mcp_message_t *reply);
+
 // Message sending
 int mcp_protocol_send_response(mcp_protocol_t *protocol, cJSON *id, cJSON *result);
 int mcp_protocol_send_error_response(mcp_protocol_t *protocol, cJSON *id, 
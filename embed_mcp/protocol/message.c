@@ -119,70 +119,78 @@ mcp_message_t *mcp_message_create_error_response(cJSON *id, int code, const char
 }
 
 // Message parsing
-mcp_message_t *mcp_message_parse(const char *json_data) {
-    if (!json_data) return NULL;
+int mcp_message_view_init(mcp_message_t *view, const cJSON *json) {
+    if (!view) return -1;
+    memset(view, 0, sizeof(mcp_message_t));
+    if (!json || !cJSON_IsObject(json)) return -1;
 
-    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
-    if (!hal) return NULL;
-    
-    cJSON *json = cJSON_Parse(json_data);
-    if (!json) return NULL;
-    
-    mcp_message_t *message = hal->memory.alloc(sizeof(mcp_message_t));
-    if (!message) {
-        cJSON_Delete(json);
-        return NULL;
-    }
-    memset(message, 0, sizeof(mcp_message_t));
-    
     // Parse jsonrpc field
     cJSON *jsonrpc = cJSON_GetObjectItem(json, "jsonrpc");
     if (jsonrpc && cJSON_IsString(jsonrpc)) {
-        message->jsonrpc = hal_strdup(hal, jsonrpc->valuestring);
-    }
-    
-    // Parse id field
-    cJSON *id = cJSON_GetObjectItem(json, "id");
-    if (id) {
-        message->id = cJSON_Duplicate(id, 1);
+        view->jsonrpc = jsonrpc->valuestring;
     }
-    
+
     // Parse method field
     cJSON *method = cJSON_GetObjectItem(json, "method");
     if (method && cJSON_IsString(method)) {
-        message->method = hal_strdup(hal, method->valuestring);
+        view->method = method->valuestring;
     }
-    
-    // Parse params field
-    cJSON *params = cJSON_GetObjectItem(json, "params");
-    if (params) {
-        message->params = cJSON_Duplicate(params, 1);
-    }
-    
-    // Parse result field
-    cJSON *result = cJSON_GetObjectItem(json, "result");
-    if (result) {
-        message->result = cJSON_Duplicate(result, 1);
-    }
-    
-    // Parse error field
-    cJSON *error = cJSON_GetObjectItem(json, "error");
-    if (error) {
-        message->error = cJSON_Duplicate(error, 1);
-    }
-    
+
+    view->id = cJSON_GetObjectItem(json, "id");
+    view->params = cJSON_GetObjectItem(json, "params");
+    view->result = cJSON_GetObjectItem(json, "result");
+    view->error = cJSON_GetObjectItem(json, "error");
+
     // Determine message type
-    if (message->method) {
-        message->type = message->id ? MCP_MESSAGE_REQUEST : MCP_MESSAGE_NOTIFICATION;
-    } else if (message->error) {
-        message->type = MCP_MESSAGE_ERROR;
+    if (view->method) {
+        view->type = view->id ? MCP_MESSAGE_REQUEST : MCP_MESSAGE_NOTIFICATION;
+    } else if (view->error) {
+        view->type = MCP_MESSAGE_ERROR;
     } else {
-        message->type = MCP_MESSAGE_RESPONSE;
+        view->type = MCP_MESSAGE_RESPONSE;
     }
-    
+
+    return mcp_message_validate(view) ? 0 : -1;
+}
+
+mcp_message_t *mcp_message_parse(const char *json_data) {
+    if (!json_data) return NULL;
+
+    cJSON *json = cJSON_Parse(json_data);
+    if (!json) return NULL;
+
+    mcp_message_t *message = mcp_message_from_json(json);
     cJSON_Delete(json);
+
+    return message;
+}
+
+mcp_message_t *mcp_message_from_json(cJSON *json) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    mcp_message_t view;
+    if (mcp_message_view_init(&view, json) != 0) {
+        return NULL;
+    }
     
-    if (!mcp_message_validate(message)) {
+    mcp_message_t *message = hal->memory.alloc(sizeof(mcp_message_t));
+    if (!message) {
+        return NULL;
+    }
+    memset(message, 0, sizeof(mcp_message_t));
+
+    message->type = view.type;
+    message->jsonrpc = hal_strdup(hal, view.jsonrpc);
+    message->method = view.method ? hal_strdup(hal, view.method) : NULL;
+
+    // Take the subtrees out of the parsed document instead of deep-copying them
+    if (view.id) message->id = cJSON_DetachItemViaPointer(json, view.id);
+    if (view.params) message->params = cJSON_DetachItemViaPointer(json, view.params);
+    if (view.result) message->result = cJSON_DetachItemViaPointer(json, view.result);
+    if (view.error) message->error = cJSON_DetachItemViaPointer(json, view.error);
+    
+    if (!message->jsonrpc || (view.method && !message->method)) {
         mcp_message_destroy(message);
         return NULL;
     }
@@ -191,43 +199,115 @@ mcp_message_t *mcp_message_parse(const char *json_data) {
 }
 
 // Message serialization
-char *mcp_message_serialize(const mcp_message_t *message) {
-    if (!message || !mcp_message_validate(message)) return NULL;
-    
-    cJSON *json = cJSON_CreateObject();
-    if (!json) return NULL;
-    
-    // Add jsonrpc field
-    cJSON_AddStringToObject(json, "jsonrpc", message->jsonrpc ? message->jsonrpc : "2.0");
-    
-    // Add id field (if present)
+// The envelope is assembled from stack nodes that borrow the message's
+// subtrees, so rendering neither duplicates the payload nor allocates nodes.
+static void envelope_add(cJSON *envelope, cJSON *node, const char *key) {
+    node->string = (char*)key;
+    node->type |= cJSON_StringIsConst;
+    node->next = NULL;
+    if (!envelope->child) {
+        envelope->child = node;
+        node->prev = node;
+    } else {
+        cJSON *last = envelope->child->prev;
+        last->next = node;
+        node->prev = last;
+        envelope->child->prev = node;
+    }
+}
+
+static void envelope_add_borrowed(cJSON *envelope, cJSON *node, const char *key, const cJSON *value) {
+    *node = *value;
+    envelope_add(envelope, node, key);
+}
+
+static void envelope_add_string(cJSON *envelope, cJSON *node, const char *key, const char *value) {
+    memset(node, 0, sizeof(cJSON));
+    node->type = cJSON_String;
+    node->valuestring = (char*)value;
+    envelope_add(envelope, node, key);
+}
+
+// Fill envelope with nodes taken from fields (MESSAGE_ENVELOPE_FIELDS of them)
+#define MESSAGE_ENVELOPE_FIELDS 6
+
+static void message_envelope(const mcp_message_t *message, cJSON *envelope, cJSON *fields) {
+    memset(envelope, 0, sizeof(cJSON));
+    envelope->type = cJSON_Object;
+
+    envelope_add_string(envelope, &fields[0], "jsonrpc", message->jsonrpc ? message->jsonrpc : "2.0");
     if (message->id) {
-        cJSON_AddItemToObject(json, "id", cJSON_Duplicate(message->id, 1));
+        envelope_add_borrowed(envelope, &fields[1], "id", message->id);
     }
-    
-    // Add method field (for requests and notifications)
     if (message->method) {
-        cJSON_AddStringToObject(json, "method", message->method);
+        envelope_add_string(envelope, &fields[2], "method", message->method);
     }
-    
-    // Add params field (if present)
     if (message->params) {
-        cJSON_AddItemToObject(json, "params", cJSON_Duplicate(message->params, 1));
+        envelope_add_borrowed(envelope, &fields[3], "params", message->params);
     }
-    
-    // Add result field (for successful responses)
     if (message->result) {
-        cJSON_AddItemToObject(json, "result", cJSON_Duplicate(message->result, 1));
+        envelope_add_borrowed(envelope, &fields[4], "result", message->result);
     }
-    
-    // Add error field (for error responses)
     if (message->error) {
-        cJSON_AddItemToObject(json, "error", cJSON_Duplicate(message->error, 1));
+        envelope_add_borrowed(envelope, &fields[5], "error", message->error);
     }
-    
-    char *json_string = cJSON_Print(json);
-    cJSON_Delete(json);
-    
+}
+
+int mcp_message_render(const mcp_message_t *message, bool formatted, mcp_json_buffer_t *buffer) {
+    if (!message || !buffer || !mcp_message_validate(message)) return -1;
+
+    cJSON envelope;
+    cJSON fields[MESSAGE_ENVELOPE_FIELDS];
+    message_envelope(message, &envelope, fields);
+
+    return mcp_json_buffer_print(buffer, &envelope, formatted);
+}
+
+int mcp_message_render_array(const mcp_message_t *const *messages, size_t count, bool formatted,
+                             mcp_json_buffer_t *buffer) {
+    if (!messages || count == 0 || !buffer) return -1;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!mcp_message_validate(messages[i])) return -1;
+    }
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return -1;
+
+    // One envelope and its fields per message, linked under an array on the stack
+    cJSON *nodes = hal->memory.alloc(count * (1 + MESSAGE_ENVELOPE_FIELDS) * sizeof(cJSON));
+    if (!nodes) return -1;
+
+    cJSON array;
+    memset(&array, 0, sizeof(array));
+    array.type = cJSON_Array;
+    for (size_t i = 0; i < count; i++) {
+        cJSON *envelope = &nodes[i * (1 + MESSAGE_ENVELOPE_FIELDS)];
+        message_envelope(messages[i], envelope, envelope + 1);
+        if (i > 0) {
+            cJSON *previous = envelope - (1 + MESSAGE_ENVELOPE_FIELDS);
+            previous->next = envelope;
+            envelope->prev = previous;
+        }
+    }
+    array.child = &nodes[0];
+    array.child->prev = &nodes[(count - 1) * (1 + MESSAGE_ENVELOPE_FIELDS)];
+
+    int result = mcp_json_buffer_print(buffer, &array, formatted);
+    hal->memory.free(nodes);
+    return result;
+}
+
+char *mcp_message_serialize(const mcp_message_t *message) {
+    mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+    if (!buffer || mcp_message_render(message, false, buffer) != 0) return NULL;
+
+    char *json_string = malloc(buffer->length + 1);
+    if (json_string) {
+        memcpy(json_string, buffer->data, buffer->length + 1);
+    }
+    mcp_json_buffer_trim(buffer);
+
     return json_string;
 }
 
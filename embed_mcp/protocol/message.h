@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "cjson/cJSON.h"
+#include "utils/json_buffer.h"
 
 // MCP Protocol Version
 #define MCP_PROTOCOL_VERSION "2025-11-25"
@@ -19,6 +20,7 @@
 #define MCP_ERROR_INVALID_PARAMS -32602
 #define MCP_ERROR_METHOD_NOT_FOUND -32601
 #define MCP_ERROR_INTERNAL_ERROR -32603
+#define MCP_ERROR_REQUEST_CANCELLED -32800  // Only where the transport must answer every request
 
 // MCP Message Types
 typedef enum {
@@ -46,6 +48,7 @@ typedef struct {
     char *method;
     cJSON *params;
     bool is_notification;  // true if this is a notification (no id)
+    bool in_batch;         // Answered with the rest of a batch, so it cannot be deferred
 } mcp_request_t;
 
 // MCP Response Structure (simplified view of message)
@@ -71,6 +74,19 @@ mcp_message_t *mcp_message_create_error_response(cJSON *id, int code, const char
 
 // Message parsing and serialization
 mcp_message_t *mcp_message_parse(const char *json_data);
+// Owned message made of the subtrees of json, which are taken out of it (json itself
+// stays with the caller). NULL if json is not a valid message.
+mcp_message_t *mcp_message_from_json(cJSON *json);
+// Borrowed view of an already parsed document: fields point into json, nothing is copied.
+// The view lives as long as json and must not be passed to mcp_message_destroy().
+// Returns 0 on success, -1 if json is not a valid message.
+int mcp_message_view_init(mcp_message_t *view, const cJSON *json);
+// Render the message as compact (or formatted) JSON into buffer without copying its subtrees
+int mcp_message_render(const mcp_message_t *message, bool formatted, mcp_json_buffer_t *buffer);
+// Same for several messages as one JSON array, rendered in a single pass
+int mcp_message_render_array(const mcp_message_t *const *messages, size_t count, bool formatted,
+                             mcp_json_buffer_t *buffer);
+// Compact JSON string, free with free()
 char *mcp_message_serialize(const mcp_message_t *message);
 
 // Message validation
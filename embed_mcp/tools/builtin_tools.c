@@ -39,9 +39,7 @@ cJSON *mcp_builtin_tool_base64_encode_execute(const cJSON *parameters, void *use
     cJSON *result_data = cJSON_CreateString(output);
     free(output);
 
-    cJSON *success_result = mcp_tool_create_success_result(result_data);
-    cJSON_Delete(result_data);
-    return success_result;
+    return mcp_tool_create_structured_result(result_data, true);
 }
 
 // Base64解码实现
@@ -76,9 +74,7 @@ cJSON *mcp_builtin_tool_base64_decode_execute(const cJSON *parameters, void *use
     cJSON *result_data = cJSON_CreateString((char*)output);
     free(output);
 
-    cJSON *success_result = mcp_tool_create_success_result(result_data);
-    cJSON_Delete(result_data);
-    return success_result;
+    return mcp_tool_create_structured_result(result_data, true);
 }
 
 // UUID生成实现
@@ -103,9 +99,7 @@ cJSON *mcp_builtin_tool_uuid_execute(const cJSON *parameters, void *user_data) {
     }
 
     cJSON *result_data = cJSON_CreateString(uuid_str);
-    cJSON *success_result = mcp_tool_create_success_result(result_data);
-    cJSON_Delete(result_data);
-    return success_result;
+    return mcp_tool_create_structured_result(result_data, true);
 }
 
 // 时间戳实现
@@ -115,9 +109,7 @@ cJSON *mcp_builtin_tool_timestamp_execute(const cJSON *parameters, void *user_da
 
     time_t timestamp = time(NULL);
     cJSON *result_data = cJSON_CreateNumber((double)timestamp);
-    cJSON *success_result = mcp_tool_create_success_result(result_data);
-    cJSON_Delete(result_data);
-    return success_result;
+    return mcp_tool_create_structured_result(result_data, true);
 }
 
 // 简化的注册函数
@@ -39,6 +39,33 @@ static const char *detect_mime_type(const char *file_path) {
     return "application/octet-stream";
 }
 
+// Grow a registration order array to hold at least needed entries
+static void *order_reserve(void *order, size_t *capacity, size_t needed, size_t element_size) {
+    if (needed <= *capacity) return order;
+
+    size_t new_capacity = *capacity ? *capacity * 2 : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    void *grown = realloc(order, new_capacity * element_size);
+    if (grown) {
+        *capacity = new_capacity;
+    }
+    return grown;
+}
+
+// Page bounds over registration indices. The lists are newest first, so a page runs
+// downwards from cursor (the number of entries still to list) to the returned end.
+static int order_page(size_t count, size_t cursor, size_t limit, size_t *first, size_t *end) {
+    size_t start = cursor ? cursor : count;
+    if (start > count) return -1;
+
+    *first = start;
+    *end = (limit && start > limit) ? start - limit : 0;
+    return 0;
+}
+
 // Create a new resource registry
 mcp_resource_registry_t *mcp_resource_registry_create(void) {
     mcp_resource_registry_t *registry = calloc(1, sizeof(mcp_resource_registry_t));
@@ -75,6 +102,8 @@ void mcp_resource_registry_destroy(mcp_resource_registry_t *registry) {
         template_current = template_next;
     }
 
+    free(registry->resource_order);
+    free(registry->template_order);
     free(registry);
 }
 
@@ -91,6 +120,15 @@ static int add_resource_to_registry(mcp_resource_registry_t *registry, mcp_resou
         return -1;
     }
     
+    mcp_resource_desc_t **order = order_reserve(registry->resource_order, &registry->resource_order_capacity,
+                                                registry->count + 1, sizeof(mcp_resource_desc_t*));
+    if (!order) {
+        mcp_resource_desc_destroy(resource);
+        return -1;
+    }
+    registry->resource_order = order;
+    registry->resource_order[registry->count] = resource;
+    
     // Add to front of list
     resource->next = registry->resources;
     registry->resources = resource;
@@ -249,31 +287,44 @@ size_t mcp_resource_registry_count(mcp_resource_registry_t *registry) {
 }
 
 // Generate JSON list of all resources
+static cJSON *resource_to_json(const mcp_resource_desc_t *resource) {
+    cJSON *resource_obj = cJSON_CreateObject();
+    if (!resource_obj) return NULL;
+
+    cJSON_AddStringToObject(resource_obj, "uri", resource->uri);
+    cJSON_AddStringToObject(resource_obj, "name", resource->name);
+    if (resource->description) {
+        cJSON_AddStringToObject(resource_obj, "description", resource->description);
+    }
+    cJSON_AddStringToObject(resource_obj, "mimeType", resource->mime_type);
+
+    return resource_obj;
+}
+
 cJSON *mcp_resource_registry_list_resources(mcp_resource_registry_t *registry) {
+    return mcp_resource_registry_list_resources_page(registry, 0, 0, NULL);
+}
+
+cJSON *mcp_resource_registry_list_resources_page(mcp_resource_registry_t *registry,
+                                                 size_t cursor, size_t limit, size_t *next_cursor) {
     if (!registry) return NULL;
 
+    size_t index, end;
+    if (order_page(registry->count, cursor, limit, &index, &end) != 0) return NULL;
+
     cJSON *resources_array = cJSON_CreateArray();
     if (!resources_array) return NULL;
 
-    mcp_resource_desc_t *current = registry->resources;
-    while (current) {
-        cJSON *resource_obj = cJSON_CreateObject();
+    while (index > end) {
+        cJSON *resource_obj = resource_to_json(registry->resource_order[--index]);
         if (!resource_obj) {
             cJSON_Delete(resources_array);
             return NULL;
         }
-
-        cJSON_AddStringToObject(resource_obj, "uri", current->uri);
-        cJSON_AddStringToObject(resource_obj, "name", current->name);
-        if (current->description) {
-            cJSON_AddStringToObject(resource_obj, "description", current->description);
-        }
-        cJSON_AddStringToObject(resource_obj, "mimeType", current->mime_type);
-
         cJSON_AddItemToArray(resources_array, resource_obj);
-        current = current->next;
     }
 
+    if (next_cursor) *next_cursor = end;
     return resources_array;
 }
 
@@ -318,6 +369,14 @@ int mcp_resource_registry_add_template(mcp_resource_registry_t *registry,
         current = current->next;
     }
 
+    mcp_resource_template_t **order = order_reserve(registry->template_order, &registry->template_order_capacity,
+                                                    registry->template_count + 1, sizeof(mcp_resource_template_t*));
+    if (!order) {
+        return -1;
+    }
+    registry->template_order = order;
+    registry->template_order[registry->template_count] = template;
+
     // Add to linked list
     template->next = registry->templates;
     registry->templates = template;
@@ -334,36 +393,49 @@ size_t mcp_resource_registry_template_count(mcp_resource_registry_t *registry) {
     return registry ? registry->template_count : 0;
 }
 
+static cJSON *template_to_json(const mcp_resource_template_t *template) {
+    cJSON *template_obj = cJSON_CreateObject();
+    if (!template_obj) return NULL;
+
+    cJSON_AddStringToObject(template_obj, "uriTemplate", template->uri_template);
+    cJSON_AddStringToObject(template_obj, "name", template->name);
+    if (template->title) {
+        cJSON_AddStringToObject(template_obj, "title", template->title);
+    }
+    if (template->description) {
+        cJSON_AddStringToObject(template_obj, "description", template->description);
+    }
+    if (template->mime_type) {
+        cJSON_AddStringToObject(template_obj, "mimeType", template->mime_type);
+    }
+
+    return template_obj;
+}
+
 cJSON *mcp_resource_registry_list_templates(mcp_resource_registry_t *registry) {
+    return mcp_resource_registry_list_templates_page(registry, 0, 0, NULL);
+}
+
+cJSON *mcp_resource_registry_list_templates_page(mcp_resource_registry_t *registry,
+                                                 size_t cursor, size_t limit, size_t *next_cursor) {
     if (!registry) return NULL;
 
+    size_t index, end;
+    if (order_page(registry->template_count, cursor, limit, &index, &end) != 0) return NULL;
+
     cJSON *templates_array = cJSON_CreateArray();
     if (!templates_array) return NULL;
 
-    mcp_resource_template_t *current = registry->templates;
-    while (current) {
-        cJSON *template_obj = cJSON_CreateObject();
+    while (index > end) {
+        cJSON *template_obj = template_to_json(registry->template_order[--index]);
         if (!template_obj) {
             cJSON_Delete(templates_array);
             return NULL;
         }
-
-        cJSON_AddStringToObject(template_obj, "uriTemplate", current->uri_template);
-        cJSON_AddStringToObject(template_obj, "name", current->name);
-        if (current->title) {
-            cJSON_AddStringToObject(template_obj, "title", current->title);
-        }
-        if (current->description) {
-            cJSON_AddStringToObject(template_obj, "description", current->description);
-        }
-        if (current->mime_type) {
-            cJSON_AddStringToObject(template_obj, "mimeType", current->mime_type);
-        }
-
         cJSON_AddItemToArray(templates_array, template_obj);
-        current = current->next;
     }
 
+    if (next_cursor) *next_cursor = end;
     return templates_array;
 }
 
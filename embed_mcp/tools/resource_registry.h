@@ -19,6 +19,12 @@ struct mcp_resource_registry {
     // Resource Templates support
     mcp_resource_template_t *templates;  // Linked list of templates
     size_t template_count;               // Number of registered templates
+
+    // Registration order, so list pages can resume from a cursor without walking the lists
+    mcp_resource_desc_t **resource_order;
+    size_t resource_order_capacity;
+    mcp_resource_template_t **template_order;
+    size_t template_order_capacity;
 };
 
 /**
@@ -146,6 +152,17 @@ size_t mcp_resource_registry_count(mcp_resource_registry_t *registry);
  */
 cJSON *mcp_resource_registry_list_resources(mcp_resource_registry_t *registry);
 
+/**
+ * Generate one page of the resources/list array, in the same order as the full list
+ * @param registry Resource registry
+ * @param cursor Cursor returned for the previous page, or 0 for the first page
+ * @param limit Maximum number of resources (0 for no limit)
+ * @param next_cursor Receives the cursor of the next page, 0 after the last page (can be NULL)
+ * @return JSON array of resources, or NULL on error or invalid cursor (caller must free with cJSON_Delete)
+ */
+cJSON *mcp_resource_registry_list_resources_page(mcp_resource_registry_t *registry,
+                                                 size_t cursor, size_t limit, size_t *next_cursor);
+
 /**
  * Read resource content by URI
  * @param registry Resource registry
@@ -184,6 +201,17 @@ int mcp_resource_registry_add_template(mcp_resource_registry_t *registry,
  */
 cJSON *mcp_resource_registry_list_templates(mcp_resource_registry_t *registry);
 
+/**
+ * Generate one page of the resources/templates/list array, in the same order as the full list
+ * @param registry Resource registry
+ * @param cursor Cursor returned for the previous page, or 0 for the first page
+ * @param limit Maximum number of templates (0 for no limit)
+ * @param next_cursor Receives the cursor of the next page, 0 after the last page (can be NULL)
+ * @return JSON array of templates (caller must free), or NULL on error or invalid cursor
+ */
+cJSON *mcp_resource_registry_list_templates_page(mcp_resource_registry_t *registry,
+                                                 size_t cursor, size_t limit, size_t *next_cursor);
+
 /**
  * Get count of registered templates
  * @param registry Resource registry
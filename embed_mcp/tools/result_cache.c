@@ -0,0 +1,361 @@
+#include "tools/result_cache.h"
+#include "utils/arena.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RESULT_CACHE_MIN_BUCKETS 16
+
+typedef struct result_cache_entry {
+    uint64_t hash;
+    cJSON *arguments;                       // NULL for calls without arguments
+    cJSON *result;
+    size_t bytes;
+    uint64_t expires_ms;                    // 0 = never
+
+    struct result_cache_entry *chain;       // Next in the hash bucket
+    struct result_cache_entry *prev;        // LRU list, most recently used first
+    struct result_cache_entry *next;
+} result_cache_entry_t;
+
+struct mcp_result_cache {
+    pthread_mutex_t mutex;
+    size_t max_bytes;
+    uint32_t ttl_ms;
+
+    result_cache_entry_t **buckets;
+    size_t bucket_count;                    // Power of two, grown to keep one entry per bucket
+    result_cache_entry_t *lru_head;
+    result_cache_entry_t *lru_tail;
+
+    size_t entries;
+    size_t bytes;
+    size_t hits;
+    size_t misses;
+    size_t expirations;
+    size_t evictions;
+};
+
+static uint64_t cache_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+// Canonical hashing
+static uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t hash_string(uint64_t seed, const char *text) {
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    if (text) {
+        while (*text) {
+            hash ^= (unsigned char)*text++;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash_mix(hash);
+}
+
+static uint64_t hash_value(const cJSON *item) {
+    switch (item->type & 0xFF) {
+    case cJSON_False:
+        return hash_mix(1);
+    case cJSON_True:
+        return hash_mix(2);
+    case cJSON_NULL:
+        return hash_mix(3);
+    case cJSON_Number: {
+        // 1, 1.0 and 1e0 parse to the same double; -0 is folded into 0
+        double value = item->valuedouble == 0 ? 0.0 : item->valuedouble;
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return hash_mix(bits ^ 4);
+    }
+    case cJSON_String:
+    case cJSON_Raw:
+        return hash_string(5, item->valuestring);
+    case cJSON_Array: {
+        uint64_t hash = 6;
+        for (const cJSON *child = item->child; child; child = child->next) {
+            hash = hash_mix(hash * 31 + hash_value(child));
+        }
+        return hash;
+    }
+    case cJSON_Object: {
+        // Members are summed, so their order does not matter
+        uint64_t sum = 0;
+        for (const cJSON *child = item->child; child; child = child->next) {
+            sum += hash_mix(hash_string(7, child->string) ^ hash_value(child));
+        }
+        return hash_mix(sum ^ 7);
+    }
+    default:
+        return 0;
+    }
+}
+
+uint64_t mcp_result_cache_hash(const cJSON *arguments) {
+    return arguments ? hash_value(arguments) : 0;
+}
+
+static bool arguments_equal(const cJSON *a, const cJSON *b) {
+    if (!a || !b) return a == b;
+    return cJSON_Compare(a, b, true) != 0;
+}
+
+// Heap footprint of a value, for the budget; allocator overhead is not counted
+static size_t value_bytes(const cJSON *item) {
+    size_t bytes = sizeof(cJSON);
+    if (item->string) bytes += strlen(item->string) + 1;
+    if (item->valuestring) bytes += strlen(item->valuestring) + 1;
+    for (const cJSON *child = item->child; child; child = child->next) {
+        bytes += value_bytes(child);
+    }
+    return bytes;
+}
+
+static bool result_is_error(const cJSON *result) {
+    const cJSON *is_error = cJSON_GetObjectItem(result, "isError");
+    return cJSON_IsTrue(is_error);
+}
+
+// Entry management (caller holds the mutex)
+static void entry_free(result_cache_entry_t *entry) {
+    cJSON_Delete(entry->arguments);
+    cJSON_Delete(entry->result);
+    free(entry);
+}
+
+static void lru_unlink(mcp_result_cache_t *cache, result_cache_entry_t *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->lru_head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->lru_tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void lru_push_front(mcp_result_cache_t *cache, result_cache_entry_t *entry) {
+    entry->prev = NULL;
+    entry->next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->prev = entry;
+    else cache->lru_tail = entry;
+    cache->lru_head = entry;
+}
+
+static void entry_remove(mcp_result_cache_t *cache, result_cache_entry_t *entry) {
+    result_cache_entry_t **link = &cache->buckets[entry->hash & (cache->bucket_count - 1)];
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+
+    lru_unlink(cache, entry);
+    cache->entries--;
+    cache->bytes -= entry->bytes;
+    entry_free(entry);
+}
+
+static void evict_to(mcp_result_cache_t *cache, size_t max_bytes) {
+    while (cache->lru_tail && cache->bytes > max_bytes) {
+        entry_remove(cache, cache->lru_tail);
+        cache->evictions++;
+    }
+}
+
+static void buckets_grow(mcp_result_cache_t *cache) {
+    if (cache->entries < cache->bucket_count) return;
+
+    size_t count = cache->bucket_count * 2;
+    result_cache_entry_t **buckets = calloc(count, sizeof(result_cache_entry_t*));
+    if (!buckets) return;   // Longer chains, still correct
+
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        result_cache_entry_t *entry = cache->buckets[i];
+        while (entry) {
+            result_cache_entry_t *chain = entry->chain;
+            size_t slot = entry->hash & (count - 1);
+            entry->chain = buckets[slot];
+            buckets[slot] = entry;
+            entry = chain;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = count;
+}
+
+static result_cache_entry_t *entry_find(mcp_result_cache_t *cache, uint64_t hash, const cJSON *arguments) {
+    result_cache_entry_t *entry = cache->buckets[hash & (cache->bucket_count - 1)];
+    while (entry && (entry->hash != hash || !arguments_equal(entry->arguments, arguments))) {
+        entry = entry->chain;
+    }
+    return entry;
+}
+
+// Cache lifecycle
+mcp_result_cache_t *mcp_result_cache_create(size_t max_bytes, uint32_t ttl_ms) {
+    mcp_result_cache_t *cache = calloc(1, sizeof(mcp_result_cache_t));
+    if (!cache) return NULL;
+
+    cache->buckets = calloc(RESULT_CACHE_MIN_BUCKETS, sizeof(result_cache_entry_t*));
+    if (!cache->buckets || pthread_mutex_init(&cache->mutex, NULL) != 0) {
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+    cache->bucket_count = RESULT_CACHE_MIN_BUCKETS;
+    cache->max_bytes = max_bytes;
+    cache->ttl_ms = ttl_ms;
+
+    return cache;
+}
+
+void mcp_result_cache_destroy(mcp_result_cache_t *cache) {
+    if (!cache) return;
+
+    mcp_result_cache_clear(cache);
+    pthread_mutex_destroy(&cache->mutex);
+    free(cache->buckets);
+    free(cache);
+}
+
+void mcp_result_cache_configure(mcp_result_cache_t *cache, size_t max_bytes, uint32_t ttl_ms) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->mutex);
+    cache->max_bytes = max_bytes;
+    cache->ttl_ms = ttl_ms;
+    evict_to(cache, max_bytes);
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// Lookup and store
+cJSON *mcp_result_cache_lookup(mcp_result_cache_t *cache, uint64_t hash, const cJSON *arguments) {
+    if (!cache) return NULL;
+
+    cJSON *result = NULL;
+    pthread_mutex_lock(&cache->mutex);
+    if (cache->max_bytes == 0) {
+        // Disabled: not counted as a miss
+        pthread_mutex_unlock(&cache->mutex);
+        return NULL;
+    }
+
+    result_cache_entry_t *entry = entry_find(cache, hash, arguments);
+    if (entry && entry->expires_ms && entry->expires_ms <= cache_now_ms()) {
+        entry_remove(cache, entry);
+        cache->expirations++;
+        entry = NULL;
+    }
+
+    if (entry) {
+        lru_unlink(cache, entry);
+        lru_push_front(cache, entry);
+        // The copy is the caller's; inside a request it comes from the request arena
+        result = cJSON_Duplicate(entry->result, 1);
+    }
+    if (result) cache->hits++;
+    else cache->misses++;
+
+    pthread_mutex_unlock(&cache->mutex);
+    return result;
+}
+
+int mcp_result_cache_store(mcp_result_cache_t *cache, uint64_t hash,
+                           const cJSON *arguments, const cJSON *result) {
+    if (!cache || !result || result_is_error(result)) return -1;
+
+    // Copies outlive the request, so they are made on the heap and outside the lock
+    bool saved = mcp_arena_suspend();
+    result_cache_entry_t *entry = calloc(1, sizeof(result_cache_entry_t));
+    if (entry) {
+        entry->arguments = arguments ? cJSON_Duplicate(arguments, 1) : NULL;
+        entry->result = cJSON_Duplicate(result, 1);
+    }
+    if (!entry || !entry->result || (arguments && !entry->arguments)) {
+        if (entry) entry_free(entry);
+        mcp_arena_resume(saved);
+        return -1;
+    }
+    entry->hash = hash;
+    entry->bytes = sizeof(result_cache_entry_t) + value_bytes(entry->result) +
+                   (entry->arguments ? value_bytes(entry->arguments) : 0);
+
+    pthread_mutex_lock(&cache->mutex);
+
+    if (entry->bytes > cache->max_bytes) {
+        pthread_mutex_unlock(&cache->mutex);
+        entry_free(entry);
+        mcp_arena_resume(saved);
+        return -1;
+    }
+
+    // A concurrent miss on the same arguments may have stored it already
+    result_cache_entry_t *existing = entry_find(cache, hash, arguments);
+    if (existing) {
+        entry_remove(cache, existing);
+    }
+
+    entry->expires_ms = cache->ttl_ms ? cache_now_ms() + cache->ttl_ms : 0;
+    evict_to(cache, cache->max_bytes - entry->bytes);
+
+    size_t slot = hash & (cache->bucket_count - 1);
+    entry->chain = cache->buckets[slot];
+    cache->buckets[slot] = entry;
+    lru_push_front(cache, entry);
+    cache->entries++;
+    cache->bytes += entry->bytes;
+    buckets_grow(cache);
+
+    pthread_mutex_unlock(&cache->mutex);
+    mcp_arena_resume(saved);
+
+    return 0;
+}
+
+void mcp_result_cache_clear(mcp_result_cache_t *cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->mutex);
+    while (cache->lru_head) {
+        entry_remove(cache, cache->lru_head);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+// Statistics
+void mcp_result_cache_get_stats(mcp_result_cache_t *cache, mcp_result_cache_stats_t *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->mutex);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->expirations = cache->expirations;
+    stats->evictions = cache->evictions;
+    stats->entries = cache->entries;
+    stats->bytes = cache->bytes;
+    stats->max_bytes = cache->max_bytes;
+    stats->ttl_ms = cache->ttl_ms;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+void mcp_result_cache_reset_stats(mcp_result_cache_t *cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->mutex);
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->expirations = 0;
+    cache->evictions = 0;
+    pthread_mutex_unlock(&cache->mutex);
+}
@@ -0,0 +1,49 @@
+#ifndef MCP_RESULT_CACHE_H
+#define MCP_RESULT_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cjson/cJSON.h"
+
+// Memoized results of a pure tool, keyed by its arguments.
+// Arguments are hashed canonically (object members in any order, numbers by value)
+// and a matching hash is confirmed by comparing the arguments, so different arguments
+// never share a result. Memory is bounded by a byte budget with the least recently
+// used results evicted first; results may also expire after a TTL. Only successful
+// results are kept. Every operation takes the cache's mutex.
+typedef struct mcp_result_cache mcp_result_cache_t;
+
+typedef struct {
+    size_t hits;
+    size_t misses;              // Including lookups that found an expired result
+    size_t expirations;
+    size_t evictions;           // Dropped to stay within the budget
+    size_t entries;
+    size_t bytes;               // Estimated heap use of the cached arguments and results
+    size_t max_bytes;
+    uint32_t ttl_ms;
+} mcp_result_cache_stats_t;
+
+// ttl_ms 0: results never expire
+mcp_result_cache_t *mcp_result_cache_create(size_t max_bytes, uint32_t ttl_ms);
+void mcp_result_cache_destroy(mcp_result_cache_t *cache);
+// New limits apply at once; max_bytes 0 disables the cache and drops its results
+void mcp_result_cache_configure(mcp_result_cache_t *cache, size_t max_bytes, uint32_t ttl_ms);
+
+// Canonical hash of an arguments value (NULL allowed), computed once per call
+uint64_t mcp_result_cache_hash(const cJSON *arguments);
+// Copy of the result cached for arguments, owned by the caller; NULL on a miss or
+// while the cache is disabled
+cJSON *mcp_result_cache_lookup(mcp_result_cache_t *cache, uint64_t hash, const cJSON *arguments);
+// Keep copies of arguments and result. Returns -1 if the result is not cached: an
+// error result, larger than the whole budget, or out of memory.
+int mcp_result_cache_store(mcp_result_cache_t *cache, uint64_t hash,
+                           const cJSON *arguments, const cJSON *result);
+void mcp_result_cache_clear(mcp_result_cache_t *cache);
+
+void mcp_result_cache_get_stats(mcp_result_cache_t *cache, mcp_result_cache_stats_t *stats);
+// Counters restart from zero; cached results are kept
+void mcp_result_cache_reset_stats(mcp_result_cache_t *cache);
+
+#endif // MCP_RESULT_CACHE_H
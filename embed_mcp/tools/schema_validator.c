@@ -0,0 +1,553 @@
+#include "tools/schema_validator.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCHEMA_NO_NODE UINT32_MAX
+// Deeper subschemas are compiled as "accept anything"
+#define SCHEMA_MAX_DEPTH 32
+// Objects with up to this many tracked properties keep their seen-bitset on the stack
+#define SCHEMA_STACK_WORDS 4
+
+enum {
+    SCHEMA_TYPE_STRING  = 1u << 0,
+    SCHEMA_TYPE_INTEGER = 1u << 1,
+    SCHEMA_TYPE_NUMBER  = 1u << 2,
+    SCHEMA_TYPE_BOOLEAN = 1u << 3,
+    SCHEMA_TYPE_ARRAY   = 1u << 4,
+    SCHEMA_TYPE_OBJECT  = 1u << 5,
+    SCHEMA_TYPE_NULL    = 1u << 6,
+    SCHEMA_TYPE_UNKNOWN = 1u << 7     // Unrecognised type name: no value matches
+};
+
+enum {
+    SCHEMA_FLAG_MINIMUM = 1u << 0,
+    SCHEMA_FLAG_MAXIMUM = 1u << 1,
+    SCHEMA_FLAG_CLOSED  = 1u << 2     // additionalProperties: false
+};
+
+typedef struct {
+    const char *name;
+    uint32_t hash;
+    uint32_t node;                    // SCHEMA_NO_NODE: only listed in required, any value
+    bool declared;                    // Listed under properties (not only in required)
+} schema_property_t;
+
+typedef struct {
+    uint32_t types;                   // 0 accepts every type
+    uint32_t flags;
+    const char *type_name;            // As written in the schema, for error messages
+    double minimum;
+    double maximum;
+    uint32_t items;
+    uint32_t first_property;
+    uint32_t property_count;
+    uint32_t first_slot;              // Open-addressing table over the properties
+    uint32_t slot_mask;
+    uint32_t first_required_word;     // Bitset over the properties, same order
+    uint32_t required_words;
+    uint32_t first_required_order;    // Required positions as listed, for error reporting
+    uint32_t required_order_count;
+} schema_node_t;
+
+struct mcp_schema_program {
+    schema_node_t *nodes;
+    size_t node_count;
+    size_t node_capacity;
+
+    schema_property_t *properties;
+    size_t property_count;
+    size_t property_capacity;
+
+    uint32_t *slots;                  // Property index + 1, 0 marks an empty slot
+    size_t slot_count;
+    size_t slot_capacity;
+
+    uint64_t *required;
+    size_t required_count;
+    size_t required_capacity;
+
+    uint32_t *required_order;
+    size_t required_order_count;
+    size_t required_order_capacity;
+};
+
+static uint32_t schema_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Grow array to hold needed elements; NULL (array untouched) when out of memory
+static void *schema_reserve(void *array, size_t *capacity, size_t needed, size_t element_size) {
+    if (needed <= *capacity) return array;
+
+    size_t new_capacity = *capacity ? *capacity * 2 : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    void *grown = realloc(array, new_capacity * element_size);
+    if (grown) {
+        *capacity = new_capacity;
+    }
+    return grown;
+}
+
+static uint32_t schema_type_bit(const char *name) {
+    if (strcmp(name, "string") == 0) return SCHEMA_TYPE_STRING;
+    if (strcmp(name, "integer") == 0) return SCHEMA_TYPE_INTEGER;
+    if (strcmp(name, "number") == 0) return SCHEMA_TYPE_NUMBER;
+    if (strcmp(name, "boolean") == 0) return SCHEMA_TYPE_BOOLEAN;
+    if (strcmp(name, "array") == 0) return SCHEMA_TYPE_ARRAY;
+    if (strcmp(name, "object") == 0) return SCHEMA_TYPE_OBJECT;
+    if (strcmp(name, "null") == 0) return SCHEMA_TYPE_NULL;
+    return SCHEMA_TYPE_UNKNOWN;
+}
+
+static uint32_t schema_value_types(const cJSON *value) {
+    if (cJSON_IsString(value)) return SCHEMA_TYPE_STRING;
+    if (cJSON_IsNumber(value)) {
+        double number = value->valuedouble;
+        return (double)((long long)number) == number ? SCHEMA_TYPE_NUMBER | SCHEMA_TYPE_INTEGER
+                                                     : SCHEMA_TYPE_NUMBER;
+    }
+    if (cJSON_IsBool(value)) return SCHEMA_TYPE_BOOLEAN;
+    if (cJSON_IsArray(value)) return SCHEMA_TYPE_ARRAY;
+    if (cJSON_IsObject(value)) return SCHEMA_TYPE_OBJECT;
+    if (cJSON_IsNull(value)) return SCHEMA_TYPE_NULL;
+    return 0;
+}
+
+// Compilation
+static uint32_t schema_compile_node(mcp_schema_program_t *program, const cJSON *schema, int depth);
+
+static int schema_add_property(mcp_schema_program_t *program, const char *name, bool declared) {
+    schema_property_t *properties = schema_reserve(program->properties, &program->property_capacity,
+                                                   program->property_count + 1, sizeof(schema_property_t));
+    if (!properties) return -1;
+    program->properties = properties;
+
+    schema_property_t *property = &program->properties[program->property_count++];
+    property->name = name;
+    property->hash = schema_hash(name);
+    property->node = SCHEMA_NO_NODE;
+    property->declared = declared;
+    return 0;
+}
+
+static long schema_find_compiled_property(const mcp_schema_program_t *program, uint32_t first,
+                                          uint32_t count, const char *name) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(program->properties[first + i].name, name) == 0) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+static int schema_compile_object(mcp_schema_program_t *program, uint32_t index, const cJSON *schema, int depth) {
+    const cJSON *properties = cJSON_GetObjectItem(schema, "properties");
+    const cJSON *required = cJSON_GetObjectItem(schema, "required");
+    const cJSON *additional = cJSON_GetObjectItem(schema, "additionalProperties");
+
+    if (cJSON_IsBool(additional) && !cJSON_IsTrue(additional)) {
+        program->nodes[index].flags |= SCHEMA_FLAG_CLOSED;
+    }
+
+    // Lay out this object's properties contiguously before compiling any subschema
+    uint32_t first = (uint32_t)program->property_count;
+    const cJSON *property;
+    if (cJSON_IsObject(properties)) {
+        cJSON_ArrayForEach(property, properties) {
+            if (property->string && schema_add_property(program, property->string, true) != 0) return -1;
+        }
+    }
+    if (cJSON_IsArray(required)) {
+        cJSON_ArrayForEach(property, required) {
+            if (cJSON_IsString(property) &&
+                schema_find_compiled_property(program, first, (uint32_t)program->property_count - first,
+                                              property->valuestring) < 0 &&
+                schema_add_property(program, property->valuestring, false) != 0) {
+                return -1;
+            }
+        }
+    }
+    uint32_t count = (uint32_t)program->property_count - first;
+
+    program->nodes[index].first_property = first;
+    program->nodes[index].property_count = count;
+    if (count == 0) return 0;
+
+    // Hash table at most half full
+    uint32_t slot_count = 2;
+    while (slot_count < count * 2) {
+        slot_count *= 2;
+    }
+    uint32_t *slots = schema_reserve(program->slots, &program->slot_capacity,
+                                     program->slot_count + slot_count, sizeof(uint32_t));
+    if (!slots) return -1;
+    program->slots = slots;
+
+    uint32_t first_slot = (uint32_t)program->slot_count;
+    memset(&program->slots[first_slot], 0, slot_count * sizeof(uint32_t));
+    program->slot_count += slot_count;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = program->properties[first + i].hash & (slot_count - 1);
+        while (program->slots[first_slot + slot]) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        program->slots[first_slot + slot] = first + i + 1;
+    }
+    program->nodes[index].first_slot = first_slot;
+    program->nodes[index].slot_mask = slot_count - 1;
+
+    // Required bitset
+    uint32_t words = (count + 63) / 64;
+    uint64_t *bits = schema_reserve(program->required, &program->required_capacity,
+                                    program->required_count + words, sizeof(uint64_t));
+    if (!bits) return -1;
+    program->required = bits;
+
+    uint32_t first_word = (uint32_t)program->required_count;
+    memset(&program->required[first_word], 0, words * sizeof(uint64_t));
+    program->required_count += words;
+    uint32_t first_order = (uint32_t)program->required_order_count;
+    if (cJSON_IsArray(required)) {
+        cJSON_ArrayForEach(property, required) {
+            if (!cJSON_IsString(property)) continue;
+            long position = schema_find_compiled_property(program, first, count, property->valuestring);
+            uint64_t bit = (uint64_t)1 << (position % 64);
+            if (program->required[first_word + position / 64] & bit) continue;
+            program->required[first_word + position / 64] |= bit;
+
+            uint32_t *order = schema_reserve(program->required_order, &program->required_order_capacity,
+                                             program->required_order_count + 1, sizeof(uint32_t));
+            if (!order) return -1;
+            program->required_order = order;
+            program->required_order[program->required_order_count++] = (uint32_t)position;
+        }
+    }
+    program->nodes[index].first_required_word = first_word;
+    program->nodes[index].required_words = words;
+    program->nodes[index].first_required_order = first_order;
+    program->nodes[index].required_order_count = (uint32_t)program->required_order_count - first_order;
+
+    // Subschemas last: they append to the same arrays
+    if (cJSON_IsObject(properties)) {
+        uint32_t i = 0;
+        cJSON_ArrayForEach(property, properties) {
+            if (!property->string) continue;
+            uint32_t node = schema_compile_node(program, property, depth + 1);
+            if (node == SCHEMA_NO_NODE) return -1;
+            program->properties[first + i++].node = node;
+        }
+    }
+
+    return 0;
+}
+
+static uint32_t schema_compile_node(mcp_schema_program_t *program, const cJSON *schema, int depth) {
+    schema_node_t *nodes = schema_reserve(program->nodes, &program->node_capacity,
+                                          program->node_count + 1, sizeof(schema_node_t));
+    if (!nodes) return SCHEMA_NO_NODE;
+    program->nodes = nodes;
+
+    uint32_t index = (uint32_t)program->node_count++;
+    schema_node_t *node = &program->nodes[index];
+    memset(node, 0, sizeof(*node));
+    node->items = SCHEMA_NO_NODE;
+
+    // Anything that is not an object schema accepts every value
+    if (!cJSON_IsObject(schema) || depth > SCHEMA_MAX_DEPTH) {
+        return index;
+    }
+
+    const cJSON *type = cJSON_GetObjectItem(schema, "type");
+    if (cJSON_IsString(type)) {
+        node->types = schema_type_bit(type->valuestring);
+        node->type_name = type->valuestring;
+    } else if (cJSON_IsArray(type)) {
+        const cJSON *name;
+        cJSON_ArrayForEach(name, type) {
+            if (!cJSON_IsString(name)) continue;
+            node->types |= schema_type_bit(name->valuestring);
+            if (!node->type_name) node->type_name = name->valuestring;
+        }
+    }
+
+    const cJSON *minimum = cJSON_GetObjectItem(schema, "minimum");
+    if (cJSON_IsNumber(minimum)) {
+        node->flags |= SCHEMA_FLAG_MINIMUM;
+        node->minimum = minimum->valuedouble;
+    }
+    const cJSON *maximum = cJSON_GetObjectItem(schema, "maximum");
+    if (cJSON_IsNumber(maximum)) {
+        node->flags |= SCHEMA_FLAG_MAXIMUM;
+        node->maximum = maximum->valuedouble;
+    }
+
+    uint32_t types = node->types;
+    if ((types & SCHEMA_TYPE_OBJECT) && schema_compile_object(program, index, schema, depth) != 0) {
+        return SCHEMA_NO_NODE;
+    }
+
+    const cJSON *items = cJSON_GetObjectItem(schema, "items");
+    if ((types & SCHEMA_TYPE_ARRAY) && items) {
+        uint32_t items_node = schema_compile_node(program, items, depth + 1);
+        if (items_node == SCHEMA_NO_NODE) return SCHEMA_NO_NODE;
+        program->nodes[index].items = items_node;
+    }
+
+    return index;
+}
+
+mcp_schema_program_t *mcp_schema_compile(const cJSON *schema) {
+    if (!cJSON_IsObject(schema)) return NULL;
+
+    mcp_schema_program_t *program = calloc(1, sizeof(mcp_schema_program_t));
+    if (!program) return NULL;
+
+    if (schema_compile_node(program, schema, 0) == SCHEMA_NO_NODE) {
+        mcp_schema_program_destroy(program);
+        return NULL;
+    }
+
+    return program;
+}
+
+void mcp_schema_program_destroy(mcp_schema_program_t *program) {
+    if (!program) return;
+
+    free(program->nodes);
+    free(program->properties);
+    free(program->slots);
+    free(program->required);
+    free(program->required_order);
+    free(program);
+}
+
+// Error context
+void mcp_schema_error_init(mcp_schema_error_t *error) {
+    if (!error) return;
+    error->path[0] = '\0';
+    error->keyword = "";
+    error->message[0] = '\0';
+}
+
+void mcp_schema_error_prepend_path(mcp_schema_error_t *error, const char *segment) {
+    if (!error || !segment) return;
+
+    // Escape per RFC 6901: '~' becomes "~0", '/' becomes "~1"
+    char token[sizeof(error->path)];
+    size_t length = 0;
+    token[length++] = '/';
+    for (const char *c = segment; *c && length + 2 < sizeof(token); c++) {
+        if (*c == '~' || *c == '/') {
+            token[length++] = '~';
+            token[length++] = *c == '~' ? '0' : '1';
+        } else {
+            token[length++] = *c;
+        }
+    }
+
+    // Keep the outermost tokens if the whole path does not fit
+    size_t existing = strlen(error->path);
+    if (length + existing >= sizeof(error->path)) {
+        existing = sizeof(error->path) - 1 - length;
+    }
+    memmove(error->path + length, error->path, existing);
+    memcpy(error->path, token, length);
+    error->path[length + existing] = '\0';
+}
+
+void mcp_schema_error_prepend_index(mcp_schema_error_t *error, int index) {
+    char segment[16];
+    snprintf(segment, sizeof(segment), "%d", index);
+    mcp_schema_error_prepend_path(error, segment);
+}
+
+// Validation
+static void schema_error(mcp_schema_error_t *error, const char *keyword, const char *fmt, const char *detail) {
+    if (!error) return;
+    error->keyword = keyword;
+    snprintf(error->message, sizeof(error->message), fmt, detail);
+}
+
+static bool schema_check_node(const mcp_schema_program_t *program, uint32_t index, const cJSON *value,
+                              mcp_schema_error_t *error);
+
+static long schema_lookup_property(const mcp_schema_program_t *program, const schema_node_t *node,
+                                   const char *name) {
+    if (node->property_count == 0) return -1;
+
+    uint32_t hash = schema_hash(name);
+    uint32_t slot = hash & node->slot_mask;
+    uint32_t entry;
+    while ((entry = program->slots[node->first_slot + slot]) != 0) {
+        const schema_property_t *property = &program->properties[entry - 1];
+        if (property->hash == hash && strcmp(property->name, name) == 0) {
+            return (long)(entry - 1 - node->first_property);
+        }
+        slot = (slot + 1) & node->slot_mask;
+    }
+    return -1;
+}
+
+// Missing required properties are reported ahead of any other problem with the object,
+// the first one in the order the schema lists them
+static bool schema_report_missing(const mcp_schema_program_t *program, const schema_node_t *node,
+                                  const uint64_t *seen, mcp_schema_error_t *error) {
+    uint64_t missing = 0;
+    for (uint32_t word = 0; word < node->required_words; word++) {
+        missing |= program->required[node->first_required_word + word] & ~seen[word];
+    }
+    if (!missing) return false;
+
+    for (uint32_t i = 0; i < node->required_order_count; i++) {
+        uint32_t position = program->required_order[node->first_required_order + i];
+        if (!(seen[position / 64] & ((uint64_t)1 << (position % 64)))) {
+            // Reported against the object: drop whatever a failed member left in the path
+            if (error) error->path[0] = '\0';
+            schema_error(error, "required", "Missing required property '%s'",
+                         program->properties[node->first_property + position].name);
+            break;
+        }
+    }
+    return true;
+}
+
+static bool schema_check_object(const mcp_schema_program_t *program, const schema_node_t *node,
+                                const cJSON *value, mcp_schema_error_t *error) {
+    if (node->property_count == 0 && !(node->flags & SCHEMA_FLAG_CLOSED)) {
+        return true;
+    }
+
+    uint64_t seen_local[SCHEMA_STACK_WORDS] = {0};
+    uint64_t *seen = seen_local;
+    if (node->required_words > SCHEMA_STACK_WORDS) {
+        seen = calloc(node->required_words, sizeof(uint64_t));
+        if (!seen) {
+            schema_error(error, "", "%s", "Out of memory");
+            return false;
+        }
+    }
+
+    const char *failed_key = NULL;
+    const char *failure = NULL;
+    const char *failed_keyword = NULL;  // NULL keeps the keyword of a nested failure
+    const cJSON *member;
+    cJSON_ArrayForEach(member, value) {
+        if (!member->string) continue;
+
+        long position = schema_lookup_property(program, node, member->string);
+        if (position < 0) {
+            if (node->flags & SCHEMA_FLAG_CLOSED) {
+                failed_key = member->string;
+                failure = "Unexpected property '%s'";
+                failed_keyword = "additionalProperties";
+                break;
+            }
+            continue;
+        }
+
+        seen[position / 64] |= (uint64_t)1 << (position % 64);
+        const schema_property_t *property = &program->properties[node->first_property + position];
+        if (!property->declared) {
+            if (node->flags & SCHEMA_FLAG_CLOSED) {
+                failed_key = member->string;
+                failure = "Unexpected property '%s'";
+                failed_keyword = "additionalProperties";
+                break;
+            }
+            continue;
+        }
+        uint32_t child = property->node;
+        if (!schema_check_node(program, child, member, error)) {
+            failed_key = member->string;
+            failure = "Invalid property '%s'";
+            break;
+        }
+    }
+
+    bool valid = true;
+    if (failure) {
+        // The pass stopped early: finish marking what is present before looking for gaps
+        for (member = member->next; member; member = member->next) {
+            long position = member->string ? schema_lookup_property(program, node, member->string) : -1;
+            if (position >= 0) seen[position / 64] |= (uint64_t)1 << (position % 64);
+        }
+        if (!schema_report_missing(program, node, seen, error) && error) {
+            schema_error(error, failed_keyword ? failed_keyword : error->keyword, failure, failed_key);
+            mcp_schema_error_prepend_path(error, failed_key);
+        }
+        valid = false;
+    } else if (schema_report_missing(program, node, seen, error)) {
+        valid = false;
+    }
+
+    if (seen != seen_local) free(seen);
+    return valid;
+}
+
+static bool schema_check_node(const mcp_schema_program_t *program, uint32_t index, const cJSON *value,
+                              mcp_schema_error_t *error) {
+    if (index == SCHEMA_NO_NODE) return true;
+
+    const schema_node_t *node = &program->nodes[index];
+    uint32_t types = schema_value_types(value);
+
+    if (node->types && !(types & node->types)) {
+        schema_error(error, "type", "Expected type '%s' but got different type",
+                     node->type_name ? node->type_name : "unknown");
+        return false;
+    }
+
+    if (types & SCHEMA_TYPE_NUMBER) {
+        if ((node->flags & SCHEMA_FLAG_MINIMUM) && value->valuedouble < node->minimum) {
+            schema_error(error, "minimum", "%s", "Value is below the minimum");
+            return false;
+        }
+        if ((node->flags & SCHEMA_FLAG_MAXIMUM) && value->valuedouble > node->maximum) {
+            schema_error(error, "maximum", "%s", "Value is above the maximum");
+            return false;
+        }
+    }
+
+    if ((types & SCHEMA_TYPE_OBJECT) && (node->types & SCHEMA_TYPE_OBJECT)) {
+        return schema_check_object(program, node, value, error);
+    }
+
+    if ((types & SCHEMA_TYPE_ARRAY) && node->items != SCHEMA_NO_NODE) {
+        int i = 0;
+        const cJSON *element;
+        cJSON_ArrayForEach(element, value) {
+            if (!schema_check_node(program, node->items, element, error)) {
+                if (error) {
+                    snprintf(error->message, sizeof(error->message), "Array item %d is invalid", i);
+                    mcp_schema_error_prepend_index(error, i);
+                }
+                return false;
+            }
+            i++;
+        }
+    }
+
+    return true;
+}
+
+bool mcp_schema_validate(const mcp_schema_program_t *program, const cJSON *value,
+                         mcp_schema_error_t *error) {
+    mcp_schema_error_init(error);
+    if (!program) return true;
+    if (!value) {
+        schema_error(error, "", "%s", "No value provided");
+        return false;
+    }
+
+    return schema_check_node(program, 0, value, error);
+}
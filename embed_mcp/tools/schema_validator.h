@@ -0,0 +1,41 @@
+#ifndef MCP_SCHEMA_VALIDATOR_H
+#define MCP_SCHEMA_VALIDATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "cjson/cJSON.h"
+
+// Compiled JSON Schema validator.
+// A schema is translated once into a flat program: one node per (sub)schema with a
+// type mask, numeric bounds, a hashed property table and a required-property bitset.
+// Validation then makes a single pass over each argument object, with no lookups in
+// the schema tree. Supported keywords are the ones the tree validator understands
+// (type, properties, required, additionalProperties, items) plus minimum/maximum;
+// other keywords are ignored. Property names are borrowed from the schema, which
+// must outlive the program.
+typedef struct mcp_schema_program mcp_schema_program_t;
+
+// Where and why validation failed, filled in by the caller's validator call.
+// message keeps the top-level wording ("Invalid property 'x'"); path and keyword
+// point at the innermost value that failed.
+typedef struct {
+    char path[128];         // JSON Pointer into the validated value, "" for the value itself
+    const char *keyword;    // Failing schema keyword ("type", "required", ...), "" if none
+    char message[256];
+} mcp_schema_error_t;
+
+void mcp_schema_error_init(mcp_schema_error_t *error);
+// Prefix path with one reference token ("/" + segment, escaped); used while unwinding
+void mcp_schema_error_prepend_path(mcp_schema_error_t *error, const char *segment);
+void mcp_schema_error_prepend_index(mcp_schema_error_t *error, int index);
+
+// Returns NULL if the schema is not an object or memory runs out
+mcp_schema_program_t *mcp_schema_compile(const cJSON *schema);
+void mcp_schema_program_destroy(mcp_schema_program_t *program);
+
+// Returns true if value matches; otherwise fills in error (if not NULL).
+// Holds no state between calls, so one program may validate on many threads at once.
+bool mcp_schema_validate(const mcp_schema_program_t *program, const cJSON *value,
+                         mcp_schema_error_t *error);
+
+#endif // MCP_SCHEMA_VALIDATOR_H
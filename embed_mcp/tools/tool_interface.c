@@ -1,27 +1,28 @@
 #include "tools/tool_interface.h"
+#include "utils/json_buffer.h"
+#include "utils/atomic.h"
+#include "utils/logging.h"
+#include "utils/arena.h"
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJSON *schema);
+static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJSON *schema,
+                                                    mcp_schema_error_t *error);
 
-static char g_validation_error_message[512] = {0};
-
-static void set_validation_errorf(const char *fmt, const char *detail) {
-    if (!fmt) {
-        snprintf(g_validation_error_message, sizeof(g_validation_error_message), "Validation failed");
-        return;
-    }
-    snprintf(g_validation_error_message, sizeof(g_validation_error_message), fmt, detail ? detail : "");
-}
-
-static void clear_validation_error(void) {
-    g_validation_error_message[0] = '\0';
+// Validation errors go to the caller's context, so concurrent validations never share state
+static void set_validation_errorf(mcp_schema_error_t *error, const char *keyword,
+                                  const char *fmt, const char *detail) {
+    if (!error) return;
+    error->keyword = keyword;
+    snprintf(error->message, sizeof(error->message), fmt, detail ? detail : "");
 }
 
-static bool mcp_tool_validate_array_against_schema(const cJSON *value, const cJSON *schema) {
+static bool mcp_tool_validate_array_against_schema(const cJSON *value, const cJSON *schema,
+                                                   mcp_schema_error_t *error) {
     if (!cJSON_IsArray(value)) {
-        set_validation_errorf("Expected array value", NULL);
+        set_validation_errorf(error, "type", "Expected array value", NULL);
         return false;
     }
 
@@ -33,10 +34,11 @@ static bool mcp_tool_validate_array_against_schema(const cJSON *value, const cJS
     int count = cJSON_GetArraySize(value);
     for (int i = 0; i < count; i++) {
         cJSON *element = cJSON_GetArrayItem(value, i);
-        if (!mcp_tool_validate_parameter_against_schema(element, items)) {
-            char msg[64];
-            snprintf(msg, sizeof(msg), "Array item %d is invalid", i);
-            set_validation_errorf("%s", msg);
+        if (!mcp_tool_validate_parameter_with_context(element, items, error)) {
+            if (error) {
+                snprintf(error->message, sizeof(error->message), "Array item %d is invalid", i);
+                mcp_schema_error_prepend_index(error, i);
+            }
             return false;
         }
     }
@@ -44,9 +46,10 @@ static bool mcp_tool_validate_array_against_schema(const cJSON *value, const cJS
     return true;
 }
 
-static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJSON *schema) {
+static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJSON *schema,
+                                                    mcp_schema_error_t *error) {
     if (!cJSON_IsObject(value)) {
-        set_validation_errorf("Expected object value", NULL);
+        set_validation_errorf(error, "type", "Expected object value", NULL);
         return false;
     }
 
@@ -59,9 +62,8 @@ static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJ
                 continue;
             }
             if (!cJSON_HasObjectItem(value, required_name->valuestring)) {
-                char msg[128];
-                snprintf(msg, sizeof(msg), "Missing required property '%s'", required_name->valuestring);
-                set_validation_errorf("%s", msg);
+                set_validation_errorf(error, "required", "Missing required property '%s'",
+                                      required_name->valuestring);
                 return false;
             }
         }
@@ -88,18 +90,18 @@ static bool mcp_tool_validate_object_against_schema(const cJSON *value, const cJ
 
         if (!property_schema) {
             if (!allow_additional) {
-                char msg[128];
-                snprintf(msg, sizeof(msg), "Unexpected property '%s'", key);
-                set_validation_errorf("%s", msg);
+                set_validation_errorf(error, "additionalProperties", "Unexpected property '%s'", key);
+                mcp_schema_error_prepend_path(error, key);
                 return false;
             }
             continue;
         }
 
-        if (!mcp_tool_validate_parameter_against_schema(entry, property_schema)) {
-            char msg[160];
-            snprintf(msg, sizeof(msg), "Invalid property '%s'", key);
-            set_validation_errorf("%s", msg);
+        if (!mcp_tool_validate_parameter_with_context(entry, property_schema, error)) {
+            if (error) {
+                set_validation_errorf(error, error->keyword, "Invalid property '%s'", key);
+                mcp_schema_error_prepend_path(error, key);
+            }
             return false;
         }
     }
@@ -163,6 +165,31 @@ mcp_tool_t *mcp_tool_create_full(const char *name,
     return tool;
 }
 
+// Placeholder for the synchronous handler of an async-only tool; never called, since
+// mcp_tool_set_async() refuses to clear is_async without a real handler
+static cJSON *tool_async_only_execute(const cJSON *parameters, void *user_data) {
+    (void)parameters;
+    (void)user_data;
+    return mcp_tool_create_error_result(MCP_TOOL_ERROR_INTERNAL, "Tool only runs asynchronously", NULL);
+}
+
+mcp_tool_t *mcp_tool_create_async(const char *name,
+                                 const char *title,
+                                 const char *description,
+                                 const cJSON *input_schema,
+                                 mcp_tool_async_execute_func_t execute_async_func,
+                                 void *user_data) {
+    if (!execute_async_func) return NULL;
+
+    mcp_tool_t *tool = mcp_tool_create_full(name, title, description, input_schema, NULL,
+                                            tool_async_only_execute, NULL, NULL, user_data);
+    if (!tool) return NULL;
+
+    tool->execute_async = execute_async_func;
+    tool->is_async = true;
+    return tool;
+}
+
 void mcp_tool_destroy(mcp_tool_t *tool) {
     if (!tool) return;
     
@@ -178,6 +205,7 @@ void mcp_tool_destroy(mcp_tool_t *tool) {
     free(tool->author);
     free(tool->category);
     
+    mcp_schema_program_destroy(tool->input_program);
     if (tool->input_schema) cJSON_Delete(tool->input_schema);
     if (tool->output_schema) cJSON_Delete(tool->output_schema);
     
@@ -188,15 +216,14 @@ void mcp_tool_destroy(mcp_tool_t *tool) {
 mcp_tool_t *mcp_tool_ref(mcp_tool_t *tool) {
     if (!tool) return NULL;
     
-    tool->ref_count++;
+    MCP_REF_INC(&tool->ref_count);
     return tool;
 }
 
 void mcp_tool_unref(mcp_tool_t *tool) {
     if (!tool) return;
     
-    tool->ref_count--;
-    if (tool->ref_count <= 0) {
+    if (MCP_REF_DEC(&tool->ref_count) <= 0) {
         mcp_tool_destroy(tool);
     }
 }
@@ -252,11 +279,28 @@ int mcp_tool_set_category(mcp_tool_t *tool, const char *category) {
 
 int mcp_tool_set_async(mcp_tool_t *tool, bool is_async) {
     if (!tool) return -1;
+    if (is_async && !tool->execute_async) return -1;
+    if (!is_async && tool->execute == tool_async_only_execute) return -1;
     
     tool->is_async = is_async;
     return 0;
 }
 
+int mcp_tool_set_async_handler(mcp_tool_t *tool, mcp_tool_async_execute_func_t execute_async_func) {
+    if (!tool || !execute_async_func) return -1;
+
+    tool->execute_async = execute_async_func;
+    tool->is_async = true;
+    return 0;
+}
+
+int mcp_tool_set_batch_handler(mcp_tool_t *tool, mcp_tool_batch_execute_func_t execute_batch_func) {
+    if (!tool || !execute_batch_func) return -1;
+
+    tool->execute_batch = execute_batch_func;
+    return 0;
+}
+
 int mcp_tool_set_dangerous(mcp_tool_t *tool, bool is_dangerous) {
     if (!tool) return -1;
     
@@ -296,26 +340,152 @@ bool mcp_tool_is_dangerous(const mcp_tool_t *tool) {
 }
 
 // Tool execution
-cJSON *mcp_tool_execute(const mcp_tool_t *tool, const cJSON *parameters) {
-    if (!tool || !tool->execute) {
-        return mcp_tool_create_error_result(MCP_TOOL_ERROR_INTERNAL, "Tool or execute function is null", NULL);
-    }
-    
+struct mcp_tool_completion {
+    cJSON *parameters;                  // Heap copy handed to the tool
+    const int *cancelled;               // Caller's cancellation flag, may be NULL
+    mcp_tool_completion_func_t on_complete;
+    void *context;
+};
+
+// Cancellation flag of the synchronous call running on each thread
+static pthread_key_t g_cancel_key;
+static pthread_once_t g_cancel_key_once = PTHREAD_ONCE_INIT;
+static bool g_cancel_key_created = false;
+
+static void tool_cancel_key_create(void) {
+    g_cancel_key_created = (pthread_key_create(&g_cancel_key, NULL) == 0);
+}
+
+bool mcp_tool_cancel_requested(void) {
+    if (!g_cancel_key_created) return false;
+
+    const int *cancelled = pthread_getspecific(g_cancel_key);
+    return cancelled && MCP_ATOMIC_LOAD(cancelled) != 0;
+}
+
+bool mcp_tool_completion_cancelled(const mcp_tool_completion_t *completion) {
+    return completion && completion->cancelled && MCP_ATOMIC_LOAD(completion->cancelled) != 0;
+}
+
+// Blocking wait for an async tool run through mcp_tool_execute()
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    cJSON *result;
+    bool done;
+} tool_sync_wait_t;
+
+static void tool_sync_wait_complete(cJSON *result, void *context) {
+    tool_sync_wait_t *wait = (tool_sync_wait_t*)context;
+
+    pthread_mutex_lock(&wait->mutex);
+    wait->result = result;
+    wait->done = true;
+    pthread_cond_signal(&wait->cond);
+    pthread_mutex_unlock(&wait->mutex);
+}
+
+// Returns an error result if the parameters are rejected, NULL if they may be used
+static cJSON *tool_check_parameters(const mcp_tool_t *tool, const cJSON *parameters) {
     // Validate parameters if validation function is provided
     if (tool->validate && !tool->validate(parameters, tool->user_data)) {
         return mcp_tool_create_validation_error("Parameter validation failed");
     }
     
-    // Validate against input schema if provided
-    if (tool->input_schema && !mcp_tool_validate_parameter_against_schema(parameters, tool->input_schema)) {
-        char *error_msg = mcp_tool_get_validation_error_message(parameters, tool->input_schema);
-        cJSON *result = mcp_tool_create_validation_error(error_msg ? error_msg : "Schema validation failed");
-        free(error_msg);
-        return result;
+    // Validate against input schema if provided, preferably with the compiled program
+    mcp_schema_error_t error;
+    bool valid = true;
+    if (tool->input_program) {
+        valid = mcp_schema_validate(tool->input_program, parameters, &error);
+    } else if (tool->input_schema) {
+        mcp_schema_error_init(&error);
+        valid = mcp_tool_validate_parameter_with_context(parameters, tool->input_schema, &error);
+    }
+    if (!valid) {
+        mcp_log(MCP_LOG_LEVEL_DEBUG, "Tool '%s': invalid arguments at '%s' (%s): %s",
+                tool->name, error.path, error.keyword, error.message);
+        return mcp_tool_create_validation_error(error.message[0] ? error.message : "Schema validation failed");
+    }
+
+    return NULL;
+}
+
+// Parameters must have been checked already
+static void tool_start_async(const mcp_tool_t *tool, const cJSON *parameters, const int *cancelled,
+                             mcp_tool_completion_func_t on_complete, void *context) {
+    // The tool keeps the parameters past the request, so they are copied to the heap
+    mcp_tool_completion_t *completion = calloc(1, sizeof(mcp_tool_completion_t));
+    if (completion && parameters) {
+        bool saved = mcp_arena_suspend();
+        completion->parameters = cJSON_Duplicate(parameters, 1);
+        mcp_arena_resume(saved);
+    }
+    if (!completion || (parameters && !completion->parameters)) {
+        free(completion);
+        on_complete(mcp_tool_create_error_result(MCP_TOOL_ERROR_MEMORY, "Out of memory", NULL), context);
+        return;
+    }
+
+    completion->cancelled = cancelled;
+    completion->on_complete = on_complete;
+    completion->context = context;
+    tool->execute_async(completion->parameters, completion, tool->user_data);
+}
+
+// Make cancelled the flag mcp_tool_cancel_requested() reads on this thread; returns
+// the flag it replaces, to be put back by tool_cancel_restore()
+static const void *tool_cancel_publish(const int *cancelled) {
+    if (!cancelled) return NULL;
+
+    pthread_once(&g_cancel_key_once, tool_cancel_key_create);
+    if (!g_cancel_key_created) return NULL;
+
+    const void *outer = pthread_getspecific(g_cancel_key);
+    pthread_setspecific(g_cancel_key, cancelled);
+    return outer;
+}
+
+static void tool_cancel_restore(const int *cancelled, const void *outer) {
+    if (cancelled && g_cancel_key_created) {
+        pthread_setspecific(g_cancel_key, outer);
+    }
+}
+
+cJSON *mcp_tool_execute(const mcp_tool_t *tool, const cJSON *parameters) {
+    return mcp_tool_execute_cancellable(tool, parameters, NULL);
+}
+
+cJSON *mcp_tool_execute_cancellable(const mcp_tool_t *tool, const cJSON *parameters,
+                                    const int *cancelled) {
+    if (!tool || !tool->execute) {
+        return mcp_tool_create_error_result(MCP_TOOL_ERROR_INTERNAL, "Tool or execute function is null", NULL);
+    }
+
+    cJSON *error = tool_check_parameters(tool, parameters);
+    if (error) return error;
+
+    if (tool->is_async && tool->execute_async) {
+        tool_sync_wait_t wait = { .result = NULL, .done = false };
+        pthread_mutex_init(&wait.mutex, NULL);
+        pthread_cond_init(&wait.cond, NULL);
+
+        tool_start_async(tool, parameters, cancelled, tool_sync_wait_complete, &wait);
+
+        pthread_mutex_lock(&wait.mutex);
+        while (!wait.done) {
+            pthread_cond_wait(&wait.cond, &wait.mutex);
+        }
+        pthread_mutex_unlock(&wait.mutex);
+
+        pthread_cond_destroy(&wait.cond);
+        pthread_mutex_destroy(&wait.mutex);
+        return wait.result;
     }
     
-    // Execute the tool
+    // Execute the tool, publishing the flag for mcp_tool_cancel_requested()
+    const void *outer = tool_cancel_publish(cancelled);
     cJSON *result = tool->execute(parameters, tool->user_data);
+    tool_cancel_restore(cancelled, outer);
     
     // If no result returned, create an error
     if (!result) {
@@ -325,6 +495,91 @@ cJSON *mcp_tool_execute(const mcp_tool_t *tool, const cJSON *parameters) {
     return result;
 }
 
+int mcp_tool_execute_batch(const mcp_tool_t *tool, const cJSON *const *parameters, size_t count,
+                           const int *cancelled, cJSON **results) {
+    if (!tool || !results || (count > 0 && !parameters)) return -1;
+
+    // Valid argument sets and where their results go
+    const cJSON **batch = NULL;
+    size_t *positions = NULL;
+    cJSON **batch_results = NULL;
+    if (tool->execute_batch && !tool->is_async && count > 0) {
+        batch = malloc(count * sizeof(cJSON*));
+        positions = malloc(count * sizeof(size_t));
+        batch_results = calloc(count, sizeof(cJSON*));
+    }
+    if (!batch || !positions || !batch_results) {
+        free(batch);
+        free(positions);
+        free(batch_results);
+        for (size_t i = 0; i < count; i++) {
+            results[i] = mcp_tool_execute_cancellable(tool, parameters[i], cancelled);
+        }
+        return 0;
+    }
+
+    size_t batch_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        results[i] = tool_check_parameters(tool, parameters[i]);
+        if (!results[i]) {
+            batch[batch_count] = parameters[i];
+            positions[batch_count++] = i;
+        }
+    }
+
+    if (batch_count > 0) {
+        const void *outer = tool_cancel_publish(cancelled);
+        tool->execute_batch(batch, batch_count, batch_results, tool->user_data);
+        tool_cancel_restore(cancelled, outer);
+    }
+
+    for (size_t k = 0; k < batch_count; k++) {
+        results[positions[k]] = batch_results[k] ? batch_results[k] :
+                                mcp_tool_create_execution_error("Tool execution returned null result");
+    }
+
+    free(batch);
+    free(positions);
+    free(batch_results);
+    return 0;
+}
+
+int mcp_tool_execute_async(const mcp_tool_t *tool, const cJSON *parameters, const int *cancelled,
+                           mcp_tool_completion_func_t on_complete, void *context) {
+    if (!tool || !on_complete) return -1;
+
+    if (!tool->is_async || !tool->execute_async) {
+        on_complete(mcp_tool_execute_cancellable(tool, parameters, cancelled), context);
+        return 0;
+    }
+
+    cJSON *error = tool_check_parameters(tool, parameters);
+    if (error) {
+        on_complete(error, context);
+        return 0;
+    }
+
+    tool_start_async(tool, parameters, cancelled, on_complete, context);
+    return 0;
+}
+
+int mcp_tool_complete(mcp_tool_completion_t *completion, cJSON *result) {
+    if (!completion) {
+        cJSON_Delete(result);
+        return -1;
+    }
+
+    if (!result) {
+        result = mcp_tool_create_execution_error("Tool execution returned null result");
+    }
+
+    completion->on_complete(result, completion->context);
+
+    cJSON_Delete(completion->parameters);
+    free(completion);
+    return 0;
+}
+
 bool mcp_tool_validate_parameters(const mcp_tool_t *tool, const cJSON *parameters) {
     if (!tool) return false;
     
@@ -334,6 +589,9 @@ bool mcp_tool_validate_parameters(const mcp_tool_t *tool, const cJSON *parameter
     }
     
     // Use schema validation if available
+    if (tool->input_program) {
+        return mcp_schema_validate(tool->input_program, parameters, NULL);
+    }
     if (tool->input_schema) {
         return mcp_tool_validate_parameter_against_schema(parameters, tool->input_schema);
     }
@@ -342,6 +600,14 @@ bool mcp_tool_validate_parameters(const mcp_tool_t *tool, const cJSON *parameter
     return true;
 }
 
+int mcp_tool_compile_input_schema(mcp_tool_t *tool) {
+    if (!tool) return -1;
+    if (!tool->input_schema || tool->input_program) return 0;
+
+    tool->input_program = mcp_schema_compile(tool->input_schema);
+    return tool->input_program ? 0 : -1;
+}
+
 // Tool serialization
 cJSON *mcp_tool_to_json(const mcp_tool_t *tool) {
     if (!tool) return NULL;
@@ -574,9 +840,14 @@ bool mcp_tool_validate_parameter_type(const cJSON *value, const char *expected_t
 }
 
 bool mcp_tool_validate_parameter_against_schema(const cJSON *value, const cJSON *schema) {
+    return mcp_tool_validate_parameter_with_context(value, schema, NULL);
+}
+
+bool mcp_tool_validate_parameter_with_context(const cJSON *value, const cJSON *schema,
+                                              mcp_schema_error_t *error) {
     if (!schema) return true; // No schema means no validation
     if (!value) {
-        set_validation_errorf("No value provided", NULL);
+        set_validation_errorf(error, "", "No value provided", NULL);
         return false;
     }
 
@@ -584,18 +855,17 @@ bool mcp_tool_validate_parameter_against_schema(const cJSON *value, const cJSON
     cJSON *type = cJSON_GetObjectItem(schema, "type");
     if (type && cJSON_IsString(type)) {
         if (!mcp_tool_validate_parameter_type(value, type->valuestring)) {
-            char msg[160];
-            snprintf(msg, sizeof(msg), "Expected type '%s' but got different type", type->valuestring);
-            set_validation_errorf("%s", msg);
+            set_validation_errorf(error, "type", "Expected type '%s' but got different type",
+                                  type->valuestring);
             return false;
         }
 
         if (strcmp(type->valuestring, "object") == 0) {
-            return mcp_tool_validate_object_against_schema(value, schema);
+            return mcp_tool_validate_object_against_schema(value, schema, error);
         }
 
         if (strcmp(type->valuestring, "array") == 0) {
-            return mcp_tool_validate_array_against_schema(value, schema);
+            return mcp_tool_validate_array_against_schema(value, schema, error);
         }
     }
 
@@ -605,14 +875,14 @@ bool mcp_tool_validate_parameter_against_schema(const cJSON *value, const cJSON
 }
 
 char *mcp_tool_get_validation_error_message(const cJSON *value, const cJSON *schema) {
-    clear_validation_error();
-
     if (!schema) return strdup("No schema provided");
     if (!value) return strdup("No value provided");
 
-    if (!mcp_tool_validate_parameter_against_schema(value, schema)) {
-        if (g_validation_error_message[0] != '\0') {
-            return strdup(g_validation_error_message);
+    mcp_schema_error_t error;
+    mcp_schema_error_init(&error);
+    if (!mcp_tool_validate_parameter_with_context(value, schema, &error)) {
+        if (error.message[0] != '\0') {
+            return strdup(error.message);
         }
         return strdup("Validation failed");
     }
@@ -684,39 +954,68 @@ cJSON *mcp_tool_create_memory_error(void) {
 }
 
 // Success result creation
-cJSON *mcp_tool_create_success_result(cJSON *data) {
+cJSON *mcp_tool_create_structured_result(cJSON *data, bool text_mirror) {
     cJSON *result = cJSON_CreateObject();
-    if (!result) return NULL;
+    if (!result) {
+        cJSON_Delete(data);
+        return NULL;
+    }
 
     // Create content array according to MCP spec
-    cJSON *content = cJSON_CreateArray();
+    cJSON *content = cJSON_AddArrayToObject(result, "content");
     if (!content) {
         cJSON_Delete(result);
+        cJSON_Delete(data);
         return NULL;
     }
 
     // Create text content block
-    cJSON *text_block = cJSON_CreateObject();
-    cJSON_AddStringToObject(text_block, "type", "text");
-
-    if (data) {
-        // Convert data to string representation
-        char *data_str = cJSON_Print(data);
-        cJSON_AddStringToObject(text_block, "text", data_str ? data_str : "{}");
-        if (data_str) free(data_str);
-    } else {
-        cJSON_AddStringToObject(text_block, "text", "Success");
+    cJSON *text_block = NULL;
+    if (!data || text_mirror) {
+        text_block = cJSON_CreateObject();
+        cJSON_AddStringToObject(text_block, "type", "text");
+        cJSON_AddItemToArray(content, text_block);
     }
 
-    cJSON_AddItemToArray(content, text_block);
-    cJSON_AddItemToObject(result, "content", content);
+    if (!data) {
+        cJSON_AddStringToObject(text_block, "text", "Success");
+    } else if (text_mirror) {
+        // Render the payload once (compact) into the thread's buffer. The text block keeps
+        // that rendering and structuredContent emits the same bytes raw, so the payload is
+        // not serialized a second time when the response is written.
+        mcp_json_buffer_t *buffer = mcp_json_buffer_thread_local();
+        cJSON *text = NULL;
+        cJSON *raw = NULL;
+        if (buffer && mcp_json_buffer_print(buffer, data, false) == 0) {
+            text = cJSON_AddStringToObject(text_block, "text", buffer->data);
+        }
+        if (text) {
+            raw = cJSON_CreateStringReference(text->valuestring);
+        }
 
-    // Add structured content if data provided
-    if (data) {
-        cJSON_AddItemToObject(result, "structuredContent", cJSON_Duplicate(data, 1));
+        if (raw) {
+            raw->type = cJSON_Raw | cJSON_IsReference;
+            cJSON_AddItemToObject(result, "structuredContent", raw);
+            cJSON_Delete(data);
+        } else {
+            if (!text) cJSON_AddStringToObject(text_block, "text", "{}");
+            cJSON_AddItemToObject(result, "structuredContent", data);
+        }
+    } else {
+        // The payload itself moves into structuredContent
+        cJSON_AddItemToObject(result, "structuredContent", data);
     }
 
     cJSON_AddBoolToObject(result, "isError", false);
 
     return result;
 }
+
+cJSON *mcp_tool_create_success_result(cJSON *data) {
+    cJSON *copy = NULL;
+    if (data) {
+        copy = cJSON_Duplicate(data, 1);
+        if (!copy) return NULL;
+    }
+    return mcp_tool_create_structured_result(copy, true);
+}
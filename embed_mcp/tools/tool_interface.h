@@ -4,13 +4,31 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "cjson/cJSON.h"
+#include "schema_validator.h"
 
 // Forward declarations
 typedef struct mcp_tool mcp_tool_t;
+typedef struct mcp_tool_completion mcp_tool_completion_t;
 
 // Tool execution function type
 typedef cJSON *(*mcp_tool_execute_func_t)(const cJSON *parameters, void *user_data);
 
+// Asynchronous tool execution function type.
+// Starts the work and returns at once; the result is handed to mcp_tool_complete(),
+// from any thread. parameters belong to the completion and stay valid until then.
+typedef void (*mcp_tool_async_execute_func_t)(const cJSON *parameters,
+                                              mcp_tool_completion_t *completion,
+                                              void *user_data);
+
+// Batch execution function type: results[i] receives the result for parameters[i],
+// i < count, all in one invocation (e.g. a kernel processing the argument sets together).
+// The parameters have been validated. A NULL result is reported as an execution error.
+typedef void (*mcp_tool_batch_execute_func_t)(const cJSON *const *parameters, size_t count,
+                                              cJSON **results, void *user_data);
+
+// Receives the result of an asynchronous execution (and owns it)
+typedef void (*mcp_tool_completion_func_t)(cJSON *result, void *context);
+
 // Tool validation function type
 typedef bool (*mcp_tool_validate_func_t)(const cJSON *parameters, void *user_data);
 
@@ -27,9 +45,12 @@ struct mcp_tool {
     // Schema definition
     cJSON *input_schema;
     cJSON *output_schema;
+    mcp_schema_program_t *input_program;    // Compiled input_schema, NULL until compiled
     
     // Function pointers
     mcp_tool_execute_func_t execute;
+    mcp_tool_async_execute_func_t execute_async;    // Used instead of execute while is_async is set
+    mcp_tool_batch_execute_func_t execute_batch;    // Optional, for several calls at once
     mcp_tool_validate_func_t validate;  // Optional
     mcp_tool_cleanup_func_t cleanup;    // Optional
     
@@ -69,6 +90,14 @@ mcp_tool_t *mcp_tool_create_full(const char *name,
                                 mcp_tool_cleanup_func_t cleanup_func,
                                 void *user_data);
 
+// Tool whose only handler is asynchronous (is_async is set)
+mcp_tool_t *mcp_tool_create_async(const char *name,
+                                 const char *title,
+                                 const char *description,
+                                 const cJSON *input_schema,
+                                 mcp_tool_async_execute_func_t execute_async_func,
+                                 void *user_data);
+
 void mcp_tool_destroy(mcp_tool_t *tool);
 
 // Tool reference counting
@@ -86,7 +115,11 @@ const cJSON *mcp_tool_get_output_schema(const mcp_tool_t *tool);
 int mcp_tool_set_version(mcp_tool_t *tool, const char *version);
 int mcp_tool_set_author(mcp_tool_t *tool, const char *author);
 int mcp_tool_set_category(mcp_tool_t *tool, const char *category);
+// Switch between the async and the synchronous handler; fails if the tool lacks that handler
 int mcp_tool_set_async(mcp_tool_t *tool, bool is_async);
+int mcp_tool_set_async_handler(mcp_tool_t *tool, mcp_tool_async_execute_func_t execute_async_func);
+// Lone calls still go through execute, which may simply run a batch of one
+int mcp_tool_set_batch_handler(mcp_tool_t *tool, mcp_tool_batch_execute_func_t execute_batch_func);
 int mcp_tool_set_dangerous(mcp_tool_t *tool, bool is_dangerous);
 int mcp_tool_set_execution_constraints(mcp_tool_t *tool,
                                       size_t max_execution_time_ms,
@@ -99,8 +132,38 @@ bool mcp_tool_is_async(const mcp_tool_t *tool);
 bool mcp_tool_is_dangerous(const mcp_tool_t *tool);
 
 // Tool execution
+// Async tools are run to completion here, blocking the caller until they complete
 cJSON *mcp_tool_execute(const mcp_tool_t *tool, const cJSON *parameters);
+// cancelled (may be NULL) is set non-zero by the caller, from any thread, when it gives
+// up on the call; the tool can poll it through mcp_tool_cancel_requested() or
+// mcp_tool_completion_cancelled() and stop early. It must stay valid until the call ends.
+cJSON *mcp_tool_execute_cancellable(const mcp_tool_t *tool, const cJSON *parameters,
+                                    const int *cancelled);
+// Hands the result to on_complete(result, context) exactly once. An async tool returns
+// right after starting and completes later on whichever thread finishes it; any other
+// outcome (synchronous tool, invalid parameters) is delivered before this returns.
+// Returns -1 without calling on_complete if tool or on_complete is NULL.
+int mcp_tool_execute_async(const mcp_tool_t *tool, const cJSON *parameters, const int *cancelled,
+                           mcp_tool_completion_func_t on_complete, void *context);
+// Run several calls of one tool: results[i] (owned by the caller) for parameters[i].
+// With a batch handler the valid argument sets go to it in one invocation and invalid
+// ones get their validation error; otherwise the calls run one by one. cancelled as
+// above, shared by the whole batch. Returns -1 on invalid arguments.
+int mcp_tool_execute_batch(const mcp_tool_t *tool, const cJSON *const *parameters, size_t count,
+                           const int *cancelled, cJSON **results);
+// Deliver the result of an async execution; takes ownership of result (NULL reports an
+// execution error). Must be called exactly once per completion, from any thread. A result
+// built on another thread must not come from a request arena (build it where you complete).
+int mcp_tool_complete(mcp_tool_completion_t *completion, cJSON *result);
+// Cooperative cancellation: true once the caller gave up on the call (deadline passed),
+// so the tool can stop; whatever it returns afterwards is discarded.
+// The first form is for synchronous tools and reads the call running on this thread.
+bool mcp_tool_cancel_requested(void);
+bool mcp_tool_completion_cancelled(const mcp_tool_completion_t *completion);
 bool mcp_tool_validate_parameters(const mcp_tool_t *tool, const cJSON *parameters);
+// Compile input_schema for validation (done by the registry at registration).
+// The schema must not change afterwards. Returns 0 on success or if there is no schema.
+int mcp_tool_compile_input_schema(mcp_tool_t *tool);
 
 // Tool serialization
 cJSON *mcp_tool_to_json(const mcp_tool_t *tool);
@@ -123,6 +186,9 @@ cJSON *mcp_tool_create_boolean_schema(const char *description);
 // Parameter validation utilities
 bool mcp_tool_validate_parameter_type(const cJSON *value, const char *expected_type);
 bool mcp_tool_validate_parameter_against_schema(const cJSON *value, const cJSON *schema);
+// Same, reporting the failure into error (may be NULL); safe to call from many threads
+bool mcp_tool_validate_parameter_with_context(const cJSON *value, const cJSON *schema,
+                                              mcp_schema_error_t *error);
 char *mcp_tool_get_validation_error_message(const cJSON *value, const cJSON *schema);
 
 // Error result creation
@@ -133,6 +199,11 @@ cJSON *mcp_tool_create_timeout_error(void);
 cJSON *mcp_tool_create_memory_error(void);
 
 // Success result creation
+// Takes ownership of data. Without text_mirror data moves into structuredContent as is.
+// With text_mirror data is rendered once as compact JSON: the content array carries that
+// text and structuredContent is a raw node borrowing it, so the two stay byte-identical.
+cJSON *mcp_tool_create_structured_result(cJSON *data, bool text_mirror);
+// Same as above with the text mirror, but copies data (the caller keeps ownership)
 cJSON *mcp_tool_create_success_result(cJSON *data);
 
 
@@ -2,10 +2,127 @@
 #include "tools/builtin_tools.h"
 #include "hal/platform_hal.h"
 #include "utils/logging.h"
+#include "utils/atomic.h"
+#include "utils/json_buffer.h"
+#include "utils/timer_wheel.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#define TOOL_INDEX_MIN_CAPACITY 16
+#define TOOL_INDEX_NOT_FOUND ((size_t)-1)
+
+// Name index: open addressing with linear probing over precomputed FNV-1a hashes
+static uint32_t tool_name_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void tool_index_put(mcp_tool_index_slot_t *index, size_t capacity, mcp_tool_entry_t *entry) {
+    size_t mask = capacity - 1;
+    size_t i = entry->name_hash & mask;
+    while (index[i].entry) {
+        i = (i + 1) & mask;
+    }
+    index[i].hash = entry->name_hash;
+    index[i].entry = entry;
+}
+
+// Grow the index so that count entries keep it at most half full
+static int tool_index_reserve(mcp_tool_registry_t *registry, size_t count) {
+    if (count * 2 <= registry->index_capacity) return 0;
+
+    size_t capacity = registry->index_capacity ? registry->index_capacity * 2 : TOOL_INDEX_MIN_CAPACITY;
+    while (count * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    mcp_tool_index_slot_t *index = calloc(capacity, sizeof(mcp_tool_index_slot_t));
+    if (!index) return -1;
+
+    for (size_t i = 0; i < registry->index_capacity; i++) {
+        if (registry->index[i].entry) {
+            tool_index_put(index, capacity, registry->index[i].entry);
+        }
+    }
+
+    free(registry->index);
+    registry->index = index;
+    registry->index_capacity = capacity;
+    return 0;
+}
+
+static size_t tool_index_find_slot(const mcp_tool_registry_t *registry, const char *tool_name) {
+    if (!registry->index) return TOOL_INDEX_NOT_FOUND;
+
+    uint32_t hash = tool_name_hash(tool_name);
+    size_t mask = registry->index_capacity - 1;
+    for (size_t i = hash & mask; registry->index[i].entry; i = (i + 1) & mask) {
+        if (registry->index[i].hash == hash &&
+            strcmp(mcp_tool_get_name(registry->index[i].entry->tool), tool_name) == 0) {
+            return i;
+        }
+    }
+    return TOOL_INDEX_NOT_FOUND;
+}
+
+// Backward-shift deletion keeps every probe sequence intact without tombstones
+static void tool_index_remove(mcp_tool_registry_t *registry, size_t slot) {
+    mcp_tool_index_slot_t *index = registry->index;
+    size_t mask = registry->index_capacity - 1;
+    size_t hole = slot;
+
+    index[hole].entry = NULL;
+    for (size_t i = (hole + 1) & mask; index[i].entry; i = (i + 1) & mask) {
+        size_t home = index[i].hash & mask;
+        // Move the entry back unless its home slot lies cyclically in (hole, i]
+        bool stays = (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!stays) {
+            index[hole] = index[i];
+            index[i].entry = NULL;
+            hole = i;
+        }
+    }
+}
+
+// Entries are shared by the registry and by calls in flight
+static void tool_entry_unref(mcp_tool_entry_t *entry) {
+    if (MCP_REF_DEC(&entry->ref_count) == 0) {
+        mcp_tool_unref(entry->tool);
+        mcp_result_cache_destroy(entry->cache);
+        free(entry->latency);
+        free(entry);
+    }
+}
+
+static uint64_t tool_clock_ns(void) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (hal && hal->time.get_monotonic_ns) {
+        return hal->time.get_monotonic_ns();
+    }
+    if (hal && hal->time.get_time_us) {
+        return hal->time.get_time_us() * 1000ull;
+    }
+    return 0;
+}
+
+static void tool_list_snapshot_destroy(mcp_tool_list_snapshot_t *snapshot) {
+    if (!snapshot) return;
+    free(snapshot->json);
+    free(snapshot->offsets);
+    free(snapshot->sequences);
+    free(snapshot);
+}
+
+// Call table, defined with the calls below
+static mcp_tool_call_table_t *tool_call_table_create(void);
+static void tool_call_table_unref(mcp_tool_call_table_t *table);
+
 // Tool registry lifecycle
 mcp_tool_registry_t *mcp_tool_registry_create(const mcp_tool_registry_config_t *config) {
     const mcp_platform_hal_t *hal = mcp_platform_get_hal();
@@ -38,6 +155,15 @@ mcp_tool_registry_t *mcp_tool_registry_create(const mcp_tool_registry_config_t *
         return NULL;
     }
     
+    // Deadlines are best effort: without the wheel thread calls simply run unbounded
+    registry->deadlines = mcp_timer_wheel_create(MCP_TIMER_WHEEL_DEFAULT_TICK_MS);
+    if (!registry->deadlines) {
+        mcp_log_warn("Tool registry: deadline timer unavailable, tool timeouts are not enforced");
+    }
+    
+    // Likewise, without the table calls run but cannot be cancelled
+    registry->calls = tool_call_table_create();
+    
     // Initialize tool storage
     registry->tools = NULL;
     registry->tool_count = 0;
@@ -65,15 +191,18 @@ void mcp_tool_registry_destroy(mcp_tool_registry_t *registry) {
     mcp_tool_entry_t *current = registry->tools;
     while (current) {
         mcp_tool_entry_t *next = current->next;
-        mcp_tool_unref(current->tool);
-        if (hal) {
-            hal->memory.free(current);
-        }
+        tool_entry_unref(current);
         current = next;
     }
+    free(registry->index);
+    tool_list_snapshot_destroy(registry->list_snapshot);
 
     pthread_rwlock_unlock(&registry->tools_lock);
 
+    // Calls still in flight keep the stopped wheel until they complete
+    mcp_timer_wheel_destroy(registry->deadlines);
+    tool_call_table_unref(registry->calls);
+
     // Cleanup thread safety
     pthread_rwlock_destroy(&registry->tools_lock);
     pthread_mutex_destroy(&registry->registry_mutex);
@@ -136,25 +265,42 @@ int mcp_tool_registry_register_tool(mcp_tool_registry_t *registry, mcp_tool_t *t
     
     // Create tool entry
     mcp_tool_entry_t *entry = calloc(1, sizeof(mcp_tool_entry_t));
-    if (!entry) {
+    if (entry && registry->config.enable_tool_stats) {
+        entry->latency = calloc(1, sizeof(mcp_histogram_t));
+    }
+    if (!entry || (registry->config.enable_tool_stats && !entry->latency) ||
+        tool_index_reserve(registry, registry->tool_count + 1) != 0) {
+        if (entry) free(entry->latency);
+        free(entry);
         pthread_rwlock_unlock(&registry->tools_lock);
         return -1;
     }
     
+    // Arguments are checked against the compiled schema from now on; the tree walk stays as fallback
+    if (mcp_tool_compile_input_schema(tool) != 0) {
+        mcp_log_warn("Tool '%s': input schema not compiled, using the tree validator", tool_name);
+    }
+    
     entry->tool = mcp_tool_ref(tool);
     entry->registered_time = time(NULL);
     entry->is_builtin = false; // Will be set by built-in tool registration
     entry->calls_made = 0;
     entry->calls_successful = 0;
     entry->calls_failed = 0;
+    entry->calls_timed_out = 0;
     entry->last_called = 0;
-    entry->total_execution_time = 0.0;
-    entry->average_execution_time = 0.0;
+    entry->total_execution_ns = 0;
+    entry->name_hash = tool_name_hash(tool_name);
+    entry->ref_count = 1;
     entry->next = registry->tools;
     
     registry->tools = entry;
+    tool_index_put(registry->index, registry->index_capacity, entry);
     registry->tool_count++;
     registry->total_tools_registered++;
+    registry->list_version++;
+    // Never reset, so it orders tools by registration for list cursors
+    entry->sequence = registry->total_tools_registered;
     
     pthread_rwlock_unlock(&registry->tools_lock);
     
@@ -168,39 +314,39 @@ int mcp_tool_registry_unregister_tool(mcp_tool_registry_t *registry, const char
     
     pthread_rwlock_wrlock(&registry->tools_lock);
     
-    mcp_tool_entry_t *prev = NULL;
-    mcp_tool_entry_t *current = registry->tools;
+    size_t slot = tool_index_find_slot(registry, tool_name);
+    if (slot == TOOL_INDEX_NOT_FOUND) {
+        pthread_rwlock_unlock(&registry->tools_lock);
+        mcp_log_error("Tool '%s' not found for unregistration", tool_name);
+        return -1;
+    }
     
-    while (current) {
-        if (strcmp(mcp_tool_get_name(current->tool), tool_name) == 0) {
-            // Remove from list
-            if (prev) {
-                prev->next = current->next;
-            } else {
-                registry->tools = current->next;
-            }
-            
-            // Cleanup entry
-            mcp_tool_unref(current->tool);
-            free(current);
-            
-            registry->tool_count--;
-            registry->tools_unregistered++;
-            
-            pthread_rwlock_unlock(&registry->tools_lock);
-            
-            mcp_log_debug("Tool '%s' unregistered successfully", tool_name);
-            return 0;
-        }
-        
-        prev = current;
-        current = current->next;
+    mcp_tool_entry_t *entry = registry->index[slot].entry;
+    tool_index_remove(registry, slot);
+    
+    // Remove from list
+    mcp_tool_entry_t **link = &registry->tools;
+    while (*link != entry) {
+        link = &(*link)->next;
     }
+    *link = entry->next;
+    
+    registry->tool_count--;
+    registry->tools_unregistered++;
+    registry->list_version++;
+    
+    // Keep the registry totals complete once the entry no longer shows up in the list
+    registry->total_calls_made += MCP_ATOMIC_LOAD(&entry->calls_made);
+    registry->total_calls_successful += MCP_ATOMIC_LOAD(&entry->calls_successful);
+    registry->total_calls_failed += MCP_ATOMIC_LOAD(&entry->calls_failed);
     
     pthread_rwlock_unlock(&registry->tools_lock);
     
-    mcp_log_error("Tool '%s' not found for unregistration", tool_name);
-    return -1;
+    // Calls still running keep the entry (and its tool) alive until they finish
+    tool_entry_unref(entry);
+    
+    mcp_log_debug("Tool '%s' unregistered successfully", tool_name);
+    return 0;
 }
 
 bool mcp_tool_registry_has_tool(const mcp_tool_registry_t *registry, const char *tool_name) {
@@ -233,68 +379,560 @@ mcp_tool_t *mcp_tool_registry_find_tool(const mcp_tool_registry_t *registry, con
 mcp_tool_entry_t *mcp_tool_registry_find_tool_entry(const mcp_tool_registry_t *registry, const char *tool_name) {
     if (!registry || !tool_name) return NULL;
     
-    mcp_tool_entry_t *current = registry->tools;
-    while (current) {
-        if (strcmp(mcp_tool_get_name(current->tool), tool_name) == 0) {
-            return current;
+    size_t slot = tool_index_find_slot(registry, tool_name);
+    return slot == TOOL_INDEX_NOT_FOUND ? NULL : registry->index[slot].entry;
+}
+
+// Tool execution
+mcp_tool_entry_t *mcp_tool_registry_acquire_entry(mcp_tool_registry_t *registry, const char *tool_name) {
+    if (!registry || !tool_name) return NULL;
+    
+    pthread_rwlock_rdlock(&registry->tools_lock);
+    
+    // The entry stays valid for the whole call, even if the tool is unregistered meanwhile
+    mcp_tool_entry_t *entry = mcp_tool_registry_find_tool_entry(registry, tool_name);
+    if (entry) {
+        MCP_REF_INC(&entry->ref_count);
+    }
+    
+    pthread_rwlock_unlock(&registry->tools_lock);
+    
+    return entry;
+}
+
+void mcp_tool_registry_release_entry(mcp_tool_entry_t *entry) {
+    if (entry) {
+        tool_entry_unref(entry);
+    }
+}
+
+// Update statistics - per-entry atomics, aggregated only when the stats are read
+static void tool_entry_record_call(mcp_tool_entry_t *entry, uint64_t execution_ns, const cJSON *result) {
+    MCP_ATOMIC_INC(&entry->calls_made);
+    MCP_ATOMIC_STORE(&entry->last_called, time(NULL));
+    MCP_ATOMIC_ADD(&entry->total_execution_ns, execution_ns);
+    mcp_histogram_record(entry->latency, execution_ns);
+    
+    // Check if the result indicates an error using MCP format
+    cJSON *is_error = cJSON_GetObjectItem(result, "isError");
+    if (result && (!is_error || !cJSON_IsTrue(is_error))) {
+        MCP_ATOMIC_INC(&entry->calls_successful);
+    } else {
+        MCP_ATOMIC_INC(&entry->calls_failed);
+    }
+}
+
+// Tool call in flight: holds the entry until the tool completes and, once armed,
+// races its deadline (and a cancellation) for the right to deliver the result
+typedef struct tool_call {
+    mcp_tool_entry_t *entry;
+    bool record_stats;
+    uint64_t start_ns;
+    mcp_tool_completion_func_t on_complete;     // NULL for synchronous calls
+    void *context;
+    mcp_result_cache_t *cache;                  // Set for sync tools completing through on_complete
+    uint64_t arguments_hash;
+    const cJSON *parameters;                    // Borrowed along with the cache, while the tool runs
+    mcp_timer_wheel_t *deadlines;               // Referenced while the deadline is armed
+    mcp_timer_t deadline;
+    int cancelled;                              // Flag the tool may poll
+    int timed_out;
+    int finished;                               // Claimed by whoever delivers the result
+    
+    // Link in the call table while keyed; async calls own their key copy
+    mcp_tool_call_table_t *table;
+    char *key;
+    struct tool_call *prev;
+    struct tool_call *next;
+} tool_call_t;
+
+// Keyed calls in flight. Async calls may complete after the registry is gone, so
+// the table is shared with them and freed by whoever drops the last reference.
+struct mcp_tool_call_table {
+    pthread_mutex_t mutex;
+    tool_call_t *head;
+    int ref_count;
+};
+
+static mcp_tool_call_table_t *tool_call_table_create(void) {
+    mcp_tool_call_table_t *table = calloc(1, sizeof(mcp_tool_call_table_t));
+    if (!table) return NULL;
+    
+    if (pthread_mutex_init(&table->mutex, NULL) != 0) {
+        free(table);
+        return NULL;
+    }
+    table->ref_count = 1;
+    return table;
+}
+
+static void tool_call_table_unref(mcp_tool_call_table_t *table) {
+    if (!table || MCP_REF_DEC(&table->ref_count) != 0) return;
+    
+    pthread_mutex_destroy(&table->mutex);
+    free(table);
+}
+
+static void tool_call_link(mcp_tool_call_table_t *table, tool_call_t *call, char *key) {
+    if (!table || !key) return;
+    
+    MCP_REF_INC(&table->ref_count);
+    call->table = table;
+    call->key = key;
+    
+    pthread_mutex_lock(&table->mutex);
+    call->prev = NULL;
+    call->next = table->head;
+    if (call->next) call->next->prev = call;
+    table->head = call;
+    pthread_mutex_unlock(&table->mutex);
+}
+
+static void tool_call_unlink(tool_call_t *call) {
+    mcp_tool_call_table_t *table = call->table;
+    if (!table) return;
+    
+    pthread_mutex_lock(&table->mutex);
+    if (call->prev) call->prev->next = call->next;
+    else table->head = call->next;
+    if (call->next) call->next->prev = call->prev;
+    pthread_mutex_unlock(&table->mutex);
+    
+    call->table = NULL;
+    tool_call_table_unref(table);
+}
+
+// Effective budget: the tool's own limit, capped by the registry's (0 = none)
+static uint64_t tool_call_budget_ms(const mcp_tool_registry_t *registry, const mcp_tool_t *tool) {
+    uint64_t budget = MCP_ATOMIC_LOAD(&tool->max_execution_time_ms);
+    uint64_t limit = registry->config.tool_timeout > 0 ? (uint64_t)registry->config.tool_timeout * 1000u : 0;
+    if (limit > 0 && (budget == 0 || limit < budget)) {
+        budget = limit;
+    }
+    return budget;
+}
+
+static void tool_call_deliver(tool_call_t *call, cJSON *result) {
+    // Latency runs until the result is delivered, not until the handler returned
+    if (call->record_stats) {
+        tool_entry_record_call(call->entry, tool_clock_ns() - call->start_ns, result);
+    }
+    call->on_complete(result, call->context);
+}
+
+// Runs on the wheel thread: tell the tool to stop and, for async calls, answer now
+static void tool_call_deadline_expired(mcp_timer_t *timer, void *context) {
+    (void)timer;
+    tool_call_t *call = (tool_call_t*)context;
+
+    MCP_ATOMIC_STORE(&call->timed_out, 1);
+    MCP_ATOMIC_STORE(&call->cancelled, 1);
+    if (call->on_complete && MCP_ATOMIC_CLAIM(&call->finished) == 0) {
+        mcp_log_warn("Tool '%s' exceeded its deadline", mcp_tool_get_name(call->entry->tool));
+        if (call->record_stats) {
+            MCP_ATOMIC_INC(&call->entry->calls_timed_out);
         }
-        current = current->next;
+        tool_call_deliver(call, mcp_tool_create_timeout_error());
+    }
+}
+
+static void tool_call_arm(mcp_tool_registry_t *registry, tool_call_t *call) {
+    uint64_t budget_ms = tool_call_budget_ms(registry, call->entry->tool);
+    if (budget_ms == 0 || !registry->deadlines) return;
+
+    call->deadlines = mcp_timer_wheel_ref(registry->deadlines);
+    if (mcp_timer_wheel_schedule(call->deadlines, &call->deadline, budget_ms,
+                                 tool_call_deadline_expired, call) != 0) {
+        mcp_timer_wheel_unref(call->deadlines);
+        call->deadlines = NULL;
     }
+}
+
+// Afterwards the deadline callback is neither pending nor running
+static void tool_call_disarm(tool_call_t *call) {
+    if (!call->deadlines) return;
+
+    mcp_timer_wheel_cancel(call->deadlines, &call->deadline);
+    mcp_timer_wheel_unref(call->deadlines);
+    call->deadlines = NULL;
+}
+
+// Caller of an async tool waiting for the call to finish; whatever finishes it first
+// (completion, deadline or cancellation) wakes it, a later completion is discarded
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    cJSON *result;
+    bool done;
+} tool_call_wait_t;
+
+static void tool_call_wait_complete(cJSON *result, void *context) {
+    tool_call_wait_t *wait = (tool_call_wait_t*)context;
     
-    return NULL;
+    pthread_mutex_lock(&wait->mutex);
+    wait->result = result;
+    wait->done = true;
+    pthread_cond_signal(&wait->cond);
+    pthread_mutex_unlock(&wait->mutex);
 }
 
-// Tool execution
-cJSON *mcp_tool_registry_call_tool(mcp_tool_registry_t *registry, const char *tool_name, const cJSON *parameters) {
-    if (!registry || !tool_name) {
-        return mcp_tool_registry_create_tool_not_found_error(tool_name);
+static cJSON *tool_call_entry_wait(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                   const cJSON *parameters, const char *call_key) {
+    tool_call_wait_t wait = { .result = NULL, .done = false };
+    pthread_mutex_init(&wait.mutex, NULL);
+    pthread_cond_init(&wait.cond, NULL);
+    
+    if (mcp_tool_registry_call_entry_async(registry, entry, parameters, call_key,
+                                           tool_call_wait_complete, &wait) != 0) {
+        tool_call_wait_complete(mcp_tool_create_memory_error(), &wait);
     }
     
-    pthread_rwlock_rdlock(&registry->tools_lock);
+    pthread_mutex_lock(&wait.mutex);
+    while (!wait.done) {
+        pthread_cond_wait(&wait.cond, &wait.mutex);
+    }
+    pthread_mutex_unlock(&wait.mutex);
     
-    mcp_tool_entry_t *entry = mcp_tool_registry_find_tool_entry(registry, tool_name);
-    if (!entry) {
-        pthread_rwlock_unlock(&registry->tools_lock);
-        return mcp_tool_registry_create_tool_not_found_error(tool_name);
+    pthread_cond_destroy(&wait.cond);
+    pthread_mutex_destroy(&wait.mutex);
+    
+    // NULL: cancelled, but this caller still has to return a result
+    return wait.result ? wait.result :
+           mcp_tool_create_error_result(MCP_TOOL_ERROR_EXECUTION, "Tool call cancelled", NULL);
+}
+
+cJSON *mcp_tool_registry_call_entry(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                    const cJSON *parameters, const char *call_key) {
+    if (!registry || !entry) return NULL;
+    
+    // Waiting through the async path lets the deadline release the caller
+    if (mcp_tool_is_async(entry->tool)) {
+        return tool_call_entry_wait(registry, entry, parameters, call_key);
     }
     
-    mcp_tool_t *tool = mcp_tool_ref(entry->tool);
+    tool_call_t call = {
+        .entry = entry,
+        .record_stats = registry->config.enable_tool_stats
+    };
     
-    pthread_rwlock_unlock(&registry->tools_lock);
+    // Measure wall-clock time, so blocking tools are accounted for
+    if (call.record_stats) {
+        call.start_ns = tool_clock_ns();
+    }
     
-    // Execute tool and measure time
-    clock_t start_time = clock();
-    cJSON *result = mcp_tool_execute(tool, parameters);
-    clock_t end_time = clock();
+    // Memoized tools: a hit skips execution (and validation, as only results of
+    // valid arguments are stored)
+    mcp_result_cache_t *cache = MCP_ATOMIC_ACQUIRE(&entry->cache);
+    uint64_t arguments_hash = 0;
+    if (cache) {
+        arguments_hash = mcp_result_cache_hash(parameters);
+        cJSON *cached = mcp_result_cache_lookup(cache, arguments_hash, parameters);
+        if (cached) {
+            if (call.record_stats) {
+                tool_entry_record_call(entry, tool_clock_ns() - call.start_ns, cached);
+            }
+            return cached;
+        }
+    }
     
-    double execution_time = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
+    // The thread cannot be taken back from a synchronous tool: the deadline only raises
+    // the cancellation flag, and whatever the tool returns after it is replaced
+    // The key is only borrowed: the call is unlinked before returning
+    tool_call_link(registry->calls, &call, (char*)call_key);
+    tool_call_arm(registry, &call);
+    cJSON *result = mcp_tool_execute_cancellable(entry->tool, parameters, &call.cancelled);
+    tool_call_disarm(&call);
+    tool_call_unlink(&call);
     
-    // Update statistics
-    pthread_rwlock_wrlock(&registry->tools_lock);
+    if (call.timed_out) {
+        mcp_log_warn("Tool '%s' exceeded its deadline", mcp_tool_get_name(entry->tool));
+        cJSON_Delete(result);
+        result = mcp_tool_create_timeout_error();
+        if (call.record_stats) {
+            MCP_ATOMIC_INC(&entry->calls_timed_out);
+        }
+    } else if (cache && result && !call.cancelled) {
+        // A cancelled tool may have returned early with partial work
+        mcp_result_cache_store(cache, arguments_hash, parameters, result);
+    }
     
-    entry = mcp_tool_registry_find_tool_entry(registry, tool_name);
-    if (entry && registry->config.enable_tool_stats) {
-        entry->calls_made++;
-        entry->last_called = time(NULL);
-        entry->total_execution_time += execution_time;
-        entry->average_execution_time = entry->total_execution_time / entry->calls_made;
+    if (call.record_stats) {
+        tool_entry_record_call(entry, tool_clock_ns() - call.start_ns, result);
+    }
+    
+    return result;
+}
+
+int mcp_tool_registry_call_entry_batch(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                       const cJSON *const *parameters, size_t count, cJSON **results) {
+    if (!registry || !entry || !results || (count > 0 && !parameters)) return -1;
+    if (count == 0) return 0;
+    
+    // Argument sets left to run, where their results go, and their hashes for the cache
+    size_t block_size = count * (sizeof(cJSON*) * 2 + sizeof(size_t) + sizeof(uint64_t));
+    unsigned char *block = malloc(block_size);
+    if (!block) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = mcp_tool_registry_call_entry(registry, entry, parameters[i], NULL);
+        }
+        return 0;
+    }
+    uint64_t *hashes = (uint64_t*)block;
+    const cJSON **pending = (const cJSON**)(hashes + count);
+    cJSON **pending_results = (cJSON**)(pending + count);
+    size_t *positions = (size_t*)(pending_results + count);
+    
+    tool_call_t call = {
+        .entry = entry,
+        .record_stats = registry->config.enable_tool_stats
+    };
+    if (call.record_stats) {
+        call.start_ns = tool_clock_ns();
+    }
+    
+    // Cache hits are answered here, only the misses reach the tool
+    mcp_result_cache_t *cache = MCP_ATOMIC_ACQUIRE(&entry->cache);
+    size_t pending_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        results[i] = NULL;
+        if (cache) {
+            hashes[pending_count] = mcp_result_cache_hash(parameters[i]);
+            results[i] = mcp_result_cache_lookup(cache, hashes[pending_count], parameters[i]);
+        }
+        if (results[i]) {
+            if (call.record_stats) {
+                tool_entry_record_call(entry, tool_clock_ns() - call.start_ns, results[i]);
+            }
+            continue;
+        }
+        pending[pending_count] = parameters[i];
+        positions[pending_count++] = i;
+    }
+    
+    if (pending_count > 0) {
+        // One deadline for the whole batch; the calls have no key of their own
+        tool_call_arm(registry, &call);
+        mcp_tool_execute_batch(entry->tool, pending, pending_count, &call.cancelled, pending_results);
+        tool_call_disarm(&call);
+        
+        if (call.timed_out) {
+            mcp_log_warn("Tool '%s' exceeded its deadline running a batch of %zu calls",
+                         mcp_tool_get_name(entry->tool), pending_count);
+        }
+        
+        // Each call is accounted for with its share of the batch's time
+        uint64_t share_ns = call.record_stats ? (tool_clock_ns() - call.start_ns) / pending_count : 0;
+        for (size_t k = 0; k < pending_count; k++) {
+            cJSON *result = pending_results[k];
+            if (call.timed_out) {
+                cJSON_Delete(result);
+                result = mcp_tool_create_timeout_error();
+                if (call.record_stats) {
+                    MCP_ATOMIC_INC(&entry->calls_timed_out);
+                }
+            } else if (cache && result && !call.cancelled) {
+                mcp_result_cache_store(cache, hashes[k], pending[k], result);
+            }
+            
+            if (call.record_stats) {
+                tool_entry_record_call(entry, share_ns, result);
+            }
+            results[positions[k]] = result;
+        }
+    }
+    
+    free(block);
+    return 0;
+}
+
+int mcp_tool_registry_call_batch(mcp_tool_registry_t *registry, const char *const *tool_names,
+                                 const cJSON *const *parameters, size_t count, cJSON **results) {
+    if (!registry || !results || (count > 0 && (!tool_names || !parameters))) return -1;
+    if (count == 0) return 0;
+    
+    // Calls of the group being run, their positions, and the calls already answered
+    size_t block_size = count * (sizeof(cJSON*) * 2 + sizeof(size_t) + sizeof(bool));
+    unsigned char *block = malloc(block_size);
+    if (!block) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = mcp_tool_registry_call_tool(registry, tool_names[i], parameters[i]);
+        }
+        return 0;
+    }
+    const cJSON **group = (const cJSON**)block;
+    cJSON **group_results = (cJSON**)(group + count);
+    size_t *positions = (size_t*)(group_results + count);
+    bool *done = (bool*)(positions + count);
+    memset(done, 0, count * sizeof(bool));
+    
+    for (size_t i = 0; i < count; i++) {
+        if (done[i]) continue;
+        
+        const char *name = tool_names[i] ? tool_names[i] : "";
+        mcp_tool_entry_t *entry = mcp_tool_registry_acquire_entry(registry, name);
+        if (!entry) {
+            results[i] = mcp_tool_registry_create_tool_not_found_error(name);
+            continue;
+        }
         
-        // Check if the result indicates an error using MCP format
-        cJSON *is_error = cJSON_GetObjectItem(result, "isError");
-        if (result && (!is_error || !cJSON_IsTrue(is_error))) {
-            entry->calls_successful++;
-            registry->total_calls_successful++;
+        // Gather the later calls of the same tool, in order, if it can take them at once
+        size_t group_count = 0;
+        if (entry->tool->execute_batch && !mcp_tool_is_async(entry->tool)) {
+            for (size_t j = i; j < count; j++) {
+                if (!done[j] && tool_names[j] && strcmp(tool_names[j], name) == 0) {
+                    group[group_count] = parameters[j];
+                    positions[group_count++] = j;
+                    done[j] = true;
+                }
+            }
+        }
+        
+        if (group_count > 1) {
+            mcp_tool_registry_call_entry_batch(registry, entry, group, group_count, group_results);
+            for (size_t k = 0; k < group_count; k++) {
+                results[positions[k]] = group_results[k];
+            }
         } else {
-            entry->calls_failed++;
-            registry->total_calls_failed++;
+            results[i] = mcp_tool_registry_call_entry(registry, entry, parameters[i], NULL);
+        }
+        tool_entry_unref(entry);
+    }
+    
+    free(block);
+    return 0;
+}
+
+static void tool_async_call_complete(cJSON *result, void *context) {
+    tool_call_t *call = (tool_call_t*)context;
+    
+    tool_call_disarm(call);
+    tool_call_unlink(call);
+    if (MCP_ATOMIC_CLAIM(&call->finished) == 0) {
+        if (call->cache && result && !call->cancelled) {
+            mcp_result_cache_store(call->cache, call->arguments_hash, call->parameters, result);
+        }
+        tool_call_deliver(call, result);
+    } else {
+        // The deadline or a cancellation answered already
+        mcp_log_debug("Tool '%s': discarding result completed after the call was finished",
+                      mcp_tool_get_name(call->entry->tool));
+        cJSON_Delete(result);
+    }
+    
+    tool_entry_unref(call->entry);
+    free(call->key);
+    free(call);
+}
+
+int mcp_tool_registry_call_entry_async(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                       const cJSON *parameters, const char *call_key,
+                                       mcp_tool_completion_func_t on_complete, void *context) {
+    if (!registry || !entry || !on_complete) return -1;
+    
+    tool_call_t *call = calloc(1, sizeof(tool_call_t));
+    if (!call) {
+        on_complete(mcp_tool_create_memory_error(), context);
+        return 0;
+    }
+    
+    MCP_REF_INC(&entry->ref_count);
+    call->entry = entry;
+    call->record_stats = registry->config.enable_tool_stats;
+    call->start_ns = call->record_stats ? tool_clock_ns() : 0;
+    call->on_complete = on_complete;
+    call->context = context;
+    
+    // A synchronous tool runs within this call, so its cache can be used as in
+    // mcp_tool_registry_call_entry()
+    mcp_result_cache_t *cache = mcp_tool_is_async(entry->tool) ? NULL : MCP_ATOMIC_ACQUIRE(&entry->cache);
+    if (cache) {
+        call->arguments_hash = mcp_result_cache_hash(parameters);
+        cJSON *cached = mcp_result_cache_lookup(cache, call->arguments_hash, parameters);
+        if (cached) {
+            MCP_ATOMIC_STORE(&call->finished, 1);
+            tool_call_deliver(call, cached);
+            tool_entry_unref(entry);
+            free(call);
+            return 0;
         }
+        call->cache = cache;
+        call->parameters = parameters;
+    }
+    
+    // Without a key copy the call simply cannot be cancelled
+    tool_call_link(registry->calls, call, call_key ? strdup(call_key) : NULL);
+    tool_call_arm(registry, call);
+    return mcp_tool_execute_async(entry->tool, parameters, &call->cancelled,
+                                  tool_async_call_complete, call);
+}
+
+uint64_t mcp_tool_registry_get_call_budget_ms(mcp_tool_registry_t *registry, const mcp_tool_entry_t *entry) {
+    return registry && entry ? tool_call_budget_ms(registry, entry->tool) : 0;
+}
+
+int mcp_tool_registry_cancel_call(mcp_tool_registry_t *registry, const char *call_key) {
+    if (!registry || !registry->calls || !call_key) return 0;
+    
+    mcp_tool_call_table_t *table = registry->calls;
+    int found = 0;
+    
+    // Calls unlink themselves under the mutex before they are freed, so holding it
+    // keeps every listed call alive
+    pthread_mutex_lock(&table->mutex);
+    for (tool_call_t *call = table->head; call; call = call->next) {
+        if (strcmp(call->key, call_key) != 0) continue;
         
-        registry->total_calls_made++;
+        found++;
+        MCP_ATOMIC_STORE(&call->cancelled, 1);
+        if (call->on_complete && MCP_ATOMIC_CLAIM(&call->finished) == 0) {
+            mcp_log_debug("Tool '%s' cancelled", mcp_tool_get_name(call->entry->tool));
+            tool_call_deliver(call, NULL);
+        }
     }
+    pthread_mutex_unlock(&table->mutex);
     
-    pthread_rwlock_unlock(&registry->tools_lock);
+    return found;
+}
+
+cJSON *mcp_tool_registry_call_tool(mcp_tool_registry_t *registry, const char *tool_name, const cJSON *parameters) {
+    mcp_tool_entry_t *entry = mcp_tool_registry_acquire_entry(registry, tool_name);
+    if (!entry) {
+        return mcp_tool_registry_create_tool_not_found_error(tool_name);
+    }
+    
+    cJSON *result = mcp_tool_registry_call_entry(registry, entry, parameters, NULL);
+    tool_entry_unref(entry);
+    
+    return result;
+}
+
+int mcp_tool_registry_set_cache(mcp_tool_registry_t *registry, const char *tool_name,
+                                size_t max_bytes, uint32_t ttl_ms) {
+    if (!registry || !tool_name) return -1;
+    
+    // The write lock serializes creating the cache against other configuration
+    pthread_rwlock_wrlock(&registry->tools_lock);
     
-    mcp_tool_unref(tool);
+    mcp_tool_entry_t *entry = mcp_tool_registry_find_tool_entry(registry, tool_name);
+    int result = -1;
+    if (!entry) {
+        mcp_log_error("Cannot cache results of unknown tool '%s'", tool_name);
+    } else if (mcp_tool_is_async(entry->tool)) {
+        mcp_log_error("Cannot cache results of async tool '%s'", tool_name);
+    } else if (entry->cache) {
+        mcp_result_cache_configure(entry->cache, max_bytes, ttl_ms);
+        result = 0;
+    } else if (max_bytes == 0) {
+        result = 0;
+    } else {
+        mcp_result_cache_t *cache = mcp_result_cache_create(max_bytes, ttl_ms);
+        if (cache) {
+            MCP_ATOMIC_PUBLISH(&entry->cache, cache);
+            result = 0;
+        }
+    }
+    
+    pthread_rwlock_unlock(&registry->tools_lock);
     
     return result;
 }
@@ -325,6 +963,190 @@ cJSON *mcp_tool_registry_list_tools(const mcp_tool_registry_t *registry) {
     return tools_array;
 }
 
+static int tool_list_snapshot_append(mcp_tool_list_snapshot_t *snapshot, size_t *capacity,
+                                     const char *data, size_t length) {
+    if (snapshot->length + length + 1 > *capacity) {
+        size_t new_capacity = *capacity ? *capacity : 4096;
+        while (new_capacity < snapshot->length + length + 1) {
+            new_capacity *= 2;
+        }
+        char *json = realloc(snapshot->json, new_capacity);
+        if (!json) return -1;
+        snapshot->json = json;
+        *capacity = new_capacity;
+    }
+    memcpy(snapshot->json + snapshot->length, data, length);
+    snapshot->length += length;
+    snapshot->json[snapshot->length] = '\0';
+    return 0;
+}
+
+// Caller must hold tools_lock for writing
+static int tool_list_snapshot_rebuild(mcp_tool_registry_t *registry) {
+    mcp_tool_list_snapshot_t *snapshot = calloc(1, sizeof(mcp_tool_list_snapshot_t));
+    if (!snapshot) return -1;
+
+    size_t capacity = 0;
+    snapshot->offsets = malloc((registry->tool_count + 1) * sizeof(size_t));
+    snapshot->sequences = malloc((registry->tool_count + 1) * sizeof(uint64_t));
+    if (!snapshot->offsets || !snapshot->sequences ||
+        tool_list_snapshot_append(snapshot, &capacity, "[", 1) != 0) {
+        tool_list_snapshot_destroy(snapshot);
+        return -1;
+    }
+
+    // Definitions are rendered one by one so that pages can be cut out of the array
+    mcp_json_buffer_t buffer;
+    mcp_json_buffer_init(&buffer);
+    int result = 0;
+
+    for (mcp_tool_entry_t *current = registry->tools; current && result == 0; current = current->next) {
+        cJSON *tool_def = mcp_tool_to_mcp_tool_definition(current->tool);
+        if (!tool_def) continue;
+
+        result = mcp_json_buffer_print(&buffer, tool_def, false);
+        cJSON_Delete(tool_def);
+        if (result != 0) break;
+
+        if (snapshot->count > 0) {
+            result = tool_list_snapshot_append(snapshot, &capacity, ",", 1);
+        }
+        snapshot->offsets[snapshot->count] = snapshot->length;
+        snapshot->sequences[snapshot->count] = current->sequence;
+        snapshot->count++;
+        if (result == 0) {
+            result = tool_list_snapshot_append(snapshot, &capacity, buffer.data, buffer.length);
+        }
+    }
+
+    mcp_json_buffer_free(&buffer);
+
+    snapshot->offsets[snapshot->count] = snapshot->length;
+    if (result != 0 || tool_list_snapshot_append(snapshot, &capacity, "]", 1) != 0) {
+        tool_list_snapshot_destroy(snapshot);
+        return -1;
+    }
+
+    // FNV-1a over the bytes, so the tag survives restarts as long as the list is unchanged
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < snapshot->length; i++) {
+        hash ^= (unsigned char)snapshot->json[i];
+        hash *= 1099511628211ull;
+    }
+    snprintf(snapshot->etag, sizeof(snapshot->etag), "%016llx", (unsigned long long)hash);
+    snapshot->version = registry->list_version;
+
+    tool_list_snapshot_destroy(registry->list_snapshot);
+    registry->list_snapshot = snapshot;
+    return 0;
+}
+
+static bool tool_list_snapshot_current(const mcp_tool_registry_t *registry) {
+    return registry->list_snapshot && registry->list_snapshot->version == registry->list_version;
+}
+
+// Leaves tools_lock held (read or write) with an up-to-date snapshot; -1 with the lock released
+static int tool_list_snapshot_acquire(mcp_tool_registry_t *registry) {
+    pthread_rwlock_rdlock(&registry->tools_lock);
+    if (tool_list_snapshot_current(registry)) {
+        return 0;
+    }
+    pthread_rwlock_unlock(&registry->tools_lock);
+
+    pthread_rwlock_wrlock(&registry->tools_lock);
+    // Another thread may have rebuilt it while the lock was released
+    if (!tool_list_snapshot_current(registry) && tool_list_snapshot_rebuild(registry) != 0) {
+        pthread_rwlock_unlock(&registry->tools_lock);
+        return -1;
+    }
+    return 0;
+}
+
+// Raw array node holding elements [first, last) of the snapshot
+static cJSON *tool_list_snapshot_slice(const mcp_tool_list_snapshot_t *snapshot, size_t first, size_t last) {
+    if (first == 0 && last == snapshot->count) {
+        return cJSON_CreateRaw(snapshot->json);
+    }
+
+    cJSON *tools = cJSON_CreateRaw("");
+    if (!tools) return NULL;
+
+    // Elements after the first are preceded by their separating comma
+    size_t start = snapshot->offsets[first];
+    size_t end = snapshot->offsets[last];
+    if (last < snapshot->count && last > first) {
+        end--;
+    }
+
+    char *json = cJSON_malloc(end - start + 3);
+    if (!json) {
+        cJSON_Delete(tools);
+        return NULL;
+    }
+    json[0] = '[';
+    memcpy(json + 1, snapshot->json + start, end - start);
+    json[end - start + 1] = ']';
+    json[end - start + 2] = '\0';
+
+    cJSON_free(tools->valuestring);
+    tools->valuestring = json;
+    return tools;
+}
+
+cJSON *mcp_tool_registry_list_tools_page(mcp_tool_registry_t *registry, uint64_t cursor, size_t limit,
+                                         uint64_t *next_cursor, char *etag) {
+    if (!registry) return NULL;
+    if (next_cursor) *next_cursor = 0;
+
+    if (tool_list_snapshot_acquire(registry) != 0) return NULL;
+
+    const mcp_tool_list_snapshot_t *snapshot = registry->list_snapshot;
+
+    // Sequences descend along the list: find the first tool registered before the cursor
+    size_t first = 0;
+    if (cursor) {
+        size_t low = 0, high = snapshot->count;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (snapshot->sequences[mid] < cursor) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        first = low;
+    }
+
+    size_t last = snapshot->count;
+    if (limit && snapshot->count - first > limit) {
+        last = first + limit;
+        if (next_cursor) *next_cursor = snapshot->sequences[last - 1];
+    }
+
+    cJSON *tools = tool_list_snapshot_slice(snapshot, first, last);
+    if (tools && etag) {
+        memcpy(etag, snapshot->etag, MCP_TOOL_LIST_ETAG_SIZE);
+    }
+
+    pthread_rwlock_unlock(&registry->tools_lock);
+
+    return tools;
+}
+
+cJSON *mcp_tool_registry_list_tools_raw(mcp_tool_registry_t *registry, char *etag) {
+    return mcp_tool_registry_list_tools_page(registry, 0, 0, NULL, etag);
+}
+
+bool mcp_tool_registry_tool_list_matches(mcp_tool_registry_t *registry, const char *etag) {
+    if (!registry || !etag) return false;
+
+    if (tool_list_snapshot_acquire(registry) != 0) return false;
+    bool matches = strcmp(etag, registry->list_snapshot->etag) == 0;
+    pthread_rwlock_unlock(&registry->tools_lock);
+
+    return matches;
+}
+
 size_t mcp_tool_registry_get_tool_count(const mcp_tool_registry_t *registry) {
     if (!registry) return 0;
     
@@ -335,6 +1157,146 @@ size_t mcp_tool_registry_get_tool_count(const mcp_tool_registry_t *registry) {
     return count;
 }
 
+// Statistics
+static cJSON *tool_entry_stats_to_json(const mcp_tool_entry_t *entry) {
+    cJSON *stats = cJSON_CreateObject();
+    if (!stats) return NULL;
+
+    size_t calls_made = MCP_ATOMIC_LOAD(&entry->calls_made);
+    uint64_t total_ns = MCP_ATOMIC_LOAD(&entry->total_execution_ns);
+
+    cJSON_AddStringToObject(stats, "name", mcp_tool_get_name(entry->tool));
+    cJSON_AddNumberToObject(stats, "registered_time", (double)entry->registered_time);
+    cJSON_AddBoolToObject(stats, "is_builtin", entry->is_builtin);
+    cJSON_AddNumberToObject(stats, "calls_made", (double)calls_made);
+    cJSON_AddNumberToObject(stats, "calls_successful", (double)MCP_ATOMIC_LOAD(&entry->calls_successful));
+    cJSON_AddNumberToObject(stats, "calls_failed", (double)MCP_ATOMIC_LOAD(&entry->calls_failed));
+    cJSON_AddNumberToObject(stats, "calls_timed_out", (double)MCP_ATOMIC_LOAD(&entry->calls_timed_out));
+    cJSON_AddNumberToObject(stats, "last_called", (double)MCP_ATOMIC_LOAD(&entry->last_called));
+    cJSON_AddNumberToObject(stats, "total_execution_time", (double)total_ns / 1e9);
+    cJSON_AddNumberToObject(stats, "average_execution_time",
+                            calls_made ? (double)total_ns / 1e9 / (double)calls_made : 0.0);
+
+    if (entry->latency) {
+        mcp_histogram_summary_t summary;
+        mcp_histogram_get_summary(entry->latency, &summary);
+
+        cJSON *latency = cJSON_AddObjectToObject(stats, "latency_ms");
+        if (latency) {
+            cJSON_AddNumberToObject(latency, "p50", (double)summary.p50 / 1e6);
+            cJSON_AddNumberToObject(latency, "p90", (double)summary.p90 / 1e6);
+            cJSON_AddNumberToObject(latency, "p99", (double)summary.p99 / 1e6);
+            cJSON_AddNumberToObject(latency, "p999", (double)summary.p999 / 1e6);
+            cJSON_AddNumberToObject(latency, "max", (double)summary.max / 1e6);
+        }
+    }
+
+    if (entry->cache) {
+        mcp_result_cache_stats_t cache_stats;
+        mcp_result_cache_get_stats(entry->cache, &cache_stats);
+
+        cJSON *cache = cJSON_AddObjectToObject(stats, "cache");
+        if (cache) {
+            cJSON_AddNumberToObject(cache, "hits", (double)cache_stats.hits);
+            cJSON_AddNumberToObject(cache, "misses", (double)cache_stats.misses);
+            cJSON_AddNumberToObject(cache, "expirations", (double)cache_stats.expirations);
+            cJSON_AddNumberToObject(cache, "evictions", (double)cache_stats.evictions);
+            cJSON_AddNumberToObject(cache, "entries", (double)cache_stats.entries);
+            cJSON_AddNumberToObject(cache, "bytes", (double)cache_stats.bytes);
+            cJSON_AddNumberToObject(cache, "max_bytes", (double)cache_stats.max_bytes);
+            cJSON_AddNumberToObject(cache, "ttl_ms", (double)cache_stats.ttl_ms);
+        }
+    }
+
+    return stats;
+}
+
+cJSON *mcp_tool_registry_get_stats(const mcp_tool_registry_t *registry) {
+    if (!registry) return NULL;
+
+    cJSON *stats = cJSON_CreateObject();
+    if (!stats) return NULL;
+
+    pthread_rwlock_rdlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    size_t calls_made = registry->total_calls_made;
+    size_t calls_successful = registry->total_calls_successful;
+    size_t calls_failed = registry->total_calls_failed;
+    for (const mcp_tool_entry_t *entry = registry->tools; entry; entry = entry->next) {
+        calls_made += MCP_ATOMIC_LOAD(&entry->calls_made);
+        calls_successful += MCP_ATOMIC_LOAD(&entry->calls_successful);
+        calls_failed += MCP_ATOMIC_LOAD(&entry->calls_failed);
+    }
+
+    cJSON_AddNumberToObject(stats, "tool_count", (double)registry->tool_count);
+    cJSON_AddNumberToObject(stats, "total_tools_registered", (double)registry->total_tools_registered);
+    cJSON_AddNumberToObject(stats, "tools_unregistered", (double)registry->tools_unregistered);
+
+    pthread_rwlock_unlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    cJSON_AddNumberToObject(stats, "total_calls_made", (double)calls_made);
+    cJSON_AddNumberToObject(stats, "total_calls_successful", (double)calls_successful);
+    cJSON_AddNumberToObject(stats, "total_calls_failed", (double)calls_failed);
+
+    return stats;
+}
+
+cJSON *mcp_tool_registry_get_tool_stats(const mcp_tool_registry_t *registry, const char *tool_name) {
+    if (!registry || !tool_name) return NULL;
+
+    pthread_rwlock_rdlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    mcp_tool_entry_t *entry = mcp_tool_registry_find_tool_entry(registry, tool_name);
+    cJSON *stats = entry ? tool_entry_stats_to_json(entry) : NULL;
+
+    pthread_rwlock_unlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    return stats;
+}
+
+cJSON *mcp_tool_registry_get_all_tool_stats(const mcp_tool_registry_t *registry) {
+    if (!registry) return NULL;
+
+    cJSON *tools = cJSON_CreateArray();
+    if (!tools) return NULL;
+
+    pthread_rwlock_rdlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    for (const mcp_tool_entry_t *entry = registry->tools; entry; entry = entry->next) {
+        cJSON *stats = tool_entry_stats_to_json(entry);
+        if (stats) {
+            cJSON_AddItemToArray(tools, stats);
+        }
+    }
+
+    pthread_rwlock_unlock((pthread_rwlock_t*)&registry->tools_lock);
+
+    return tools;
+}
+
+void mcp_tool_registry_reset_stats(mcp_tool_registry_t *registry) {
+    if (!registry) return;
+
+    // The write lock keeps the registry totals consistent; calls in flight may still land afterwards
+    pthread_rwlock_wrlock(&registry->tools_lock);
+
+    for (mcp_tool_entry_t *entry = registry->tools; entry; entry = entry->next) {
+        MCP_ATOMIC_STORE(&entry->calls_made, 0);
+        MCP_ATOMIC_STORE(&entry->calls_successful, 0);
+        MCP_ATOMIC_STORE(&entry->calls_failed, 0);
+        MCP_ATOMIC_STORE(&entry->calls_timed_out, 0);
+        MCP_ATOMIC_STORE(&entry->last_called, 0);
+        MCP_ATOMIC_STORE(&entry->total_execution_ns, 0);
+        mcp_histogram_reset(entry->latency);
+        mcp_result_cache_reset_stats(entry->cache);
+    }
+    registry->total_calls_made = 0;
+    registry->total_calls_successful = 0;
+    registry->total_calls_failed = 0;
+
+    pthread_rwlock_unlock(&registry->tools_lock);
+}
+
 // Configuration helpers
 mcp_tool_registry_config_t *mcp_tool_registry_config_create_default(void) {
     mcp_tool_registry_config_t *config = calloc(1, sizeof(mcp_tool_registry_config_t));
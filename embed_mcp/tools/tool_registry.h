@@ -2,7 +2,11 @@
 #define MCP_TOOL_REGISTRY_H
 
 #include "tool_interface.h"
+#include "tools/result_cache.h"
+#include "utils/histogram.h"
+#include "utils/timer_wheel.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 #include <pthread.h>
 #include "cjson/cJSON.h"
@@ -10,6 +14,7 @@
 // Forward declarations
 typedef struct mcp_tool_registry mcp_tool_registry_t;
 typedef struct mcp_tool_entry mcp_tool_entry_t;
+typedef struct mcp_tool_call_table mcp_tool_call_table_t;
 
 // Tool entry structure
 struct mcp_tool_entry {
@@ -19,25 +24,55 @@ struct mcp_tool_entry {
     time_t registered_time;
     bool is_builtin;
     
-    // Statistics
+    // Statistics - updated with relaxed atomics on the call path, no lock taken;
+    // read them through mcp_tool_registry_get_stats / get_tool_stats
     size_t calls_made;
     size_t calls_successful;
     size_t calls_failed;
+    size_t calls_timed_out;          // Included in calls_failed
     time_t last_called;
-    double total_execution_time;
-    double average_execution_time;
+    uint64_t total_execution_ns;    // Monotonic wall-clock time
+    mcp_histogram_t *latency;       // Wall-clock latency in ns, NULL when stats are disabled
+    
+    // Memoized results, NULL until caching is enabled for the tool; never replaced
+    // once published, so calls may use it without a lock
+    mcp_result_cache_t *cache;
     
     // Internal
+    uint32_t name_hash;              // Hash of the tool name, computed at registration
+    int ref_count;                   // Registry reference plus one per call in flight
+    uint64_t sequence;               // Registration order, newer tools are higher
     struct mcp_tool_entry *next;
 };
 
+// Slot of the open-addressing name index (entry == NULL marks an empty slot)
+typedef struct {
+    uint32_t hash;
+    mcp_tool_entry_t *entry;
+} mcp_tool_index_slot_t;
+
+// Entity tag of a tools/list snapshot: 16 hex digits plus terminator
+#define MCP_TOOL_LIST_ETAG_SIZE 17
+
+// Serialized tools/list array "[def,def,...]" with the position of every element,
+// so pages are cut out of it without touching the tools
+typedef struct {
+    char *json;
+    size_t length;
+    size_t count;
+    size_t *offsets;                 // count + 1 entries, the last one is the closing bracket
+    uint64_t *sequences;             // Registration sequence of each element, descending
+    uint64_t version;                // list_version it was built from
+    char etag[MCP_TOOL_LIST_ETAG_SIZE];
+} mcp_tool_list_snapshot_t;
+
 // Tool registry configuration
 typedef struct {
     size_t max_tools;
     bool enable_builtin_tools;
     bool enable_tool_stats;
     bool strict_validation;
-    time_t tool_timeout;
+    time_t tool_timeout;             // Seconds, caps every tool's max_execution_time_ms (0 = no cap)
 } mcp_tool_registry_config_t;
 
 // Tool registry structure
@@ -45,17 +80,29 @@ struct mcp_tool_registry {
     // Configuration
     mcp_tool_registry_config_t config;
     
-    // Tool storage
+    // Tool storage - the list keeps listing order, the index serves lookups by name
     mcp_tool_entry_t *tools;
     size_t tool_count;
+    mcp_tool_index_slot_t *index;
+    size_t index_capacity;           // Power of two, kept at most half full
+    
+    // Serialized tools/list array, rebuilt on demand once the tool set changed
+    uint64_t list_version;           // Bumped by every register/unregister
+    mcp_tool_list_snapshot_t *list_snapshot;
     
     // Thread safety
     pthread_rwlock_t tools_lock;
     pthread_mutex_t registry_mutex;
     
+    // Deadlines of calls in flight (NULL if the timer thread could not start)
+    mcp_timer_wheel_t *deadlines;
+    // Calls in flight that were given a key, for cancellation by the caller
+    mcp_tool_call_table_t *calls;
+    
     // Statistics
     size_t total_tools_registered;
     size_t tools_unregistered;
+    // Calls of tools that have been unregistered; live entries are added on read
     size_t total_calls_made;
     size_t total_calls_successful;
     size_t total_calls_failed;
@@ -75,6 +122,7 @@ bool mcp_tool_registry_has_tool(const mcp_tool_registry_t *registry, const char
 
 // Tool lookup
 mcp_tool_t *mcp_tool_registry_find_tool(const mcp_tool_registry_t *registry, const char *tool_name);
+// Caller must hold tools_lock
 mcp_tool_entry_t *mcp_tool_registry_find_tool_entry(const mcp_tool_registry_t *registry, 
                                                    const char *tool_name);
 
@@ -82,9 +130,68 @@ mcp_tool_entry_t *mcp_tool_registry_find_tool_entry(const mcp_tool_registry_t *r
 cJSON *mcp_tool_registry_call_tool(mcp_tool_registry_t *registry,
                                   const char *tool_name,
                                   const cJSON *parameters);
+// Two-step form, for callers that look at the tool before calling it (e.g. is it async?).
+// acquire returns NULL if the tool is not registered; the entry stays valid, even across
+// unregistration, until it is released.
+mcp_tool_entry_t *mcp_tool_registry_acquire_entry(mcp_tool_registry_t *registry, const char *tool_name);
+void mcp_tool_registry_release_entry(mcp_tool_entry_t *entry);
+// Deadline that calls of the entry run under, in milliseconds; 0 if unbounded
+uint64_t mcp_tool_registry_get_call_budget_ms(mcp_tool_registry_t *registry, const mcp_tool_entry_t *entry);
+// Calls are bounded by the tool's max_execution_time_ms, capped by config.tool_timeout.
+// Past the deadline the tool's cancellation flag is raised and its result is replaced
+// with a timeout error; async calls get that error right away, and their late result
+// is discarded. Async tools block the caller here until they complete, time out or are
+// cancelled (which returns an execution error).
+// call_key (may be NULL) names the call for mcp_tool_registry_cancel_call() while it runs.
+cJSON *mcp_tool_registry_call_entry(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                    const cJSON *parameters, const char *call_key);
+// mcp_tool_execute_async() with statistics; latency is measured up to completion.
+// The call keeps its own reference to the entry. Running out of memory is reported
+// through on_complete like any other failure. A synchronous tool runs on the calling
+// thread and uses its result cache; past the deadline on_complete gets the timeout
+// error at once and the tool's late result is discarded.
+int mcp_tool_registry_call_entry_async(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                       const cJSON *parameters, const char *call_key,
+                                       mcp_tool_completion_func_t on_complete, void *context);
+// Several calls of one synchronous tool: results[i] (owned by the caller) for parameters[i].
+// Cache hits are answered directly; the other calls go to the tool's batch handler in
+// one invocation (see mcp_tool_execute_batch()), under a single deadline and with no
+// call key. Each call is counted in the statistics with its share of the batch's time.
+int mcp_tool_registry_call_entry_batch(mcp_tool_registry_t *registry, mcp_tool_entry_t *entry,
+                                       const cJSON *const *parameters, size_t count, cJSON **results);
+// Independent calls, e.g. from a JSON-RPC batch: results[i] for tool_names[i] with
+// parameters[i]. Calls of a tool with a batch handler are grouped into one batch,
+// the others run one by one in order.
+int mcp_tool_registry_call_batch(mcp_tool_registry_t *registry, const char *const *tool_names,
+                                 const cJSON *const *parameters, size_t count, cJSON **results);
+// Raise the cancellation flag of the calls in flight under call_key. A synchronous
+// tool called through mcp_tool_registry_call_entry() still returns its result. A call
+// through mcp_tool_registry_call_entry_async() that has not completed yet is finished
+// right away with a NULL result, meaning "no response"; whatever the tool delivers
+// later is discarded. Returns the number of calls found.
+int mcp_tool_registry_cancel_call(mcp_tool_registry_t *registry, const char *call_key);
+
+// Memoize the results of a pure synchronous tool: calls with arguments equal to an
+// earlier successful call return a copy of its result without running the tool.
+// max_bytes bounds the cache (0 disables it and drops the results), ttl_ms limits
+// how long a result is reused (0 = until evicted). Fails for async tools.
+int mcp_tool_registry_set_cache(mcp_tool_registry_t *registry, const char *tool_name,
+                                size_t max_bytes, uint32_t ttl_ms);
 
 // Tool listing
 cJSON *mcp_tool_registry_list_tools(const mcp_tool_registry_t *registry);
+// Same array as a cJSON_Raw node copied from the cached serialization, which is only
+// rebuilt after tools are registered or unregistered. Tools must not be modified
+// once registered. etag (MCP_TOOL_LIST_ETAG_SIZE bytes) receives the snapshot's
+// entity tag, a hash of its contents, when not NULL.
+cJSON *mcp_tool_registry_list_tools_raw(mcp_tool_registry_t *registry, char *etag);
+// True if etag names the current tool list, so a client holding it can skip the list
+bool mcp_tool_registry_tool_list_matches(mcp_tool_registry_t *registry, const char *etag);
+// One page of the cached list: at most limit tools (0 = all) registered before cursor
+// (0 = from the start). next_cursor receives the cursor of the following page, 0 after
+// the last one. Cursors stay valid while tools are added or removed.
+cJSON *mcp_tool_registry_list_tools_page(mcp_tool_registry_t *registry, uint64_t cursor, size_t limit,
+                                         uint64_t *next_cursor, char *etag);
 cJSON *mcp_tool_registry_get_tool_info(const mcp_tool_registry_t *registry, const char *tool_name);
 size_t mcp_tool_registry_get_tool_count(const mcp_tool_registry_t *registry);
 
@@ -98,7 +205,10 @@ bool mcp_tool_registry_validate_parameters(const mcp_tool_t *tool, const cJSON *
 
 // Registry statistics
 cJSON *mcp_tool_registry_get_stats(const mcp_tool_registry_t *registry);
+// Counters and latency percentiles (milliseconds) for one tool, NULL if it is not registered
 cJSON *mcp_tool_registry_get_tool_stats(const mcp_tool_registry_t *registry, const char *tool_name);
+// Array with the get_tool_stats object of every registered tool
+cJSON *mcp_tool_registry_get_all_tool_stats(const mcp_tool_registry_t *registry);
 void mcp_tool_registry_reset_stats(mcp_tool_registry_t *registry);
 
 // Registry configuration
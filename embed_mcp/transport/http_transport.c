@@ -4,6 +4,7 @@
 #include "utils/logging.h"
 #include "protocol/message.h"
 #include "protocol/jsonrpc.h"
+#include "utils/atomic.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
@@ -71,6 +72,125 @@ static int http_extract_header_value(const mcp_hal_http_request_t* request,
     return 0;
 }
 
+// 创建单个HTTP请求对应的连接对象
+static mcp_connection_t* http_connection_create(mcp_http_transport_data_t* data,
+                                                const mcp_hal_http_request_t* request) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    mcp_connection_t* connection = hal->memory.alloc(sizeof(mcp_connection_t));
+    if (!connection) return NULL;
+    memset(connection, 0, sizeof(mcp_connection_t));
+
+    mcp_http_request_ctx_t* ctx = hal->memory.alloc(sizeof(mcp_http_request_ctx_t));
+    if (!ctx) {
+        hal->memory.free(connection);
+        return NULL;
+    }
+    memset(ctx, 0, sizeof(mcp_http_request_ctx_t));
+    ctx->hal_conn = request->connection;
+    ctx->hal_conn_id = request->connection_id;
+    ctx->ref_count = 1;
+
+    // 初始化连接对象
+    connection->transport = data->transport;
+    connection->is_active = true;
+    connection->created_time = time(NULL);
+    connection->last_activity = connection->created_time;
+    connection->private_data = ctx;
+
+    // Capture streamable-http headers if present
+    char session_id[128] = {0};
+    if (http_extract_header_value(request, "MCP-Session-Id", session_id, sizeof(session_id))) {
+        mcp_connection_set_session_id(connection, session_id);
+    }
+
+    return connection;
+}
+
+static void http_connection_destroy(mcp_connection_t* connection) {
+    if (!connection) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return;
+
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+    if (ctx) {
+        hal_free(hal, ctx->body);
+        hal->memory.free(ctx);
+    }
+    hal_free(hal, connection->connection_id);
+    hal_free(hal, connection->session_id);
+    hal->memory.free(connection);
+}
+
+// 发送响应：轮询线程内直接发送，工作线程中通过HAL投递
+static int http_connection_reply(mcp_connection_t* connection, int status_code,
+                                 const char* body, size_t body_len) {
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)connection->transport->private_data;
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+    if (!data || !ctx) {
+        return -1;
+    }
+
+    char headers[1024];
+    int written = 0;
+    written += snprintf(headers + written, sizeof(headers) - (size_t)written,
+                        "Content-Type: application/json\r\n"
+                        "Access-Control-Allow-Origin: *\r\n"
+                        "Access-Control-Allow-Headers: Content-Type, Authorization, MCP-Session-Id, MCP-Protocol-Version\r\n"
+                        "MCP-Protocol-Version: %s\r\n",
+                        MCP_PROTOCOL_VERSION);
+    if (connection->session_id && connection->session_id[0] != '\0' && (size_t)written < sizeof(headers)) {
+        written += snprintf(headers + written, sizeof(headers) - (size_t)written,
+                            "MCP-Session-Id: %s\r\n", connection->session_id);
+    }
+
+    // 构造HAL响应
+    mcp_hal_http_response_t response = {
+        .status_code = status_code,
+        .headers = headers,
+        .body = body,
+        .body_len = body_len
+    };
+
+    int result;
+    if (ctx->deferred) {
+        result = data->hal->network.http_response_post(ctx->hal_conn_id, &response);
+    } else {
+        result = data->hal->network.http_response_send(ctx->hal_conn, &response);
+    }
+    ctx->responded = true;
+
+    return result;
+}
+
+// 将请求交给上层处理，处理完成后释放连接对象
+static void http_dispatch_message(mcp_connection_t* connection, const char* body, size_t body_len) {
+    mcp_transport_t* transport = connection->transport;
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+
+    // 调用消息接收回调
+    if (transport->on_message) {
+        transport->on_message(body, body_len, connection, transport->user_data);
+    }
+
+    // 通知等没有响应的消息，返回202避免客户端一直等待；分离的连接由持有者稍后回复
+    if (!ctx->detached && !ctx->responded) {
+        http_connection_reply(connection, 202, "", 0);
+    }
+
+    mcp_http_transport_release_connection_impl(connection);
+}
+
+// 工作线程任务
+static void http_worker_job(void* arg) {
+    mcp_connection_t* connection = (mcp_connection_t*)arg;
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+
+    http_dispatch_message(connection, ctx->body, ctx->body_len);
+}
+
 // HTTP请求处理函数 - 通过HAL接口
 static void http_request_handler(const mcp_hal_http_request_t* request,
                                 mcp_hal_http_response_t* response,
@@ -95,62 +215,56 @@ static void http_request_handler(const mcp_hal_http_request_t* request,
 
     // 检查是否为POST请求到MCP端点
     if (strcmp(request->method, "POST") == 0 && strcmp(request->uri, endpoint_path) == 0) {
-
-        // 处理notifications/initialized
-        if (request->body && strstr(request->body, "notifications/initialized")) {
-            mcp_log_debug("HTTP Transport: Received notifications/initialized");
-            response->status_code = 202;
-            response->headers = "Content-Type: application/json\r\nAccess-Control-Allow-Origin: *\r\n";
-            response->body = "";
-            response->body_len = 0;
+        // HAL未提前拦截时（如分块传输的请求体）在这里检查上限
+        if (data->max_request_size > 0 && request->body_len > data->max_request_size) {
+            response->status_code = 413;
+            response->headers = "Content-Type: application/json\r\n";
+            response->body = "{\"error\":\"Request too large\"}";
+            response->body_len = strlen(response->body);
             return;
         }
 
-        // 检查是否为MCP请求
-        if (request->body && strstr(request->body, "\"method\"")) {
-            const mcp_platform_hal_t *hal = mcp_platform_get_hal();
-            if (!hal) {
-                response->status_code = 500;
-                response->headers = "Content-Type: application/json\r\n";
-                response->body = "{\"error\":\"Internal server error\"}";
-                response->body_len = strlen(response->body);
-                return;
+        // 请求体在上层只解析一次；通知和客户端响应没有返回内容时由dispatch回复202
+        mcp_connection_t* connection = http_connection_create(data, request);
+        if (!connection) {
+            mcp_log_error("HTTP Transport: Failed to allocate connection");
+            response->status_code = 500;
+            response->headers = "Content-Type: application/json\r\n";
+            response->body = "{\"error\":\"Internal server error\"}";
+            response->body_len = strlen(response->body);
+            return;
+        }
+        MCP_ATOMIC_INC(&data->total_requests);
+
+        if (data->worker_pool) {
+            // 复制请求体，mongoose的接收缓冲区在本次回调后失效
+            mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+            const mcp_platform_hal_t *hal = data->hal;
+            ctx->deferred = true;
+            ctx->on_worker = true;
+            ctx->body = hal->memory.alloc(request->body_len + 1);
+            if (ctx->body) {
+                memcpy(ctx->body, request->body, request->body_len);
+                ctx->body[request->body_len] = '\0';
+                ctx->body_len = request->body_len;
             }
 
-            // 创建连接对象
-            mcp_connection_t* connection = hal->memory.alloc(sizeof(mcp_connection_t));
-            if (!connection) {
-                mcp_log_error("HTTP Transport: Failed to allocate connection");
-                response->status_code = 500;
-                response->headers = "Content-Type: application/json\r\n";
-                response->body = "{\"error\":\"Internal server error\"}";
+            if (!ctx->body || mcp_worker_pool_submit(data->worker_pool, http_worker_job, connection) != 0) {
+                mcp_log_warn("HTTP Transport: Worker queue full, rejecting request");
+                http_connection_destroy(connection);
+                response->status_code = 503;
+                response->headers = "Content-Type: application/json\r\nRetry-After: 1\r\n";
+                response->body = "{\"error\":\"Server busy\"}";
                 response->body_len = strlen(response->body);
                 return;
             }
-            memset(connection, 0, sizeof(mcp_connection_t));
-
-            // 初始化连接对象
-            connection->transport = data->transport;
-            connection->is_active = true;
-            connection->created_time = time(NULL);
-            connection->last_activity = time(NULL);
-            connection->private_data = (void*)request->connection;  // 保存HAL连接
-
-            // Capture streamable-http headers if present
-            char session_id[128] = {0};
-            if (http_extract_header_value(request, "MCP-Session-Id", session_id, sizeof(session_id))) {
-                mcp_connection_set_session_id(connection, session_id);
-            }
-
-            // 调用消息接收回调
-            if (data->transport->on_message) {
-                data->transport->on_message(request->body, request->body_len, connection, data->transport->user_data);
-            }
-
-            // 延迟响应 - 不设置响应内容，等待send函数调用
-            response->status_code = 0;  // 特殊标记表示延迟响应
-            return;
+        } else {
+            http_dispatch_message(connection, request->body, request->body_len);
         }
+
+        // 延迟响应 - 不设置响应内容，等待send函数调用
+        response->status_code = 0;  // 特殊标记表示延迟响应
+        return;
     }
 
     // 默认404响应
@@ -168,6 +282,9 @@ const mcp_transport_interface_t mcp_http_transport_interface = {
     .send = mcp_http_transport_send_impl,
     .close_connection = mcp_http_transport_close_connection_impl,
     .get_stats = mcp_http_transport_get_stats_impl,
+    .detach_connection = mcp_http_transport_detach_connection_impl,
+    .release_connection = mcp_http_transport_release_connection_impl,
+    .can_reply_early = mcp_http_transport_can_reply_early_impl,
     .cleanup = mcp_http_transport_cleanup_impl
 };
 
@@ -216,6 +333,8 @@ int mcp_http_transport_init_impl(mcp_transport_t *transport, const mcp_transport
     data->endpoint_path = config->config.http.endpoint_path ? hal_strdup(hal, config->config.http.endpoint_path) : hal_strdup(hal, "/mcp");
     data->enable_cors = config->config.http.enable_cors;
     data->max_request_size = config->config.http.max_request_size;
+    data->worker_threads = config->config.http.worker_threads > 0 ? config->config.http.worker_threads : 0;
+    data->event_loops = config->config.http.event_loops > 1 ? config->config.http.event_loops : 1;
     data->server_running = false;
     data->transport = transport;
 
@@ -243,17 +362,48 @@ int mcp_http_transport_start_impl(mcp_transport_t *transport) {
     char listen_url[512];
     snprintf(listen_url, sizeof(listen_url), "http://%s:%d", data->bind_address, data->port);
 
+    // 启动工作线程池 - 需要HAL支持跨线程投递响应；在服务器开始接收请求前创建，
+    // 此后直到服务器停止worker_pool指针都不再改变
+    if (data->worker_threads > 0) {
+        if (data->hal->network.http_response_post) {
+            data->worker_pool = mcp_worker_pool_create((size_t)data->worker_threads,
+                                                       (size_t)data->worker_threads * 64);
+        }
+        if (!data->worker_pool) {
+            mcp_log_warn("HTTP Transport: Worker pool unavailable, handling requests on the poll thread");
+        }
+    }
+
+    // 请求体上限交给HAL，超限请求在缓冲请求体之前就被拒绝
+    if (data->max_request_size > 0 && data->hal->network.http_set_max_body_size &&
+        data->hal->network.http_set_max_body_size(data->max_request_size) != 0) {
+        mcp_log_warn("HTTP Transport: Platform cannot buffer %lu byte requests, limit lowered",
+                     (unsigned long)data->max_request_size);
+    }
+
     // 通过HAL启动HTTP服务器 - 使用通用接口名称
-    data->server = data->hal->network.http_server_start(listen_url, http_request_handler, data);
+    if (data->event_loops > 1 && data->hal->network.http_server_start_sharded) {
+        data->server = data->hal->network.http_server_start_sharded(listen_url, data->event_loops,
+                                                                    http_request_handler, data);
+    } else {
+        if (data->event_loops > 1) {
+            mcp_log_warn("HTTP Transport: Sharded event loops not supported, using a single loop");
+            data->event_loops = 1;
+        }
+        data->server = data->hal->network.http_server_start(listen_url, http_request_handler, data);
+    }
     if (!data->server) {
         mcp_log_error("HTTP Transport: Failed to start server on %s", listen_url);
+        mcp_worker_pool_destroy(data->worker_pool);
+        data->worker_pool = NULL;
         return -1;
     }
 
     data->server_running = true;
     transport->state = MCP_TRANSPORT_STATE_RUNNING;
 
-    mcp_log_info("HTTP Transport: Server started on %s:%d", data->bind_address, data->port);
+    mcp_log_info("HTTP Transport: Server started on %s:%d (%d event loop%s)", data->bind_address, data->port,
+                 data->event_loops, data->event_loops > 1 ? "s" : "");
     return 0;
 }
 
@@ -268,12 +418,23 @@ int mcp_http_transport_stop_impl(mcp_transport_t *transport) {
         return 0;
     }
 
-    // 通过HAL停止服务器 - 使用通用接口名称
+    // 先让工作线程处理完已接收的请求并送出响应（调用方已排空时直接返回）
+    mcp_http_transport_drain(transport);
+    if (data->worker_pool) {
+        mcp_worker_pool_shutdown(data->worker_pool);
+    }
+
+    // 通过HAL停止服务器 - 使用通用接口名称；返回后不再有线程调用请求处理函数
     if (data->server) {
         data->hal->network.http_server_stop(data->server);
         data->server = NULL;
     }
 
+    if (data->worker_pool) {
+        mcp_worker_pool_destroy(data->worker_pool);
+        data->worker_pool = NULL;
+    }
+
     data->server_running = false;
     transport->state = MCP_TRANSPORT_STATE_STOPPED;
 
@@ -286,41 +447,13 @@ int mcp_http_transport_send_impl(mcp_connection_t *connection, const char *messa
         return -1;
     }
 
-    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)connection->transport->private_data;
-    if (!data) {
-        return -1;
-    }
-
-    // 获取HAL连接
-    mcp_hal_connection_t hal_conn = (mcp_hal_connection_t)connection->private_data;
-    if (!hal_conn) {
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+    if (!ctx || !connection->transport || !connection->transport->private_data) {
         mcp_log_error("HTTP Transport: No HAL connection in send");
         return -1;
     }
 
-    char headers[1024];
-    int written = 0;
-    written += snprintf(headers + written, sizeof(headers) - (size_t)written,
-                        "Content-Type: application/json\r\n"
-                        "Access-Control-Allow-Origin: *\r\n"
-                        "Access-Control-Allow-Headers: Content-Type, Authorization, MCP-Session-Id, MCP-Protocol-Version\r\n"
-                        "MCP-Protocol-Version: %s\r\n",
-                        MCP_PROTOCOL_VERSION);
-    if (connection->session_id && connection->session_id[0] != '\0' && (size_t)written < sizeof(headers)) {
-        written += snprintf(headers + written, sizeof(headers) - (size_t)written,
-                            "MCP-Session-Id: %s\r\n", connection->session_id);
-    }
-
-    // 构造HAL响应
-    mcp_hal_http_response_t response = {
-        .status_code = 200,
-        .headers = headers,
-        .body = message,
-        .body_len = length
-    };
-
-    // 通过HAL发送响应 - 使用通用接口名称
-    int result = data->hal->network.http_response_send(hal_conn, &response);
+    int result = http_connection_reply(connection, 200, message, length);
     if (result > 0) {
         mcp_log_debug("HTTP Transport: Sent response (%zu bytes)", length);
     }
@@ -352,13 +485,48 @@ int mcp_http_transport_get_stats_impl(mcp_transport_t *transport, void *stats) {
         bool server_running;
     } *http_stats = stats;
 
-    http_stats->total_requests = data->total_requests;
+    http_stats->total_requests = MCP_ATOMIC_LOAD(&data->total_requests);
     http_stats->active_connections = data->active_connections;
     http_stats->server_running = data->server_running;
 
     return 0;
 }
 
+// 分离连接：只能在消息回调中调用，之后的响应一律通过HAL投递（任意线程）
+mcp_connection_t *mcp_http_transport_detach_connection_impl(mcp_connection_t *connection) {
+    if (!connection || !connection->transport || !connection->transport->private_data) {
+        return NULL;
+    }
+
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)connection->transport->private_data;
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+    if (!ctx || ctx->responded || !data->hal->network.http_response_post) {
+        return NULL;
+    }
+
+    ctx->deferred = true;
+    ctx->detached = true;
+    MCP_REF_INC(&ctx->ref_count);
+    return connection;
+}
+
+// 只有在工作线程上处理的请求可以提前响应：投递的响应由轮询线程送出，
+// 在轮询线程上同步处理时它要等处理函数返回才能送出
+bool mcp_http_transport_can_reply_early_impl(const mcp_connection_t *connection) {
+    const mcp_http_request_ctx_t* ctx = connection ? (const mcp_http_request_ctx_t*)connection->private_data : NULL;
+    return ctx && ctx->on_worker;
+}
+
+// 最后一个引用释放时销毁连接对象（不访问传输层，传输停止后也可调用）
+void mcp_http_transport_release_connection_impl(mcp_connection_t *connection) {
+    if (!connection) return;
+
+    mcp_http_request_ctx_t* ctx = (mcp_http_request_ctx_t*)connection->private_data;
+    if (!ctx || MCP_REF_DEC(&ctx->ref_count) == 0) {
+        http_connection_destroy(connection);
+    }
+}
+
 void mcp_http_transport_cleanup_impl(mcp_transport_t *transport) {
     if (!transport || !transport->private_data) {
         return;
@@ -384,6 +552,10 @@ void mcp_http_transport_cleanup_impl(mcp_transport_t *transport) {
 
 // 轮询函数 - 供主循环调用
 int mcp_http_transport_poll(mcp_transport_t *transport) {
+    return mcp_http_transport_poll_wait(transport, 10); // 10ms超时
+}
+
+int mcp_http_transport_poll_wait(mcp_transport_t *transport, int timeout_ms) {
     if (!transport || !transport->private_data) {
         return -1;
     }
@@ -392,8 +564,72 @@ int mcp_http_transport_poll(mcp_transport_t *transport) {
 
     // 通过HAL轮询 - 使用通用接口名称
     if (data->server_running && data->hal) {
-        return data->hal->network.network_poll(10); // 10ms超时
+        // 平台不支持唤醒时退回短超时，避免停止请求和工作线程响应被长时间延迟
+        if (!data->hal->network.network_wakeup && timeout_ms > 10) {
+            timeout_ms = 10;
+        }
+        return data->hal->network.network_poll(timeout_ms);
     }
 
     return 0;
 }
+
+int mcp_http_transport_drain(mcp_transport_t *transport) {
+    if (!transport || !transport->private_data) {
+        return -1;
+    }
+
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)transport->private_data;
+    if (!data->server_running || !data->worker_pool) {
+        return 0;
+    }
+
+    // 之后到达的请求提交失败，直接回复503；分片模式下各分片线程自己送出响应，
+    // 单循环模式下只有这里的轮询会送出
+    mcp_worker_pool_close(data->worker_pool);
+    while (!mcp_worker_pool_is_drained(data->worker_pool)) {
+        mcp_http_transport_poll_wait(transport, 10);
+    }
+
+    // 最后完成的请求：一轮把投递的响应放进发送缓冲区，再一轮写出
+    for (int i = 0; i < 2; i++) {
+        mcp_http_transport_poll_wait(transport, 10);
+    }
+    return 0;
+}
+
+int mcp_http_transport_wakeup(mcp_transport_t *transport) {
+    if (!transport || !transport->private_data) {
+        return -1;
+    }
+
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)transport->private_data;
+    if (!data->hal || !data->hal->network.network_wakeup) {
+        return -1;
+    }
+
+    return data->hal->network.network_wakeup();
+}
+
+int mcp_http_transport_get_shard_stats(mcp_transport_t *transport,
+                                       mcp_hal_shard_stats_t *stats, int max_shards) {
+    if (!transport || !transport->private_data || !stats || max_shards <= 0) {
+        return -1;
+    }
+
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)transport->private_data;
+    if (!data->server_running || !data->hal || !data->hal->network.network_get_shard_stats) {
+        return -1;
+    }
+
+    return data->hal->network.network_get_shard_stats(stats, max_shards);
+}
+
+mcp_worker_pool_t *mcp_http_transport_get_worker_pool(mcp_transport_t *transport) {
+    if (!transport || !transport->private_data) {
+        return NULL;
+    }
+
+    mcp_http_transport_data_t *data = (mcp_http_transport_data_t*)transport->private_data;
+    return data->worker_pool;
+}
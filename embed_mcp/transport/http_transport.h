@@ -3,6 +3,7 @@
 
 #include "transport_interface.h"
 #include "../hal/platform_hal.h"
+#include "../application/worker_pool.h"
 
 // HTTP transport specific structures (使用HAL接口)
 typedef struct {
@@ -12,11 +13,13 @@ typedef struct {
     char *endpoint_path;
     bool enable_cors;
     size_t max_request_size;
+    int worker_threads;
+    int event_loops;
 
     // 状态
     bool server_running;
 
-    // 统计信息
+    // 统计信息（分片模式下由多个事件循环线程并发更新）
     size_t total_requests;
     size_t active_connections;
 
@@ -26,8 +29,24 @@ typedef struct {
     // HAL接口
     const mcp_platform_hal_t* hal;
     mcp_hal_server_t server;      // HAL服务器句柄
+
+    // 工作线程池 - 为NULL时在轮询线程内同步处理请求
+    mcp_worker_pool_t* worker_pool;
 } mcp_http_transport_data_t;
 
+// 单个HTTP请求的上下文 (mcp_connection_t.private_data)
+typedef struct {
+    mcp_hal_connection_t hal_conn;   // HAL连接，仅在轮询线程内有效
+    unsigned long hal_conn_id;       // 稳定的连接ID，工作线程通过它投递响应
+    bool deferred;                   // 通过HAL投递响应（工作线程处理或连接已分离）
+    bool on_worker;                  // 请求在工作线程上处理
+    bool detached;                   // 连接已分离，响应稍后发送
+    bool responded;                  // 已发送响应
+    int ref_count;                   // 分发流程持有一个引用，分离后再加一个
+    char* body;                      // 请求体副本（仅工作线程模式）
+    size_t body_len;
+} mcp_http_request_ctx_t;
+
 // HTTP transport interface implementation
 extern const mcp_transport_interface_t mcp_http_transport_interface;
 
@@ -38,11 +57,31 @@ int mcp_http_transport_stop_impl(mcp_transport_t *transport);
 int mcp_http_transport_send_impl(mcp_connection_t *connection, const char *message, size_t length);
 int mcp_http_transport_close_connection_impl(mcp_connection_t *connection);
 int mcp_http_transport_get_stats_impl(mcp_transport_t *transport, void *stats);
+mcp_connection_t *mcp_http_transport_detach_connection_impl(mcp_connection_t *connection);
+void mcp_http_transport_release_connection_impl(mcp_connection_t *connection);
+bool mcp_http_transport_can_reply_early_impl(const mcp_connection_t *connection);
 void mcp_http_transport_cleanup_impl(mcp_transport_t *transport);
 
 // 轮询函数 - 供主循环调用
 int mcp_http_transport_poll(mcp_transport_t *transport);
 
+// 阻塞轮询，直到有网络事件、被唤醒或超时 (timeout_ms)
+int mcp_http_transport_poll_wait(mcp_transport_t *transport, int timeout_ms);
+
+// 唤醒阻塞中的轮询 - 可在任意线程或信号处理函数中调用
+int mcp_http_transport_wakeup(mcp_transport_t *transport);
+
+// 停止前排空工作线程：不再接收新请求，等已接收的请求处理完且响应送出后返回。
+// 单循环模式下在调用线程上继续轮询，工作线程投递的响应才能送出
+int mcp_http_transport_drain(mcp_transport_t *transport);
+
+// 各事件循环分片的统计 - 返回写入的条目数，失败返回-1
+int mcp_http_transport_get_shard_stats(mcp_transport_t *transport,
+                                       mcp_hal_shard_stats_t *stats, int max_shards);
+
+// 工作线程池 - 未配置工作线程时为NULL；上层可借它并行处理批量请求中的各项
+mcp_worker_pool_t *mcp_http_transport_get_worker_pool(mcp_transport_t *transport);
+
 #endif // MCP_HTTP_TRANSPORT_H
 int mcp_http_add_connection(mcp_transport_t *transport, mcp_connection_t *connection);
 int mcp_http_remove_connection(mcp_transport_t *transport, mcp_connection_t *connection);
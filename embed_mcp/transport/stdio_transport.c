@@ -14,6 +14,9 @@ const mcp_transport_interface_t mcp_stdio_transport_interface = {
     .send = mcp_stdio_transport_send_impl,
     .close_connection = mcp_stdio_transport_close_connection_impl,
     .get_stats = mcp_stdio_transport_get_stats_impl,
+    .detach_connection = mcp_stdio_transport_detach_connection_impl,
+    .release_connection = mcp_stdio_transport_release_connection_impl,
+    .can_reply_early = mcp_stdio_transport_can_reply_early_impl,
     .cleanup = mcp_stdio_transport_cleanup_impl
 };
 
@@ -160,6 +163,23 @@ int mcp_stdio_transport_get_stats_impl(mcp_transport_t *transport, void *stats)
     return 0;
 }
 
+// Messages arrive on a connection that only lives for the callback; a detached
+// connection is a heap copy writing to the same output stream
+mcp_connection_t *mcp_stdio_transport_detach_connection_impl(mcp_connection_t *connection) {
+    if (!connection || !connection->transport) return NULL;
+    
+    return mcp_stdio_connection_create(connection->transport);
+}
+
+void mcp_stdio_transport_release_connection_impl(mcp_connection_t *connection) {
+    mcp_stdio_connection_destroy(connection);
+}
+
+// Any thread writes straight to the output stream
+bool mcp_stdio_transport_can_reply_early_impl(const mcp_connection_t *connection) {
+    return connection != NULL;
+}
+
 void mcp_stdio_transport_cleanup_impl(mcp_transport_t *transport) {
     if (!transport || !transport->private_data) return;
 
@@ -198,48 +218,97 @@ int mcp_stdio_transport_setup_buffering(mcp_stdio_transport_data_t *data,
     const mcp_platform_hal_t *hal = mcp_platform_get_hal();
     if (!hal) return -1;
     
-    data->input_buffer = hal->memory.alloc(buffer_size);
+    // Start small; the buffer only grows to buffer_size for lines that need it
+    // (room for the line, its delimiter and the terminator)
+    size_t capacity = buffer_size + 2 < 8192 ? buffer_size + 2 : 8192;
+    data->input_buffer = hal->memory.alloc(capacity);
     if (!data->input_buffer) return -1;
     
     data->input_buffer_size = 0;
-    data->input_buffer_capacity = buffer_size;
+    data->input_buffer_capacity = capacity;
+    data->max_line_size = buffer_size;
     data->line_buffered = line_buffered;
     
     return 0;
 }
 
+// Read one line into input_buffer without its delimiter, growing the buffer up to
+// max_line_size. Returns 1 for a line, 0 for a line that was too long (its bytes are
+// skipped), -1 at end of input or on a read error.
+static int mcp_stdio_read_line(mcp_stdio_transport_data_t *data, const mcp_platform_hal_t *hal) {
+    bool too_long = false;
+    data->input_buffer_size = 0;
+
+    for (;;) {
+        // Full buffer without a delimiter: grow it, or drop the line once it is over the limit
+        if (data->input_buffer_size + 1 >= data->input_buffer_capacity) {
+            size_t limit = data->max_line_size + 2;
+            if (data->input_buffer_capacity >= limit) {
+                too_long = true;
+                data->input_buffer_size = 0;
+            } else {
+                size_t capacity = data->input_buffer_capacity * 2 < limit ? data->input_buffer_capacity * 2 : limit;
+                char *buffer = hal->memory.realloc(data->input_buffer, capacity);
+                if (!buffer) {
+                    too_long = true;
+                    data->input_buffer_size = 0;
+                } else {
+                    data->input_buffer = buffer;
+                    data->input_buffer_capacity = capacity;
+                }
+            }
+        }
+
+        char *chunk = data->input_buffer + data->input_buffer_size;
+        if (fgets(chunk, (int)(data->input_buffer_capacity - data->input_buffer_size), data->input_stream) == NULL) {
+            // The last line may end without a delimiter
+            if (data->input_buffer_size == 0 && !too_long) return -1;
+            break;
+        }
+
+        data->input_buffer_size += strlen(chunk);
+        if (data->input_buffer_size > 0 && data->input_buffer[data->input_buffer_size - 1] == data->line_delimiter) {
+            data->input_buffer[--data->input_buffer_size] = '\0';
+            break;
+        }
+    }
+
+    return too_long ? 0 : 1;
+}
+
 void *mcp_stdio_transport_reader_thread(void *arg) {
     mcp_transport_t *transport = (mcp_transport_t*)arg;
     mcp_stdio_transport_data_t *data = (mcp_stdio_transport_data_t*)transport->private_data;
     
     if (!data) return NULL;
-    
-    char line_buffer[8192];
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
     
     while (data->thread_running) {
         // Read line from input stream
-        if (fgets(line_buffer, sizeof(line_buffer), data->input_stream) == NULL) {
-            if (feof(data->input_stream)) {
-                // End of input
-                break;
-            } else if (ferror(data->input_stream)) {
+        int result = mcp_stdio_read_line(data, hal);
+        if (result < 0) {
+            if (ferror(data->input_stream)) {
                 // Error reading
                 mcp_stdio_handle_error(transport, errno, "Error reading from stdin");
-                break;
             }
-            continue;
+            // End of input
+            break;
         }
-        
-        // Remove trailing newline
-        size_t len = strlen(line_buffer);
-        if (len > 0 && line_buffer[len - 1] == '\n') {
-            line_buffer[len - 1] = '\0';
-            len--;
+
+        if (result == 0) {
+            // The request id is unknown without parsing the line, so the error cannot name it
+            mcp_stdio_handle_error(transport, EMSGSIZE, "Message too large");
+            mcp_stdio_send_output_line(transport,
+                "{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32600,"
+                "\"message\":\"Invalid Request\",\"data\":\"Message too large\"}}");
+            continue;
         }
         
         // Process the line
-        if (len > 0) {
-            mcp_stdio_process_input_line(transport, line_buffer);
+        if (data->input_buffer_size > 0) {
+            mcp_stdio_process_input_line(transport, data->input_buffer);
         }
     }
     
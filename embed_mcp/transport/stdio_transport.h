@@ -16,10 +16,11 @@ typedef struct {
     pthread_mutex_t output_mutex;
     bool thread_running;
     
-    // Buffering
+    // Buffering - the input buffer grows up to max_line_size, the longest accepted line
     char *input_buffer;
     size_t input_buffer_size;
     size_t input_buffer_capacity;
+    size_t max_line_size;
     
     // Line-based processing
     bool line_buffered;
@@ -42,6 +43,9 @@ int mcp_stdio_transport_stop_impl(mcp_transport_t *transport);
 int mcp_stdio_transport_send_impl(mcp_connection_t *connection, const char *message, size_t length);
 int mcp_stdio_transport_close_connection_impl(mcp_connection_t *connection);
 int mcp_stdio_transport_get_stats_impl(mcp_transport_t *transport, void *stats);
+mcp_connection_t *mcp_stdio_transport_detach_connection_impl(mcp_connection_t *connection);
+void mcp_stdio_transport_release_connection_impl(mcp_connection_t *connection);
+bool mcp_stdio_transport_can_reply_early_impl(const mcp_connection_t *connection);
 void mcp_stdio_transport_cleanup_impl(mcp_transport_t *transport);
 
 // STDIO utility functions
@@ -4,6 +4,7 @@
 #include "hal/platform_hal.h"
 #include "hal/hal_common.h"
 #include "utils/logging.h"
+#include "utils/atomic.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -211,10 +212,11 @@ int mcp_connection_send(mcp_connection_t *connection, const char *message, size_
     
     int result = connection->transport->interface->send(connection, message, length);
     if (result == 0) {
-        connection->messages_sent++;
-        connection->bytes_sent += length;
-        connection->last_activity = time(NULL);
-        connection->transport->messages_sent++;
+        // Replies of async tools and progress notifications are sent from other threads
+        MCP_ATOMIC_INC(&connection->messages_sent);
+        MCP_ATOMIC_ADD(&connection->bytes_sent, length);
+        MCP_ATOMIC_STORE(&connection->last_activity, time(NULL));
+        MCP_ATOMIC_INC(&connection->transport->messages_sent);
     }
     
     return result;
@@ -234,10 +236,40 @@ int mcp_connection_close(mcp_connection_t *connection) {
     return result;
 }
 
+mcp_connection_t *mcp_connection_detach(mcp_connection_t *connection) {
+    if (!connection || !connection->transport || !connection->transport->interface) return NULL;
+    
+    if (!connection->transport->interface->detach_connection) return NULL;
+    
+    return connection->transport->interface->detach_connection(connection);
+}
+
+void mcp_connection_release(mcp_connection_t *connection) {
+    if (!connection || !connection->transport || !connection->transport->interface) return;
+    
+    if (connection->transport->interface->release_connection) {
+        connection->transport->interface->release_connection(connection);
+    }
+}
+
 bool mcp_connection_is_active(const mcp_connection_t *connection) {
     return connection && connection->is_active;
 }
 
+bool mcp_connection_can_notify(const mcp_connection_t *connection) {
+    // Plain HTTP answers each POST with exactly one message and has no event stream
+    return connection && connection->transport &&
+           connection->transport->type == MCP_TRANSPORT_STDIO;
+}
+
+bool mcp_connection_can_reply_early(const mcp_connection_t *connection) {
+    if (!connection || !connection->transport || !connection->transport->interface) return false;
+
+    if (!connection->transport->interface->can_reply_early) return false;
+
+    return connection->transport->interface->can_reply_early(connection);
+}
+
 const char *mcp_connection_get_id(const mcp_connection_t *connection) {
     return connection ? connection->connection_id : NULL;
 }
@@ -55,6 +55,8 @@ typedef struct {
             char *endpoint_path;   // MCP endpoint path (default: "/mcp")
             bool enable_cors;
             size_t max_request_size;
+            int worker_threads;    // Request handler threads (0: handle on the poll thread)
+            int event_loops;       // SO_REUSEPORT event loop shards (0/1: single loop)
         } http;
     } config;
 } mcp_transport_config_t;
@@ -79,6 +81,18 @@ typedef struct {
     // Get transport statistics
     int (*get_stats)(mcp_transport_t *transport, void *stats);
 
+    // Keep a connection past the message callback so that a reply can be sent later,
+    // from any thread (NULL if the transport cannot defer replies)
+    mcp_connection_t *(*detach_connection)(mcp_connection_t *connection);
+
+    // Drop a connection returned by detach_connection
+    void (*release_connection)(mcp_connection_t *connection);
+
+    // Whether a reply sent from another thread reaches the peer while the request is
+    // still being handled, i.e. the handler does not hold up the thread that delivers
+    // deferred replies (NULL: never)
+    bool (*can_reply_early)(const mcp_connection_t *connection);
+
     // Cleanup resources
     void (*cleanup)(mcp_transport_t *transport);
 } mcp_transport_interface_t;
@@ -148,7 +162,14 @@ void mcp_transport_set_callbacks(mcp_transport_t *transport,
 // Connection management
 int mcp_connection_send(mcp_connection_t *connection, const char *message, size_t length);
 int mcp_connection_close(mcp_connection_t *connection);
+// Deferred replies: detach during the message callback, send later, then release
+mcp_connection_t *mcp_connection_detach(mcp_connection_t *connection);
+void mcp_connection_release(mcp_connection_t *connection);
 bool mcp_connection_is_active(const mcp_connection_t *connection);
+// Whether messages besides the responses (e.g. notifications) can be sent to the peer
+bool mcp_connection_can_notify(const mcp_connection_t *connection);
+// Whether a deferred reply can be answered before the current request's handler returns
+bool mcp_connection_can_reply_early(const mcp_connection_t *connection);
 const char *mcp_connection_get_id(const mcp_connection_t *connection);
 const char *mcp_connection_get_session_id(const mcp_connection_t *connection);
 int mcp_connection_set_session_id(mcp_connection_t *connection, const char *session_id);
@@ -0,0 +1,289 @@
+#include "utils/arena.h"
+#include "hal/platform_hal.h"
+#include "cjson/cJSON.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alignment good enough for any cJSON node or string
+#define MCP_ARENA_ALIGN 16
+// Chunks kept across resets; anything beyond is returned to the HAL
+#define MCP_ARENA_RETAIN_CHUNKS 4
+
+typedef struct mcp_arena_chunk {
+    struct mcp_arena_chunk *next;
+    size_t size;
+    size_t used;
+    // Data follows the header, aligned to MCP_ARENA_ALIGN
+} mcp_arena_chunk_t;
+
+struct mcp_arena {
+    size_t chunk_size;
+    mcp_arena_chunk_t *head;
+    mcp_arena_chunk_t *current;
+    void *last_alloc;           // Most recent allocation, may be popped on free
+    mcp_arena_stats_t stats;
+};
+
+// Per-thread request scope
+typedef struct {
+    mcp_arena_t *arena;
+    bool active;
+} mcp_arena_thread_t;
+
+static pthread_key_t g_thread_key;
+static pthread_once_t g_hooks_once = PTHREAD_ONCE_INIT;
+static bool g_hooks_installed = false;
+
+#define CHUNK_HEADER_SIZE ((sizeof(mcp_arena_chunk_t) + MCP_ARENA_ALIGN - 1) & ~(size_t)(MCP_ARENA_ALIGN - 1))
+#define CHUNK_DATA(chunk) ((char*)(chunk) + CHUNK_HEADER_SIZE)
+
+static mcp_arena_chunk_t *arena_chunk_create(size_t size) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    mcp_arena_chunk_t *chunk = hal->memory.alloc(CHUNK_HEADER_SIZE + size);
+    if (!chunk) return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+mcp_arena_t *mcp_arena_create(size_t chunk_size) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    mcp_arena_t *arena = hal->memory.alloc(sizeof(mcp_arena_t));
+    if (!arena) return NULL;
+    memset(arena, 0, sizeof(mcp_arena_t));
+
+    arena->chunk_size = chunk_size ? chunk_size : MCP_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->head = arena_chunk_create(arena->chunk_size);
+    if (!arena->head) {
+        hal->memory.free(arena);
+        return NULL;
+    }
+    arena->current = arena->head;
+    arena->stats.chunks = 1;
+
+    return arena;
+}
+
+void mcp_arena_destroy(mcp_arena_t *arena) {
+    if (!arena) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    mcp_arena_chunk_t *chunk = arena->head;
+    while (chunk) {
+        mcp_arena_chunk_t *next = chunk->next;
+        hal->memory.free(chunk);
+        chunk = next;
+    }
+    hal->memory.free(arena);
+}
+
+void *mcp_arena_alloc(mcp_arena_t *arena, size_t size) {
+    if (!arena || size == 0) return NULL;
+
+    size = (size + MCP_ARENA_ALIGN - 1) & ~(size_t)(MCP_ARENA_ALIGN - 1);
+
+    // Large blocks would waste most of a chunk; leave them to the heap
+    if (size > arena->chunk_size / 4) {
+        arena->stats.heap_fallbacks++;
+        return NULL;
+    }
+
+    mcp_arena_chunk_t *chunk = arena->current;
+    if (chunk->used + size > chunk->size) {
+        // Reuse a chunk kept from an earlier request before growing
+        if (!chunk->next) {
+            chunk->next = arena_chunk_create(arena->chunk_size);
+            if (!chunk->next) {
+                arena->stats.heap_fallbacks++;
+                return NULL;
+            }
+            arena->stats.chunks++;
+        }
+        chunk = chunk->next;
+        chunk->used = 0;
+        arena->current = chunk;
+    }
+
+    void *ptr = CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+    arena->last_alloc = ptr;
+    arena->stats.allocations++;
+    arena->stats.bytes_used += size;
+    return ptr;
+}
+
+bool mcp_arena_owns(const mcp_arena_t *arena, const void *ptr) {
+    if (!arena || !ptr) return false;
+
+    const char *p = (const char*)ptr;
+    for (const mcp_arena_chunk_t *chunk = arena->head; chunk; chunk = chunk->next) {
+        const char *data = CHUNK_DATA(chunk);
+        if (p >= data && p < data + chunk->size) {
+            return true;
+        }
+        if (chunk == arena->current) break;
+    }
+    return false;
+}
+
+// Give back the most recent allocation (cJSON's print buffers grow by malloc+copy+free)
+static void arena_release(mcp_arena_t *arena, void *ptr) {
+    if (ptr != arena->last_alloc) return;
+
+    mcp_arena_chunk_t *chunk = arena->current;
+    size_t offset = (size_t)((char*)ptr - CHUNK_DATA(chunk));
+    if (offset < chunk->used) {
+        arena->stats.bytes_used -= chunk->used - offset;
+        chunk->used = offset;
+    }
+    arena->last_alloc = NULL;
+}
+
+void mcp_arena_reset(mcp_arena_t *arena) {
+    if (!arena) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    size_t kept = 0;
+    mcp_arena_chunk_t *chunk = arena->head;
+    mcp_arena_chunk_t *prev = NULL;
+    while (chunk) {
+        mcp_arena_chunk_t *next = chunk->next;
+        if (kept < MCP_ARENA_RETAIN_CHUNKS) {
+            chunk->used = 0;
+            prev = chunk;
+            kept++;
+        } else {
+            prev->next = NULL;
+            hal->memory.free(chunk);
+        }
+        chunk = next;
+    }
+
+    arena->current = arena->head;
+    arena->last_alloc = NULL;
+    memset(&arena->stats, 0, sizeof(arena->stats));
+    arena->stats.chunks = kept;
+}
+
+void mcp_arena_get_stats(const mcp_arena_t *arena, mcp_arena_stats_t *stats) {
+    if (!stats) return;
+    if (!arena) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = arena->stats;
+}
+
+// cJSON hooks
+static mcp_arena_thread_t *arena_thread_state(void) {
+    return g_hooks_installed ? pthread_getspecific(g_thread_key) : NULL;
+}
+
+static void *arena_hook_malloc(size_t size) {
+    mcp_arena_thread_t *state = arena_thread_state();
+    if (state && state->active) {
+        void *ptr = mcp_arena_alloc(state->arena, size);
+        if (ptr) return ptr;
+    }
+    return malloc(size);
+}
+
+static void arena_hook_free(void *ptr) {
+    if (!ptr) return;
+
+    // Checked even while suspended: the request may drop arena objects in a heap section
+    mcp_arena_thread_t *state = arena_thread_state();
+    if (state && mcp_arena_owns(state->arena, ptr)) {
+        arena_release(state->arena, ptr);
+        return;
+    }
+    free(ptr);
+}
+
+static void arena_thread_destroy(void *ptr) {
+    mcp_arena_thread_t *state = (mcp_arena_thread_t*)ptr;
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    mcp_arena_destroy(state->arena);
+    if (hal) hal->memory.free(state);
+}
+
+static void arena_install_hooks_once(void) {
+    if (pthread_key_create(&g_thread_key, arena_thread_destroy) != 0) {
+        return;
+    }
+
+    cJSON_Hooks hooks = {
+        .malloc_fn = arena_hook_malloc,
+        .free_fn = arena_hook_free
+    };
+    cJSON_InitHooks(&hooks);
+    g_hooks_installed = true;
+}
+
+int mcp_arena_install_cjson_hooks(void) {
+    pthread_once(&g_hooks_once, arena_install_hooks_once);
+    return g_hooks_installed ? 0 : -1;
+}
+
+bool mcp_arena_cjson_hooks_installed(void) {
+    return g_hooks_installed;
+}
+
+int mcp_arena_request_begin(void) {
+    if (!g_hooks_installed) return -1;
+
+    mcp_arena_thread_t *state = pthread_getspecific(g_thread_key);
+    if (!state) {
+        const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+        if (!hal) return -1;
+
+        state = hal->memory.alloc(sizeof(mcp_arena_thread_t));
+        if (!state) return -1;
+
+        state->arena = mcp_arena_create(MCP_ARENA_DEFAULT_CHUNK_SIZE);
+        state->active = false;
+        if (!state->arena || pthread_setspecific(g_thread_key, state) != 0) {
+            mcp_arena_destroy(state->arena);
+            hal->memory.free(state);
+            return -1;
+        }
+    }
+
+    state->active = true;
+    return 0;
+}
+
+void mcp_arena_request_end(mcp_arena_stats_t *stats) {
+    mcp_arena_thread_t *state = arena_thread_state();
+    if (!state) {
+        if (stats) memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    mcp_arena_get_stats(state->arena, stats);
+    state->active = false;
+    mcp_arena_reset(state->arena);
+}
+
+bool mcp_arena_suspend(void) {
+    mcp_arena_thread_t *state = arena_thread_state();
+    if (!state) return false;
+
+    bool saved = state->active;
+    state->active = false;
+    return saved;
+}
+
+void mcp_arena_resume(bool saved) {
+    mcp_arena_thread_t *state = arena_thread_state();
+    if (state) state->active = saved;
+}
@@ -0,0 +1,52 @@
+#ifndef MCP_ARENA_H
+#define MCP_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bump allocator for request-scoped data.
+// Allocations are carved out of large chunks and never freed one by one;
+// mcp_arena_reset() releases everything at once.
+typedef struct mcp_arena mcp_arena_t;
+
+typedef struct {
+    size_t allocations;     // Served from the arena
+    size_t heap_fallbacks;  // Too large for a chunk, served by the heap instead
+    size_t bytes_used;      // Including alignment padding
+    size_t chunks;          // Chunks currently held
+} mcp_arena_stats_t;
+
+#define MCP_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+// Arena lifecycle
+mcp_arena_t *mcp_arena_create(size_t chunk_size);
+void mcp_arena_destroy(mcp_arena_t *arena);
+
+// Returns NULL when the request does not fit a chunk; the caller falls back to the heap
+void *mcp_arena_alloc(mcp_arena_t *arena, size_t size);
+bool mcp_arena_owns(const mcp_arena_t *arena, const void *ptr);
+// Rewind to empty, keeping a few chunks for the next request; stats restart from zero
+void mcp_arena_reset(mcp_arena_t *arena);
+void mcp_arena_get_stats(const mcp_arena_t *arena, mcp_arena_stats_t *stats);
+
+// Request scope for cJSON.
+// mcp_arena_install_cjson_hooks() routes cJSON's allocator through the calling
+// thread's arena while a request is open. It is process-wide and must be called
+// before other threads use cJSON. Anything cJSON allocates inside the scope
+// (parse trees, results, printed strings) is released by mcp_arena_request_end(),
+// so it must not be kept past the request. Strings from cJSON_Print*() must be
+// released with cJSON_free(), not free().
+int mcp_arena_install_cjson_hooks(void);
+bool mcp_arena_cjson_hooks_installed(void);
+int mcp_arena_request_begin(void);
+// Closes the scope and resets the thread's arena; stats may be NULL
+void mcp_arena_request_end(mcp_arena_stats_t *stats);
+
+// Temporarily allocate from the heap inside a request, for objects that outlive it:
+//     bool saved = mcp_arena_suspend();
+//     ... create long-lived cJSON objects ...
+//     mcp_arena_resume(saved);
+bool mcp_arena_suspend(void);
+void mcp_arena_resume(bool saved);
+
+#endif // MCP_ARENA_H
@@ -0,0 +1,28 @@
+#ifndef MCP_ATOMIC_H
+#define MCP_ATOMIC_H
+
+// Relaxed atomic counters for statistics shared between threads.
+// Uses the GCC/Clang __atomic builtins (available on every supported toolchain);
+// no ordering is implied, so these must not be used to publish other data.
+
+#define MCP_ATOMIC_INC(ptr)         __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define MCP_ATOMIC_DEC(ptr)         __atomic_sub_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define MCP_ATOMIC_ADD(ptr, val)    __atomic_add_fetch((ptr), (val), __ATOMIC_RELAXED)
+#define MCP_ATOMIC_LOAD(ptr)        __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define MCP_ATOMIC_STORE(ptr, val)  __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+
+// Reference counts: the decrement that reaches zero must observe every write
+// made by the other holders before the object is freed.
+#define MCP_REF_INC(ptr)            __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define MCP_REF_DEC(ptr)            __atomic_sub_fetch((ptr), 1, __ATOMIC_ACQ_REL)
+
+// Publishing a pointer: a reader that loads it with MCP_ATOMIC_ACQUIRE sees the
+// object fully initialized
+#define MCP_ATOMIC_PUBLISH(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define MCP_ATOMIC_ACQUIRE(ptr)      __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+
+// One-shot claim: returns the previous value, so exactly one of several racing
+// threads sees 0 and wins (e.g. a result and a deadline both trying to finish a call)
+#define MCP_ATOMIC_CLAIM(ptr)       __atomic_exchange_n((ptr), 1, __ATOMIC_ACQ_REL)
+
+#endif // MCP_ATOMIC_H
@@ -20,6 +20,12 @@ static const int base64_decode_table[128] = {
     41,42,43,44, 45,46,47,48, 49,50,51,-1, -1,-1,-1,-1
 };
 
+// Bytes outside ASCII must not index the table
+static int base64_decode_value(char c) {
+    unsigned char index = (unsigned char)c;
+    return index < 128 ? base64_decode_table[index] : -1;
+}
+
 size_t base64_encoded_size(size_t len) {
     return ((len + 2) / 3) * 4;
 }
@@ -64,10 +70,15 @@ size_t base64_decode(const char *src, size_t len, unsigned char *out, size_t out
 
     size_t i, j;
     for (i = 0, j = 0; i < len; i += 4, j += 3) {
-        int a = base64_decode_table[(int)src[i]];
-        int b = base64_decode_table[(int)src[i + 1]];
-        int c = (src[i + 2] == '=') ? 0 : base64_decode_table[(int)src[i + 2]];
-        int d = (src[i + 3] == '=') ? 0 : base64_decode_table[(int)src[i + 3]];
+        // Padding only ends the last quartet, and "x=y" is not padding
+        int last = (i + 4 == len);
+        if (!last && (src[i + 2] == '=' || src[i + 3] == '=')) return 0;
+        if (src[i + 2] == '=' && src[i + 3] != '=') return 0;
+
+        int a = base64_decode_value(src[i]);
+        int b = base64_decode_value(src[i + 1]);
+        int c = (src[i + 2] == '=') ? 0 : base64_decode_value(src[i + 2]);
+        int d = (src[i + 3] == '=') ? 0 : base64_decode_value(src[i + 3]);
 
         if (a == -1 || b == -1 || c == -1 || d == -1) return 0;
 
@@ -0,0 +1,126 @@
+#include "utils/histogram.h"
+#include "utils/atomic.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+static unsigned histogram_exponent(uint64_t value) {
+    return 63u - (unsigned)__builtin_clzll(value);
+}
+
+static size_t histogram_index(uint64_t value) {
+    if (value < MCP_HISTOGRAM_SUB_BUCKETS) {
+        return (size_t)value;
+    }
+
+    unsigned exponent = histogram_exponent(value);
+    if (exponent > MCP_HISTOGRAM_MAX_EXPONENT) {
+        return MCP_HISTOGRAM_BUCKETS - 1;
+    }
+
+    unsigned shift = exponent - MCP_HISTOGRAM_SUB_BUCKET_BITS;
+    size_t sub_bucket = (size_t)(value >> shift) & (MCP_HISTOGRAM_SUB_BUCKETS - 1);
+    return (size_t)(shift + 1) * MCP_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+static uint64_t histogram_bucket_highest(size_t index) {
+    if (index < MCP_HISTOGRAM_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+
+    unsigned shift = (unsigned)(index / MCP_HISTOGRAM_SUB_BUCKETS) - 1;
+    uint64_t sub_bucket = index % MCP_HISTOGRAM_SUB_BUCKETS;
+    uint64_t lowest = (MCP_HISTOGRAM_SUB_BUCKETS + sub_bucket) << shift;
+    return lowest + ((uint64_t)1 << shift) - 1;
+}
+
+// 1-based rank of the sample at the given percentile
+static uint64_t histogram_rank(double percentile, uint64_t total) {
+    if (percentile > 100.0) percentile = 100.0;
+    uint64_t rank = (uint64_t)ceil(percentile / 100.0 * (double)total);
+    return rank ? rank : 1;
+}
+
+void mcp_histogram_init(mcp_histogram_t *histogram) {
+    if (!histogram) return;
+    memset(histogram, 0, sizeof(*histogram));
+}
+
+void mcp_histogram_record(mcp_histogram_t *histogram, uint64_t value) {
+    if (!histogram) return;
+
+    MCP_ATOMIC_INC(&histogram->counts[histogram_index(value)]);
+
+    uint64_t max = MCP_ATOMIC_LOAD(&histogram->max);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&histogram->max, &max, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // max was reloaded by the failed exchange
+    }
+}
+
+void mcp_histogram_reset(mcp_histogram_t *histogram) {
+    if (!histogram) return;
+
+    for (size_t i = 0; i < MCP_HISTOGRAM_BUCKETS; i++) {
+        MCP_ATOMIC_STORE(&histogram->counts[i], 0);
+    }
+    MCP_ATOMIC_STORE(&histogram->max, 0);
+}
+
+void mcp_histogram_get_summary(const mcp_histogram_t *histogram, mcp_histogram_summary_t *summary) {
+    if (!summary) return;
+    memset(summary, 0, sizeof(*summary));
+    if (!histogram) return;
+
+    // Work on a copy so every percentile sees the same counts
+    uint64_t counts[MCP_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < MCP_HISTOGRAM_BUCKETS; i++) {
+        counts[i] = MCP_ATOMIC_LOAD(&histogram->counts[i]);
+        total += counts[i];
+    }
+
+    summary->count = total;
+    summary->max = MCP_ATOMIC_LOAD(&histogram->max);
+    if (total == 0) return;
+
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    uint64_t *targets[] = { &summary->p50, &summary->p90, &summary->p99, &summary->p999 };
+    size_t next = 0;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < MCP_HISTOGRAM_BUCKETS && next < 4; i++) {
+        seen += counts[i];
+        while (next < 4) {
+            if (seen < histogram_rank(percentiles[next], total)) break;
+
+            uint64_t value = histogram_bucket_highest(i);
+            *targets[next] = value < summary->max ? value : summary->max;
+            next++;
+        }
+    }
+}
+
+uint64_t mcp_histogram_value_at_percentile(const mcp_histogram_t *histogram, double percentile) {
+    if (!histogram) return 0;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < MCP_HISTOGRAM_BUCKETS; i++) {
+        total += MCP_ATOMIC_LOAD(&histogram->counts[i]);
+    }
+    if (total == 0) return 0;
+
+    uint64_t rank = histogram_rank(percentile, total);
+
+    uint64_t max = MCP_ATOMIC_LOAD(&histogram->max);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < MCP_HISTOGRAM_BUCKETS; i++) {
+        seen += MCP_ATOMIC_LOAD(&histogram->counts[i]);
+        if (seen >= rank) {
+            uint64_t value = histogram_bucket_highest(i);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
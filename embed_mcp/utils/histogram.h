@@ -0,0 +1,40 @@
+#ifndef MCP_HISTOGRAM_H
+#define MCP_HISTOGRAM_H
+
+#include <stdint.h>
+
+// Fixed-memory latency histogram (HDR-style log-linear buckets).
+// Each power of two is split into MCP_HISTOGRAM_SUB_BUCKETS linear buckets, so a
+// recorded value is reported within 1/16 (6.25%) of its true value. Values up to
+// 2^(MCP_HISTOGRAM_MAX_EXPONENT+1) are resolved; larger ones land in the last
+// bucket, while max stays exact. Recording is lock-free (relaxed atomics), so a
+// summary taken during concurrent recording may miss the latest few samples.
+#define MCP_HISTOGRAM_SUB_BUCKET_BITS 4
+#define MCP_HISTOGRAM_SUB_BUCKETS (1u << MCP_HISTOGRAM_SUB_BUCKET_BITS)
+#define MCP_HISTOGRAM_MAX_EXPONENT 35   // ~68.7 s when recording nanoseconds
+#define MCP_HISTOGRAM_BUCKETS \
+    ((MCP_HISTOGRAM_MAX_EXPONENT - MCP_HISTOGRAM_SUB_BUCKET_BITS + 2) * MCP_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[MCP_HISTOGRAM_BUCKETS];
+    uint64_t max;
+} mcp_histogram_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} mcp_histogram_summary_t;
+
+void mcp_histogram_init(mcp_histogram_t *histogram);
+void mcp_histogram_record(mcp_histogram_t *histogram, uint64_t value);
+void mcp_histogram_reset(mcp_histogram_t *histogram);
+
+// Percentiles are the highest value equivalent to the bucket they fall in, capped at max
+void mcp_histogram_get_summary(const mcp_histogram_t *histogram, mcp_histogram_summary_t *summary);
+uint64_t mcp_histogram_value_at_percentile(const mcp_histogram_t *histogram, double percentile);
+
+#endif // MCP_HISTOGRAM_H
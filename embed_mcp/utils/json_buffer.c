@@ -0,0 +1,122 @@
+#include "utils/json_buffer.h"
+#include "hal/platform_hal.h"
+#include <pthread.h>
+#include <string.h>
+
+#define MCP_JSON_BUFFER_MIN_CAPACITY 4096
+// cJSON_PrintPreallocated needs a few bytes of slack beyond the printed length
+#define MCP_JSON_BUFFER_SLACK 64
+
+static pthread_key_t g_thread_buffer_key;
+static pthread_once_t g_thread_buffer_once = PTHREAD_ONCE_INIT;
+static bool g_thread_buffer_key_created = false;
+
+void mcp_json_buffer_init(mcp_json_buffer_t *buffer) {
+    if (!buffer) return;
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
+
+void mcp_json_buffer_free(mcp_json_buffer_t *buffer) {
+    if (!buffer) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (buffer->data && hal) {
+        hal->memory.free(buffer->data);
+    }
+    mcp_json_buffer_init(buffer);
+}
+
+int mcp_json_buffer_reserve(mcp_json_buffer_t *buffer, size_t capacity) {
+    if (!buffer) return -1;
+    if (capacity <= buffer->capacity) return 0;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return -1;
+
+    size_t new_capacity = buffer->capacity ? buffer->capacity : MCP_JSON_BUFFER_MIN_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    // The old contents are always overwritten, so there is nothing to carry over
+    char *data = hal->memory.alloc(new_capacity);
+    if (!data) return -1;
+
+    if (buffer->data) {
+        hal->memory.free(buffer->data);
+    }
+    buffer->data = data;
+    buffer->length = 0;
+    buffer->capacity = new_capacity;
+    return 0;
+}
+
+int mcp_json_buffer_print(mcp_json_buffer_t *buffer, const cJSON *item, bool formatted) {
+    if (!buffer || !item) return -1;
+
+    if (buffer->capacity == 0 && mcp_json_buffer_reserve(buffer, MCP_JSON_BUFFER_MIN_CAPACITY) != 0) {
+        return -1;
+    }
+
+    if (cJSON_PrintPreallocated((cJSON*)item, buffer->data, (int)buffer->capacity, formatted)) {
+        buffer->length = strlen(buffer->data);
+        return 0;
+    }
+
+    // Did not fit: let cJSON size it once, then keep the larger buffer for next time
+    char *text = formatted ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+    if (!text) return -1;
+
+    size_t length = strlen(text);
+    if (mcp_json_buffer_reserve(buffer, length + MCP_JSON_BUFFER_SLACK) != 0) {
+        cJSON_free(text);
+        return -1;
+    }
+
+    memcpy(buffer->data, text, length + 1);
+    buffer->length = length;
+    cJSON_free(text);
+    return 0;
+}
+
+void mcp_json_buffer_trim(mcp_json_buffer_t *buffer) {
+    if (buffer && buffer->capacity > MCP_JSON_BUFFER_RETAIN_MAX) {
+        mcp_json_buffer_free(buffer);
+    }
+}
+
+static void thread_buffer_destroy(void *ptr) {
+    mcp_json_buffer_t *buffer = (mcp_json_buffer_t*)ptr;
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    mcp_json_buffer_free(buffer);
+    if (hal) hal->memory.free(buffer);
+}
+
+static void thread_buffer_key_create(void) {
+    g_thread_buffer_key_created = (pthread_key_create(&g_thread_buffer_key, thread_buffer_destroy) == 0);
+}
+
+mcp_json_buffer_t *mcp_json_buffer_thread_local(void) {
+    pthread_once(&g_thread_buffer_once, thread_buffer_key_create);
+    if (!g_thread_buffer_key_created) return NULL;
+
+    mcp_json_buffer_t *buffer = pthread_getspecific(g_thread_buffer_key);
+    if (buffer) return buffer;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal) return NULL;
+
+    buffer = hal->memory.alloc(sizeof(mcp_json_buffer_t));
+    if (!buffer) return NULL;
+    mcp_json_buffer_init(buffer);
+
+    if (pthread_setspecific(g_thread_buffer_key, buffer) != 0) {
+        hal->memory.free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
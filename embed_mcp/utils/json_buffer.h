@@ -0,0 +1,35 @@
+#ifndef MCP_JSON_BUFFER_H
+#define MCP_JSON_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "cjson/cJSON.h"
+
+// Growable output buffer for serialized JSON.
+// The buffer keeps its capacity between uses, so once it has grown to the
+// largest message a thread produces, rendering does not allocate any more.
+typedef struct {
+    char *data;
+    size_t length;      // Bytes of the last rendering, excluding the terminator
+    size_t capacity;
+} mcp_json_buffer_t;
+
+// Buffers larger than this are released by mcp_json_buffer_trim()
+#define MCP_JSON_BUFFER_RETAIN_MAX (1024 * 1024)
+
+void mcp_json_buffer_init(mcp_json_buffer_t *buffer);
+void mcp_json_buffer_free(mcp_json_buffer_t *buffer);
+int mcp_json_buffer_reserve(mcp_json_buffer_t *buffer, size_t capacity);
+
+// Render item into the buffer, replacing its previous contents.
+// Compact output unless formatted is set. Returns 0 on success, -1 on failure.
+int mcp_json_buffer_print(mcp_json_buffer_t *buffer, const cJSON *item, bool formatted);
+
+// Drop the storage if a single large message grew it past MCP_JSON_BUFFER_RETAIN_MAX
+void mcp_json_buffer_trim(mcp_json_buffer_t *buffer);
+
+// Buffer owned by the calling thread, freed when the thread exits.
+// Returns NULL if it could not be set up.
+mcp_json_buffer_t *mcp_json_buffer_thread_local(void);
+
+#endif // MCP_JSON_BUFFER_H
@@ -0,0 +1,263 @@
+#include "utils/timer_wheel.h"
+#include "utils/atomic.h"
+#include "hal/platform_hal.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+// The extra slot holds timers that expired and wait for their callback
+#define EXPIRED_SLOT MCP_TIMER_WHEEL_SLOTS
+
+struct mcp_timer_wheel {
+    uint32_t tick_ms;
+    uint64_t origin_ms;                 // Monotonic time of tick 0
+    uint64_t current;                   // Next tick to process
+    mcp_timer_t *slots[MCP_TIMER_WHEEL_SLOTS + 1];
+    size_t pending;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wakeup;              // Timer added to an idle wheel, or stopping
+    pthread_cond_t fired;               // A callback returned
+    mcp_timer_t *running;               // Timer whose callback is running
+    bool stopping;
+    void *thread;
+
+    int ref_count;
+};
+
+static uint64_t wheel_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static uint64_t wheel_now_tick(const mcp_timer_wheel_t *wheel) {
+    return (wheel_now_ms() - wheel->origin_ms) / wheel->tick_ms;
+}
+
+static void wheel_link(mcp_timer_wheel_t *wheel, mcp_timer_t *timer, uint32_t slot) {
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = wheel->slots[slot];
+    if (timer->next) timer->next->prev = timer;
+    wheel->slots[slot] = timer;
+    timer->pending = true;
+}
+
+static void wheel_unlink(mcp_timer_wheel_t *wheel, mcp_timer_t *timer) {
+    if (timer->prev) timer->prev->next = timer->next;
+    else wheel->slots[timer->slot] = timer->next;
+    if (timer->next) timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+    timer->pending = false;
+}
+
+// Move the timers due at or before now onto the expired list
+static void wheel_advance(mcp_timer_wheel_t *wheel, uint64_t now) {
+    // After a long stall one lap visits every slot; later ticks find nothing new
+    if (now >= wheel->current && now - wheel->current >= MCP_TIMER_WHEEL_SLOTS) {
+        wheel->current = now - MCP_TIMER_WHEEL_SLOTS + 1;
+    }
+
+    for (; wheel->current <= now; wheel->current++) {
+        uint32_t slot = (uint32_t)(wheel->current % MCP_TIMER_WHEEL_SLOTS);
+        mcp_timer_t *timer = wheel->slots[slot];
+        while (timer) {
+            mcp_timer_t *next = timer->next;
+            if (timer->expires <= now) {
+                wheel_unlink(wheel, timer);
+                wheel_link(wheel, timer, EXPIRED_SLOT);
+            }
+            timer = next;
+        }
+    }
+}
+
+static void *wheel_thread_main(void *arg) {
+    mcp_timer_wheel_t *wheel = (mcp_timer_wheel_t*)arg;
+
+    pthread_mutex_lock(&wheel->mutex);
+    while (!wheel->stopping) {
+        if (wheel->pending == 0) {
+            pthread_cond_wait(&wheel->wakeup, &wheel->mutex);
+            continue;
+        }
+
+        wheel_advance(wheel, wheel_now_tick(wheel));
+
+        mcp_timer_t *timer;
+        while ((timer = wheel->slots[EXPIRED_SLOT]) != NULL && !wheel->stopping) {
+            wheel_unlink(wheel, timer);
+            wheel->pending--;
+            wheel->running = timer;
+            pthread_mutex_unlock(&wheel->mutex);
+
+            timer->func(timer, timer->context);
+
+            pthread_mutex_lock(&wheel->mutex);
+            wheel->running = NULL;
+            pthread_cond_broadcast(&wheel->fired);
+        }
+
+        if (wheel->pending > 0 && !wheel->stopping) {
+            // Sleep until the next tick starts
+            uint64_t next_ms = wheel->origin_ms + wheel->current * wheel->tick_ms;
+            struct timespec deadline = {
+                .tv_sec = (time_t)(next_ms / 1000u),
+                .tv_nsec = (long)(next_ms % 1000u) * 1000000L
+            };
+            pthread_cond_timedwait(&wheel->wakeup, &wheel->mutex, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&wheel->mutex);
+
+    return NULL;
+}
+
+mcp_timer_wheel_t *mcp_timer_wheel_create(uint32_t tick_ms) {
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    if (!hal || !hal->thread.create) return NULL;
+
+    mcp_timer_wheel_t *wheel = hal->memory.alloc(sizeof(mcp_timer_wheel_t));
+    if (!wheel) return NULL;
+    memset(wheel, 0, sizeof(mcp_timer_wheel_t));
+
+    wheel->tick_ms = tick_ms > 0 ? tick_ms : MCP_TIMER_WHEEL_DEFAULT_TICK_MS;
+    wheel->origin_ms = wheel_now_ms();
+    wheel->ref_count = 1;
+
+    // Timed waits use the monotonic clock, like the ticks
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+    if (pthread_mutex_init(&wheel->mutex, NULL) != 0) {
+        pthread_condattr_destroy(&attr);
+        hal->memory.free(wheel);
+        return NULL;
+    }
+    if (pthread_cond_init(&wheel->wakeup, &attr) != 0) {
+        pthread_condattr_destroy(&attr);
+        pthread_mutex_destroy(&wheel->mutex);
+        hal->memory.free(wheel);
+        return NULL;
+    }
+    pthread_condattr_destroy(&attr);
+    if (pthread_cond_init(&wheel->fired, NULL) != 0) {
+        pthread_cond_destroy(&wheel->wakeup);
+        pthread_mutex_destroy(&wheel->mutex);
+        hal->memory.free(wheel);
+        return NULL;
+    }
+
+    if (hal->thread.create(&wheel->thread, wheel_thread_main, wheel, 0) != 0) {
+        wheel->thread = NULL;
+        mcp_timer_wheel_unref(wheel);
+        return NULL;
+    }
+
+    return wheel;
+}
+
+void mcp_timer_wheel_destroy(mcp_timer_wheel_t *wheel) {
+    if (!wheel) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+
+    pthread_mutex_lock(&wheel->mutex);
+    wheel->stopping = true;
+    pthread_cond_signal(&wheel->wakeup);
+    pthread_mutex_unlock(&wheel->mutex);
+
+    if (wheel->thread && hal) {
+        hal->thread.join(wheel->thread);
+        wheel->thread = NULL;
+    }
+
+    // Owners still holding timers find them no longer pending
+    pthread_mutex_lock(&wheel->mutex);
+    for (uint32_t slot = 0; slot <= EXPIRED_SLOT; slot++) {
+        while (wheel->slots[slot]) {
+            wheel_unlink(wheel, wheel->slots[slot]);
+        }
+    }
+    wheel->pending = 0;
+    pthread_mutex_unlock(&wheel->mutex);
+
+    mcp_timer_wheel_unref(wheel);
+}
+
+mcp_timer_wheel_t *mcp_timer_wheel_ref(mcp_timer_wheel_t *wheel) {
+    if (wheel) MCP_REF_INC(&wheel->ref_count);
+    return wheel;
+}
+
+void mcp_timer_wheel_unref(mcp_timer_wheel_t *wheel) {
+    if (!wheel || MCP_REF_DEC(&wheel->ref_count) != 0) return;
+
+    const mcp_platform_hal_t *hal = mcp_platform_get_hal();
+    pthread_cond_destroy(&wheel->fired);
+    pthread_cond_destroy(&wheel->wakeup);
+    pthread_mutex_destroy(&wheel->mutex);
+    if (hal) hal->memory.free(wheel);
+}
+
+int mcp_timer_wheel_schedule(mcp_timer_wheel_t *wheel, mcp_timer_t *timer, uint64_t delay_ms,
+                             mcp_timer_func_t func, void *context) {
+    if (!wheel || !timer || !func) return -1;
+
+    pthread_mutex_lock(&wheel->mutex);
+    if (wheel->stopping || timer->pending) {
+        pthread_mutex_unlock(&wheel->mutex);
+        return -1;
+    }
+
+    uint64_t elapsed_ms = wheel_now_ms() - wheel->origin_ms;
+    if (wheel->pending == 0) {
+        // Nothing is linked, so the idle thread's position can jump to now
+        wheel->current = elapsed_ms / wheel->tick_ms;
+    }
+
+    // First tick that starts at or after the deadline
+    uint64_t expires = (elapsed_ms + delay_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+    if (expires < wheel->current) expires = wheel->current;
+
+    timer->func = func;
+    timer->context = context;
+    timer->expires = expires;
+    wheel_link(wheel, timer, (uint32_t)(expires % MCP_TIMER_WHEEL_SLOTS));
+
+    if (wheel->pending++ == 0) {
+        pthread_cond_signal(&wheel->wakeup);
+    }
+    pthread_mutex_unlock(&wheel->mutex);
+
+    return 0;
+}
+
+bool mcp_timer_wheel_cancel(mcp_timer_wheel_t *wheel, mcp_timer_t *timer) {
+    if (!wheel || !timer) return false;
+
+    pthread_mutex_lock(&wheel->mutex);
+    bool cancelled = timer->pending;
+    if (cancelled) {
+        wheel_unlink(wheel, timer);
+        wheel->pending--;
+    }
+    while (wheel->running == timer) {
+        pthread_cond_wait(&wheel->fired, &wheel->mutex);
+    }
+    pthread_mutex_unlock(&wheel->mutex);
+
+    return cancelled;
+}
+
+size_t mcp_timer_wheel_pending(mcp_timer_wheel_t *wheel) {
+    if (!wheel) return 0;
+
+    pthread_mutex_lock(&wheel->mutex);
+    size_t pending = wheel->pending;
+    pthread_mutex_unlock(&wheel->mutex);
+
+    return pending;
+}
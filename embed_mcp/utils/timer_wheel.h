@@ -0,0 +1,52 @@
+#ifndef MCP_TIMER_WHEEL_H
+#define MCP_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hashed timing wheel for deadlines.
+// Timers hash into MCP_TIMER_WHEEL_SLOTS buckets by expiry tick, so scheduling and
+// cancelling are O(1) and each tick only looks at one bucket. One thread per wheel
+// advances it and runs expired callbacks; it sleeps while no timer is scheduled.
+// Expiry is rounded up to the next tick, so a timer never fires early.
+#define MCP_TIMER_WHEEL_SLOTS 256
+#define MCP_TIMER_WHEEL_DEFAULT_TICK_MS 10
+
+typedef struct mcp_timer_wheel mcp_timer_wheel_t;
+typedef struct mcp_timer mcp_timer_t;
+
+typedef void (*mcp_timer_func_t)(mcp_timer_t *timer, void *context);
+
+// Embedded in the owner's object; fields are private to the wheel
+struct mcp_timer {
+    mcp_timer_func_t func;
+    void *context;
+    uint64_t expires;           // Absolute tick
+    bool pending;               // Linked into a slot or the expired list
+    uint32_t slot;
+    mcp_timer_t *prev;
+    mcp_timer_t *next;
+};
+
+mcp_timer_wheel_t *mcp_timer_wheel_create(uint32_t tick_ms);
+// Stops the thread and drops the timers still pending without firing them, then
+// releases the creator's reference
+void mcp_timer_wheel_destroy(mcp_timer_wheel_t *wheel);
+// Extra references keep a stopped wheel valid for owners of timers that may still
+// cancel them (e.g. calls that complete after the registry went away)
+mcp_timer_wheel_t *mcp_timer_wheel_ref(mcp_timer_wheel_t *wheel);
+void mcp_timer_wheel_unref(mcp_timer_wheel_t *wheel);
+
+// Run func(timer, context) on the wheel thread once delay_ms have passed.
+// The timer must not be pending already. Returns -1 if the wheel has stopped.
+int mcp_timer_wheel_schedule(mcp_timer_wheel_t *wheel, mcp_timer_t *timer, uint64_t delay_ms,
+                             mcp_timer_func_t func, void *context);
+// Returns true if the timer was still pending, false if it already fired. Either way
+// its callback is not running once this returns, so the timer may be freed; must not
+// be called from the timer's own callback.
+bool mcp_timer_wheel_cancel(mcp_timer_wheel_t *wheel, mcp_timer_t *timer);
+
+size_t mcp_timer_wheel_pending(mcp_timer_wheel_t *wheel);
+
+#endif // MCP_TIMER_WHEEL_H
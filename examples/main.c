@@ -93,7 +93,7 @@ int calculate_score(int base_points, const char* grade, double multiplier) {
 // =============================================================================
 
 // Array sum function - double[] -> double
-double sum_numbers(double* numbers, size_t count) {
+double sum_numbers(const double* numbers, size_t count) {
     if (!numbers || count == 0) return 0.0;
 
     double sum = 0.0;
@@ -110,25 +110,17 @@ double sum_numbers(double* numbers, size_t count) {
 void* sum_numbers_wrapper(mcp_param_accessor_t* params, void* user_data) {
     (void)user_data;
 
+    // Borrowed view: released by the framework when this wrapper returns
     size_t count;
-    double* numbers = params->get_double_array(params, "numbers", &count);
-
-    if (!numbers || count == 0) {
-        double* result = malloc(sizeof(double));
-        *result = 0.0;
-        return result;
-    }
-
-    double sum = sum_numbers(numbers, count);
-    free(numbers); // Clean up array memory
+    const double* numbers = params->get_double_array_view(params, "numbers", &count);
 
     double* result = malloc(sizeof(double));
-    *result = sum;
+    *result = sum_numbers(numbers, count);
     return result;
 }
 
 // String array join function - string[], string -> string
-char* join_strings(char** strings, size_t count, const char* separator) {
+char* join_strings(const char** strings, size_t count, const char* separator) {
     if (!strings || count == 0) return strdup("");
     if (!separator) separator = ",";
 
@@ -167,30 +159,12 @@ char* join_strings(char** strings, size_t count, const char* separator) {
 void* join_strings_wrapper(mcp_param_accessor_t* params, void* user_data) {
     (void)user_data;
 
+    // The strings are borrowed from the request, nothing to free
     size_t count;
-    char** strings = params->get_string_array(params, "strings", &count);
+    const char** strings = params->get_string_array_view(params, "strings", &count);
     const char* separator = params->get_string(params, "separator");
 
-    if (!strings || count == 0) {
-        if (strings) {
-            // Clean up string array memory
-            for (size_t i = 0; i < count; i++) {
-                if (strings[i]) free(strings[i]);
-            }
-            free(strings);
-        }
-        return strdup("");
-    }
-
-    char* result = join_strings(strings, count, separator);
-
-    // Clean up string array memory
-    for (size_t i = 0; i < count; i++) {
-        if (strings[i]) free(strings[i]);
-    }
-    free(strings);
-
-    return result;
+    return join_strings(strings, count, separator);
 }
 
 // =============================================================================
@@ -225,6 +199,18 @@ cJSON* submit_order_with_schema(const cJSON *args) {
     return result;
 }
 
+// Batch handler: every scale call of a JSON-RPC batch arrives as one set of columns
+void scale_batch(const mcp_batch_t* batch, void* user_data) {
+    (void)user_data;
+    const double* x = batch->columns[0].double_values;
+    const double* k = batch->columns[1].double_values;
+
+    DEBUG_LOG("[DEBUG] Scaling %zu rows\n", batch->count);
+    for (size_t i = 0; i < batch->count; i++) {
+        batch->results[i].double_val = x[i] * k[i];
+    }
+}
+
 // =============================================================================
 // Resource Examples - Demonstrate MCP Resource System
 // =============================================================================
@@ -282,6 +268,12 @@ void print_usage(const char *program_name) {
     fprintf(stderr, "  -p, --port PORT         HTTP port [default: 9943]\n");
     fprintf(stderr, "  -b, --bind HOST         HTTP bind address [default: 0.0.0.0]\n");
     fprintf(stderr, "  -e, --endpoint PATH     HTTP endpoint path [default: /mcp]\n");
+    fprintf(stderr, "  -w, --workers N         HTTP request worker threads [default: 0]\n");
+    fprintf(stderr, "  -l, --loops N           HTTP event loops sharing the port [default: 1]\n");
+    fprintf(stderr, "  -n, --page-size N       Entries per list response, 0 for no paging [default: 0]\n");
+    fprintf(stderr, "  -m, --max-message N     Largest accepted request or STDIO line in bytes [default: 1048576]\n");
+    fprintf(stderr, "  -a, --arena             Allocate each request's JSON from a per-thread arena\n");
+    fprintf(stderr, "  -s, --stats             Publish tool latency statistics as a resource\n");
     fprintf(stderr, "  -d, --debug             Enable debug logging\n");
     fprintf(stderr, "  -q, --quiet             Suppress business debug logs in stdio mode\n");
     fprintf(stderr, "  -h, --help              Show this help message\n");
@@ -302,6 +294,12 @@ int main(int argc, char *argv[]) {
     const char *bind_address = "0.0.0.0";
     const char *endpoint_path = "/mcp";
     int debug = 0;
+    int workers = 0;
+    int loops = 1;
+    int page_size = 0;
+    int max_message = 0;
+    int arena = 0;
+    int stats = 0;
     int result;
          
     static struct option long_options[] = {
@@ -309,6 +307,12 @@ int main(int argc, char *argv[]) {
         {"port", required_argument, 0, 'p'},
         {"bind", required_argument, 0, 'b'},
         {"endpoint", required_argument, 0, 'e'},
+        {"workers", required_argument, 0, 'w'},
+        {"loops", required_argument, 0, 'l'},
+        {"page-size", required_argument, 0, 'n'},
+        {"max-message", required_argument, 0, 'm'},
+        {"arena", no_argument, 0, 'a'},
+        {"stats", no_argument, 0, 's'},
         {"debug", no_argument, 0, 'd'},
         {"quiet", no_argument, 0, 'q'},
         {"help", no_argument, 0, 'h'},
@@ -316,12 +320,18 @@ int main(int argc, char *argv[]) {
     };
     
     int c;
-    while ((c = getopt_long(argc, argv, "t:p:b:e:dqh", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "t:p:b:e:w:l:n:m:asdqh", long_options, NULL)) != -1) {
         switch (c) {
             case 't': transport_type = optarg; break;
             case 'p': port = atoi(optarg); break;
             case 'b': bind_address = optarg; break;
             case 'e': endpoint_path = optarg; break;
+            case 'w': workers = atoi(optarg); break;
+            case 'l': loops = atoi(optarg); break;
+            case 'n': page_size = atoi(optarg); break;
+            case 'm': max_message = atoi(optarg); break;
+            case 'a': arena = 1; break;
+            case 's': stats = 1; break;
             case 'd': debug = 1; break;
             case 'q': g_quiet = 1; break;
             case 'h':
@@ -378,7 +388,14 @@ int main(int argc, char *argv[]) {
         .max_connections = 3,       // Limited resources on Pi, reduce concurrent connections
         .session_timeout = 1800,    // 30 minutes session timeout
         .enable_sessions = 1,       // Enable session management
-        .auto_cleanup = 1           // Auto cleanup expired sessions
+        .auto_cleanup = 1,          // Auto cleanup expired sessions
+
+        .worker_threads = workers,  // Handle HTTP requests off the poll thread
+        .event_loops = loops,       // SO_REUSEPORT event loop shards
+        .list_page_size = page_size, // Paginate list responses
+        .max_message_size = max_message, // Room for large packed parameters
+        .request_arena = arena,     // Per-request JSON arena
+        .tool_stats_resource = stats // Tool latency statistics resource
     };
 
     // Create server instance
@@ -393,14 +410,28 @@ int main(int argc, char *argv[]) {
     const char* add_param_descriptions[] = {"First number to add", "Second number to add"};
     mcp_param_type_t add_param_types[] = {MCP_PARAM_DOUBLE, MCP_PARAM_DOUBLE};
 
-    if (embed_mcp_add_tool(server, "add", "Add two numbers together",
-                                  add_param_names, add_param_descriptions, add_param_types, 2,
-                                  MCP_RETURN_DOUBLE, add_numbers_wrapper, NULL) != 0) {
+    // Scalar result written in place by the generated _value function, no heap box
+    if (embed_mcp_add_value_tool(server, "add", "Add two numbers together",
+                                 add_param_names, add_param_descriptions, add_param_types, 2,
+                                 MCP_RETURN_DOUBLE, add_numbers_wrapper_value, NULL) != 0) {
         fprintf(stderr, "Failed to register 'add' function: %s\n", embed_mcp_get_error());
     } else {
         fprintf(stderr, "Registered add(double, double) -> double\n");
     }
 
+    // Example 1b: Batch function - calls of one JSON-RPC batch are computed together
+    const char* scale_param_names[] = {"x", "factor"};
+    const char* scale_param_descriptions[] = {"Value to scale", "Scale factor"};
+    mcp_param_type_t scale_param_types[] = {MCP_PARAM_DOUBLE, MCP_PARAM_DOUBLE};
+
+    if (embed_mcp_add_batch_tool(server, "scale", "Multiply a value by a factor",
+                                 scale_param_names, scale_param_descriptions, scale_param_types, 2,
+                                 MCP_RETURN_DOUBLE, scale_batch, NULL) != 0) {
+        fprintf(stderr, "Failed to register 'scale' function: %s\n", embed_mcp_get_error());
+    } else {
+        fprintf(stderr, "Registered scale(double, double) -> double (batch)\n");
+    }
+
     // Example 2: Array sum function - double sum_numbers(double[])
     mcp_param_desc_t sum_params[] = {
         MCP_PARAM_ARRAY_DOUBLE_DEF("numbers", "Array of numbers to sum", "A number to add", 1)
@@ -450,9 +481,9 @@ int main(int argc, char *argv[]) {
     };
     mcp_param_type_t score_param_types[] = {MCP_PARAM_INT, MCP_PARAM_STRING, MCP_PARAM_DOUBLE};
 
-    if (embed_mcp_add_tool(server, "calculate_score", "Calculate score with grade bonus",
-                                  score_param_names, score_param_descriptions, score_param_types, 3,
-                                  MCP_RETURN_INT, calculate_score_wrapper, NULL) != 0) {
+    if (embed_mcp_add_value_tool(server, "calculate_score", "Calculate score with grade bonus",
+                                 score_param_names, score_param_descriptions, score_param_types, 3,
+                                 MCP_RETURN_INT, calculate_score_wrapper_value, NULL) != 0) {
         fprintf(stderr, "Failed to register 'calculate_score' function: %s\n", embed_mcp_get_error());
     } else {
         fprintf(stderr, "Registered calculate_score(int, const char*, double) -> int\n");
@@ -627,6 +658,7 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "HTTP server will start on %s:%d%s\n", bind_address, port, endpoint_path);
         fprintf(stderr, "\nExample tools available:\n");
         fprintf(stderr, "  • add(a, b) - Add two numbers (demonstrates basic math)\n");
+        fprintf(stderr, "  • scale(x, factor) - Multiply a value (demonstrates batch calls)\n");
         fprintf(stderr, "  • sum_array(numbers[]) - Sum array of numbers (demonstrates array handling)\n");
         fprintf(stderr, "  • weather(city) - Get weather info (supports: Jinan/济南)\n");
         fprintf(stderr, "  • calculate_score(base, grade, multiplier) - Calculate score with grade bonus\n");
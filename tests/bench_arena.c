@@ -0,0 +1,256 @@
+// Request arena benchmark: allocations per request and throughput.
+//
+// Runs the server in a child process with request_arena off and on, and sends
+// sequential requests on one keep-alive HTTP connection: tools/list, a join_strings
+// call and an 80 KB sum_numbers call. The benchmark replaces malloc, calloc and
+// realloc with counting wrappers around the glibc allocator; the child reports its
+// count and its CPU time through two tools, so allocs/req covers the whole process.
+// The arena must cut the allocations of every request, or the run fails.
+//
+// Usage: bench_arena [requests]
+
+#include "bench_common.h"
+
+#define BENCH_ARENA_PORT 19964
+#define BENCH_ARENA_WARMUP 50
+#define BENCH_ARENA_NUMBERS 10000
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static unsigned long bench_allocations;
+
+void *malloc(size_t size) {
+    __atomic_fetch_add(&bench_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&bench_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    __atomic_fetch_add(&bench_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(pointer, size);
+}
+
+typedef struct {
+    double allocations;     // Per request
+    double cpu_us;          // Server CPU time per request
+    double throughput;      // Requests per second
+} bench_arena_result_t;
+
+static void *allocations_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    double *result = malloc(sizeof(double));
+    if (result) *result = (double)__atomic_load_n(&bench_allocations, __ATOMIC_RELAXED);
+    return result;
+}
+
+static void *cpu_time_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    double *result = malloc(sizeof(double));
+    if (result) *result = ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+    return result;
+}
+
+static void *sum_numbers_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)user_data;
+
+    size_t count;
+    const double *numbers = params->get_double_array_view(params, "numbers", &count);
+    double *result = malloc(sizeof(double));
+    if (!result) return NULL;
+
+    *result = 0;
+    for (size_t i = 0; i < count; i++) *result += numbers[i];
+    return result;
+}
+
+static void *join_strings_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)user_data;
+
+    size_t count;
+    const char **strings = params->get_string_array_view(params, "strings", &count);
+    const char *separator = params->get_string(params, "separator");
+    size_t separator_length = separator ? strlen(separator) : 0;
+
+    size_t length = 1;
+    for (size_t i = 0; i < count; i++) length += strlen(strings[i]) + separator_length;
+    char *result = malloc(length);
+    if (!result) return NULL;
+
+    result[0] = '\0';
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && separator) strcat(result, separator);
+        strcat(result, strings[i]);
+    }
+    return result;
+}
+
+static int bench_arena_setup(embed_mcp_server_t *server) {
+    mcp_param_desc_t sum_params[] = {
+        MCP_PARAM_ARRAY_DOUBLE_DEF("numbers", "Array of numbers to sum", "A number to add", 1)
+    };
+    mcp_param_desc_t join_params[] = {
+        MCP_PARAM_ARRAY_STRING_DEF("strings", "Array of strings to join", "A string to join", 1),
+        MCP_PARAM_STRING_DEF("separator", "Separator to use between strings", 1)
+    };
+
+    if (embed_mcp_add_tool(server, "allocations", "Allocations made by the process so far",
+                           NULL, NULL, NULL, 0, MCP_RETURN_DOUBLE, allocations_wrapper, NULL) != 0 ||
+        embed_mcp_add_tool(server, "cpu_time", "CPU time used by the process, in microseconds",
+                           NULL, NULL, NULL, 0, MCP_RETURN_DOUBLE, cpu_time_wrapper, NULL) != 0 ||
+        embed_mcp_add_tool(server, "sum_numbers", "Sum an array of numbers",
+                           sum_params, NULL, NULL, 1, MCP_RETURN_DOUBLE, sum_numbers_wrapper, NULL) != 0 ||
+        embed_mcp_add_tool(server, "join_strings", "Join an array of strings with a separator",
+                           join_params, NULL, NULL, 2, MCP_RETURN_STRING, join_strings_wrapper, NULL) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Sends body and returns its result's structuredContent number, or -1
+static double bench_arena_counter(int fd, const char *tool, bench_buffer_t *buffer) {
+    char body[160];
+    snprintf(body, sizeof(body),
+             "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/call\",\"params\":{\"name\":\"%s\",\"arguments\":{}}}",
+             tool);
+
+    long offset = bench_http_post(fd, "/mcp", body, buffer);
+    if (offset < 0) return -1;
+
+    cJSON *reply = cJSON_Parse(buffer->data + offset);
+    const cJSON *value = cJSON_GetObjectItem(cJSON_GetObjectItem(reply, "result"), "structuredContent");
+    double result = cJSON_IsNumber(value) ? value->valuedouble : -1;
+    cJSON_Delete(reply);
+    return result;
+}
+
+static int bench_arena_case(const char *body, int arena, int requests, bench_arena_result_t *result) {
+    embed_mcp_config_t config = {
+        .name = "ArenaBench",
+        .version = "1.0.0",
+        .port = BENCH_ARENA_PORT,
+        .path = "/mcp",
+        .request_arena = arena
+    };
+
+    bench_buffer_t buffer = {0};
+    int status = -1;
+
+    pid_t pid = bench_http_start(&config, bench_arena_setup);
+    int fd = pid > 0 ? bench_http_connect(BENCH_ARENA_PORT) : -1;
+    if (fd >= 0) {
+        int i;
+        for (i = 0; i < BENCH_ARENA_WARMUP; i++) {
+            long offset = bench_http_post(fd, "/mcp", body, &buffer);
+            if (offset < 0 || strstr(buffer.data + offset, "\"error\"") ||
+                strstr(buffer.data + offset, "\"isError\":true")) {
+                break;
+            }
+        }
+        int replied = i == BENCH_ARENA_WARMUP;
+
+        // Two back-to-back reads give the allocations of reading the counter itself
+        double first = bench_arena_counter(fd, "allocations", &buffer);
+        double before = bench_arena_counter(fd, "allocations", &buffer);
+        double cpu_before = bench_arena_counter(fd, "cpu_time", &buffer);
+        double start = bench_now_ns();
+        for (i = 0; i < requests; i++) {
+            if (bench_http_post(fd, "/mcp", body, &buffer) < 0) break;
+        }
+        double elapsed_ns = bench_now_ns() - start;
+        double cpu_after = bench_arena_counter(fd, "cpu_time", &buffer);
+        double after = bench_arena_counter(fd, "allocations", &buffer);
+
+        if (replied && i == requests && first >= 0 && before >= 0 && after >= 0 && cpu_before >= 0 && cpu_after >= 0) {
+            double counter_cost = before - first;
+            // Besides the requests, the count spans one counter read (the end of the
+            // first and the start of the last) and the two cpu_time calls
+            result->allocations = (after - before - 3 * counter_cost) / requests;
+            result->cpu_us = (cpu_after - cpu_before) / requests;
+            result->throughput = requests / (elapsed_ns / 1e9);
+            status = 0;
+        }
+        close(fd);
+    }
+
+    if (pid > 0) bench_http_stop(pid);
+    free(buffer.data);
+    return status;
+}
+
+static char *bench_sum_numbers_call(void) {
+    size_t capacity = BENCH_ARENA_NUMBERS * 16 + 256;
+    char *body = malloc(capacity);
+    if (!body) return NULL;
+
+    size_t length = (size_t)snprintf(body, capacity,
+        "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"sum_numbers\","
+        "\"arguments\":{\"numbers\":[");
+    for (int i = 0; i < BENCH_ARENA_NUMBERS; i++) {
+        length += (size_t)snprintf(body + length, capacity - length, "%s%d.25", i ? "," : "", i % 1000);
+    }
+    snprintf(body + length, capacity - length, "]}}}");
+    return body;
+}
+
+int main(int argc, char **argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 2000;
+    if (requests < 1) {
+        fprintf(stderr, "Usage: %s [requests]\n", argv[0]);
+        return 2;
+    }
+
+    char *sum_call = bench_sum_numbers_call();
+    if (!sum_call) return 1;
+
+    const struct {
+        const char *name;
+        const char *body;
+        int requests;
+    } cases[] = {
+        {"tools/list", "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/list\"}", requests},
+        {"join_strings call",
+         "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"join_strings\","
+         "\"arguments\":{\"strings\":[\"alpha\",\"beta\",\"gamma\",\"delta\",\"epsilon\",\"zeta\","
+         "\"eta\",\"theta\"],\"separator\":\", \"}}}", requests},
+        {"80 KB sum_numbers call", sum_call, requests / 10 > 0 ? requests / 10 : 1},
+    };
+
+    int failures = 0;
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Sequential keep-alive requests on loopback, request_arena off -> on\n");
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        bench_arena_result_t off, on;
+        if (bench_arena_case(cases[c].body, 0, cases[c].requests, &off) != 0 ||
+            bench_arena_case(cases[c].body, 1, cases[c].requests, &on) != 0) {
+            printf("%-23s FAILED (no reply)\n", cases[c].name);
+            failures++;
+            continue;
+        }
+
+        int worse = on.allocations >= off.allocations;
+        printf("%-23s allocs/req %7.0f -> %-5.0f cpu/req %5.0f -> %-5.0f us  %6.0f -> %-6.0f req/s%s\n",
+               cases[c].name, off.allocations, on.allocations, off.cpu_us, on.cpu_us,
+               off.throughput, on.throughput, worse ? "  FAILED" : "");
+        failures += worse;
+    }
+
+    free(sum_call);
+    if (failures > 0) {
+        fprintf(stderr, "Arena benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
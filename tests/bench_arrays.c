@@ -0,0 +1,159 @@
+// Array parameter decoding benchmark.
+//
+// Calls a sum_numbers tool (get_double_array_view) and a total_length tool
+// (get_string_array_view) over HTTP with 10k- and 100k-element arrays, with
+// request_arena off and on, and reports the p50 time per call and how much it grows
+// from 10k to 100k elements. The old indexed loop decoded arrays in quadratic time
+// and took 15 s or more per 100k-element call; a 100k-element call slower than
+// BENCH_ARRAYS_LIMIT_MS fails the run.
+//
+// Usage: bench_arrays [requests]
+
+#include "bench_common.h"
+
+#define BENCH_ARRAYS_PORT 19965
+#define BENCH_ARRAYS_SMALL 10000
+#define BENCH_ARRAYS_LARGE 100000
+#define BENCH_ARRAYS_LIMIT_MS 1000
+
+static void *sum_numbers_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)user_data;
+
+    size_t count;
+    const double *numbers = params->get_double_array_view(params, "numbers", &count);
+    double *result = malloc(sizeof(double));
+    if (!result) return NULL;
+
+    *result = 0;
+    for (size_t i = 0; i < count; i++) *result += numbers[i];
+    return result;
+}
+
+static void *total_length_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)user_data;
+
+    size_t count;
+    const char **strings = params->get_string_array_view(params, "strings", &count);
+    double *result = malloc(sizeof(double));
+    if (!result) return NULL;
+
+    *result = 0;
+    for (size_t i = 0; i < count; i++) *result += (double)strlen(strings[i]);
+    return result;
+}
+
+static int bench_arrays_setup(embed_mcp_server_t *server) {
+    mcp_param_desc_t sum_params[] = {
+        MCP_PARAM_ARRAY_DOUBLE_DEF("numbers", "Array of numbers to sum", "A number to add", 1)
+    };
+    mcp_param_desc_t length_params[] = {
+        MCP_PARAM_ARRAY_STRING_DEF("strings", "Array of strings to measure", "A string", 1)
+    };
+
+    if (embed_mcp_add_tool(server, "sum_numbers", "Sum an array of numbers",
+                           sum_params, NULL, NULL, 1, MCP_RETURN_DOUBLE, sum_numbers_wrapper, NULL) != 0 ||
+        embed_mcp_add_tool(server, "total_length", "Total length of an array of strings",
+                           length_params, NULL, NULL, 1, MCP_RETURN_DOUBLE, total_length_wrapper, NULL) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// tools/call of tool with count elements: numbers i % 1000 + 0.25, or strings "s<i>"
+static char *bench_arrays_call(const char *tool, const char *parameter, int count, int strings) {
+    size_t capacity = (size_t)count * 12 + 256;
+    char *body = malloc(capacity);
+    if (!body) return NULL;
+
+    size_t length = (size_t)snprintf(body, capacity,
+        "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"%s\","
+        "\"arguments\":{\"%s\":[", tool, parameter);
+    for (int i = 0; i < count; i++) {
+        length += (size_t)snprintf(body + length, capacity - length,
+                                   strings ? "%s\"s%d\"" : "%s%d.25", i ? "," : "",
+                                   strings ? i : i % 1000);
+    }
+    snprintf(body + length, capacity - length, "]}}}");
+    return body;
+}
+
+// p50 milliseconds per call of body, or -1 if a call failed
+static double bench_arrays_case(const char *body, int arena, int requests) {
+    embed_mcp_config_t config = {
+        .name = "ArraysBench",
+        .version = "1.0.0",
+        .port = BENCH_ARRAYS_PORT,
+        .path = "/mcp",
+        .request_arena = arena
+    };
+
+    double *samples = malloc((size_t)requests * sizeof(double));
+    bench_buffer_t buffer = {0};
+    double result = -1;
+
+    pid_t pid = bench_http_start(&config, bench_arrays_setup);
+    int fd = pid > 0 && samples ? bench_http_connect(BENCH_ARRAYS_PORT) : -1;
+    if (fd >= 0) {
+        int i;
+        for (i = -1; i < requests; i++) {
+            double start = bench_now_ns();
+            long offset = bench_http_post(fd, "/mcp", body, &buffer);
+            if (offset < 0 || !strstr(buffer.data + offset, "\"structuredContent\"")) break;
+            if (i >= 0) samples[i] = (bench_now_ns() - start) / 1e6;
+        }
+        if (i == requests) result = bench_percentile(samples, (size_t)requests, 50);
+        close(fd);
+    }
+
+    if (pid > 0) bench_http_stop(pid);
+    free(buffer.data);
+    free(samples);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 20;
+    if (requests < 1) {
+        fprintf(stderr, "Usage: %s [requests]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct {
+        const char *name;
+        const char *tool;
+        const char *parameter;
+        int strings;
+    } cases[] = {
+        {"sum_numbers", "sum_numbers", "numbers", 0},
+        {"total_length", "total_length", "strings", 1},
+    };
+
+    int failures = 0;
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("p50 per call over HTTP, %d calls per case\n", requests);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (int arena = 0; arena <= 1; arena++) {
+            char *small = bench_arrays_call(cases[c].tool, cases[c].parameter, BENCH_ARRAYS_SMALL,
+                                            cases[c].strings);
+            char *large = bench_arrays_call(cases[c].tool, cases[c].parameter, BENCH_ARRAYS_LARGE,
+                                            cases[c].strings);
+            double small_ms = small ? bench_arrays_case(small, arena, requests) : -1;
+            double large_ms = large ? bench_arrays_case(large, arena, requests) : -1;
+            free(small);
+            free(large);
+
+            int ok = small_ms > 0 && large_ms > 0 && large_ms < BENCH_ARRAYS_LIMIT_MS;
+            printf("%-13s arena %-3s  10k %7.2f ms   100k %7.2f ms  (x%.1f)%s\n",
+                   cases[c].name, arena ? "on" : "off", small_ms, large_ms,
+                   small_ms > 0 ? large_ms / small_ms : 0, ok ? "" : "  FAILED");
+            failures += !ok;
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "Array decoding benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Helpers shared by the benchmarks under tests/.
+//
+// Timing on the monotonic clock, percentiles over collected samples, and a minimal
+// HTTP/1.1 keep-alive client for benchmarks that run the server in a child process.
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "embed_mcp.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Registers the benchmark's tools and resources on a freshly created server; 0 on success
+typedef int (*bench_server_setup_t)(embed_mcp_server_t *server);
+
+// Growable receive buffer for bench_http_post
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} bench_buffer_t;
+
+static inline double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// p in [0, 100]; sorts samples in place
+static inline double bench_percentile(double *samples, size_t count, double p) {
+    if (count == 0) return 0;
+    qsort(samples, count, sizeof(double), bench_compare_double);
+    size_t index = (size_t)(p / 100.0 * (double)(count - 1) + 0.5);
+    return samples[index < count ? index : count - 1];
+}
+
+// Forks a child serving HTTP with config until killed; its logs would only bury the results
+static inline pid_t bench_http_start(const embed_mcp_config_t *config, bench_server_setup_t setup) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    freopen("/dev/null", "w", stderr);
+    freopen("/dev/null", "w", stdout);
+
+    embed_mcp_server_t *server = embed_mcp_create(config);
+    if (!server || (setup && setup(server) != 0)) {
+        _exit(1);
+    }
+    embed_mcp_run(server, EMBED_MCP_TRANSPORT_HTTP);
+    _exit(0);
+}
+
+static inline void bench_http_stop(pid_t pid) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+// Connects to the loopback port, retrying while the child starts up
+static inline int bench_http_connect(int port) {
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (int attempt = 0; attempt < 100; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        close(fd);
+        usleep(20000);
+    }
+    return -1;
+}
+
+static inline int bench_buffer_reserve(bench_buffer_t *buffer, size_t capacity) {
+    if (buffer->capacity >= capacity) return 0;
+
+    size_t grown = buffer->capacity ? buffer->capacity : 65536;
+    while (grown < capacity) grown *= 2;
+    char *data = realloc(buffer->data, grown);
+    if (!data) return -1;
+    buffer->data = data;
+    buffer->capacity = grown;
+    return 0;
+}
+
+// Sends one JSON-RPC POST on a keep-alive connection and reads the whole response into
+// buffer (headers, then body from the offset returned); returns the body offset, or -1
+static inline long bench_http_post(int fd, const char *path, const char *body, bench_buffer_t *buffer) {
+    char header[256];
+    size_t body_length = strlen(body);
+    int header_length = snprintf(header, sizeof(header),
+        "POST %s HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\n"
+        "Accept: application/json, text/event-stream\r\nContent-Length: %zu\r\n\r\n",
+        path, body_length);
+
+    if (write(fd, header, (size_t)header_length) != header_length ||
+        write(fd, body, body_length) != (ssize_t)body_length) {
+        return -1;
+    }
+
+    long body_offset = -1;
+    size_t total = 0;
+    buffer->length = 0;
+    for (;;) {
+        if (bench_buffer_reserve(buffer, buffer->length + 65536 + 1) != 0) return -1;
+        ssize_t n = read(fd, buffer->data + buffer->length, buffer->capacity - buffer->length - 1);
+        if (n <= 0) return -1;
+        buffer->length += (size_t)n;
+        buffer->data[buffer->length] = '\0';
+
+        if (body_offset < 0) {
+            char *end = strstr(buffer->data, "\r\n\r\n");
+            if (!end) continue;
+            char *length = strstr(buffer->data, "Content-Length:");
+            if (!length || length > end) return -1;
+            body_offset = end + 4 - buffer->data;
+            total = (size_t)body_offset + (size_t)atol(length + 15);
+        }
+        if (buffer->length >= total) return body_offset;
+    }
+}
+
+#endif // BENCH_COMMON_H
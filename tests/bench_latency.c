@@ -0,0 +1,115 @@
+// Loopback round-trip latency benchmark.
+//
+// Sends sequential requests on one keep-alive HTTP connection and reports the p50 and
+// p99 round trip, with requests handled on the poll thread and on two workers. An
+// event loop that sleeps between polls puts every round trip at the sleep interval
+// (about 20 ms before the loop blocked in the network poll), so a p50 above
+// BENCH_LATENCY_LIMIT_US fails the run.
+//
+// Usage: bench_latency [requests]
+
+#include "bench_common.h"
+
+#define BENCH_LATENCY_PORT 19962
+#define BENCH_LATENCY_WARMUP 50
+#define BENCH_LATENCY_LIMIT_US 5000
+
+static const char *bench_ping = "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"ping\"}";
+static const char *bench_call =
+    "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"answer\",\"arguments\":{}}}";
+
+static void *answer_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    double *result = malloc(sizeof(double));
+    if (result) *result = 42;
+    return result;
+}
+
+static int bench_latency_setup(embed_mcp_server_t *server) {
+    return embed_mcp_add_tool(server, "answer", "Returns a constant", NULL, NULL, NULL, 0,
+                              MCP_RETURN_DOUBLE, answer_wrapper, NULL);
+}
+
+// Times requests round trips of body; fills p50/p99 in microseconds, 0 on success
+static int bench_latency_case(int workers, const char *body, int requests, double *p50, double *p99) {
+    embed_mcp_config_t config = {
+        .name = "LatencyBench",
+        .version = "1.0.0",
+        .port = BENCH_LATENCY_PORT,
+        .path = "/mcp",
+        .worker_threads = workers
+    };
+
+    double *samples = malloc((size_t)requests * sizeof(double));
+    bench_buffer_t buffer = {0};
+    int result = -1;
+
+    pid_t pid = bench_http_start(&config, bench_latency_setup);
+    int fd = pid > 0 && samples ? bench_http_connect(BENCH_LATENCY_PORT) : -1;
+    if (fd >= 0) {
+        int i;
+        for (i = -BENCH_LATENCY_WARMUP; i < requests; i++) {
+            double start = bench_now_ns();
+            long offset = bench_http_post(fd, "/mcp", body, &buffer);
+            if (offset < 0 || strstr(buffer.data + offset, "\"error\"")) break;
+            if (i >= 0) samples[i] = (bench_now_ns() - start) / 1000.0;
+        }
+        if (i == requests) {
+            *p50 = bench_percentile(samples, (size_t)requests, 50);
+            *p99 = bench_percentile(samples, (size_t)requests, 99);
+            result = 0;
+        }
+        close(fd);
+    }
+
+    if (pid > 0) bench_http_stop(pid);
+    free(buffer.data);
+    free(samples);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 2000;
+    if (requests < 1) {
+        fprintf(stderr, "Usage: %s [requests]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct {
+        const char *name;
+        int workers;
+        int call;
+    } cases[] = {
+        {"ping, poll thread", 0, 0},
+        {"ping, 2 workers", 2, 0},
+        {"tools/call, poll thread", 0, 1},
+        {"tools/call, 2 workers", 2, 1},
+    };
+
+    int failures = 0;
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("%d sequential keep-alive requests on loopback\n", requests);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        double p50 = 0, p99 = 0;
+        if (bench_latency_case(cases[c].workers, cases[c].call ? bench_call : bench_ping,
+                               requests, &p50, &p99) != 0) {
+            printf("%-24s FAILED (no reply)\n", cases[c].name);
+            failures++;
+            continue;
+        }
+
+        int slow = p50 > BENCH_LATENCY_LIMIT_US;
+        printf("%-24s p50 %7.0f us  p99 %7.0f us%s\n", cases[c].name, p50, p99,
+               slow ? "  FAILED" : "");
+        failures += slow;
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "Latency benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
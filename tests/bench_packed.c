@@ -0,0 +1,179 @@
+// Packed versus JSON array parameter benchmark.
+//
+// Sends the same random doubles to a tool over HTTP twice: as a JSON number array
+// and as a packed float64 parameter (base64 of the little-endian values). Both tools
+// sum the values through get_double_array_view. Reports the body size and the p50
+// time per call, for 50k and 1M elements. The two sums must match and the packed
+// call must be the faster one, or the run fails.
+//
+// Usage: bench_packed [requests]
+
+#include "bench_common.h"
+#include "utils/base64.h"
+
+#define BENCH_PACKED_PORT 19966
+#define BENCH_PACKED_MAX_MESSAGE (32 * 1024 * 1024)
+
+typedef struct {
+    size_t bytes;       // Request body size
+    double ms;          // p50 per call
+    double sum;         // The tool's result
+} bench_packed_result_t;
+
+static void *sum_values_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)user_data;
+
+    size_t count;
+    const double *values = params->get_double_array_view(params, "values", &count);
+    double *result = malloc(sizeof(double));
+    if (!result) return NULL;
+
+    *result = 0;
+    for (size_t i = 0; i < count; i++) *result += values[i];
+    return result;
+}
+
+static int bench_packed_setup(embed_mcp_server_t *server) {
+    mcp_param_desc_t json_params[] = {
+        MCP_PARAM_ARRAY_DOUBLE_DEF("values", "Values to sum", "A value", 1)
+    };
+    mcp_param_desc_t packed_params[] = {
+        MCP_PARAM_PACKED_DOUBLE_DEF("values", "Values to sum, packed float64", 1)
+    };
+
+    if (embed_mcp_add_tool(server, "sum_json", "Sum a JSON array of numbers",
+                           json_params, NULL, NULL, 1, MCP_RETURN_DOUBLE, sum_values_wrapper, NULL) != 0 ||
+        embed_mcp_add_tool(server, "sum_packed", "Sum a packed array of doubles",
+                           packed_params, NULL, NULL, 1, MCP_RETURN_DOUBLE, sum_values_wrapper, NULL) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static const char *bench_packed_prefix =
+    "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"%s\",\"arguments\":{\"values\":";
+
+// Values printed with enough digits to read back exactly, so both calls sum the same doubles
+static char *bench_packed_json_call(const double *values, size_t count) {
+    size_t capacity = count * 26 + 256;
+    char *body = malloc(capacity);
+    if (!body) return NULL;
+
+    size_t length = (size_t)snprintf(body, capacity, bench_packed_prefix, "sum_json");
+    body[length++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        length += (size_t)snprintf(body + length, capacity - length, "%s%.17g", i ? "," : "", values[i]);
+    }
+    snprintf(body + length, capacity - length, "]}}}");
+    return body;
+}
+
+static char *bench_packed_packed_call(const double *values, size_t count) {
+    size_t encoded = base64_encoded_size(count * sizeof(double));
+    size_t capacity = encoded + 256;
+    char *body = malloc(capacity);
+    if (!body) return NULL;
+
+    size_t length = (size_t)snprintf(body, capacity, bench_packed_prefix, "sum_packed");
+    body[length++] = '"';
+    length += base64_encode((const unsigned char*)values, count * sizeof(double), body + length,
+                            capacity - length);
+    snprintf(body + length, capacity - length, "\"}}}");
+    return body;
+}
+
+static int bench_packed_case(const char *body, int requests, bench_packed_result_t *result) {
+    embed_mcp_config_t config = {
+        .name = "PackedBench",
+        .version = "1.0.0",
+        .port = BENCH_PACKED_PORT,
+        .path = "/mcp",
+        .max_message_size = BENCH_PACKED_MAX_MESSAGE
+    };
+
+    double *samples = malloc((size_t)requests * sizeof(double));
+    bench_buffer_t buffer = {0};
+    int status = -1;
+
+    result->bytes = strlen(body);
+    pid_t pid = bench_http_start(&config, bench_packed_setup);
+    int fd = pid > 0 && samples ? bench_http_connect(BENCH_PACKED_PORT) : -1;
+    if (fd >= 0) {
+        int i;
+        for (i = -1; i < requests; i++) {
+            double start = bench_now_ns();
+            long offset = bench_http_post(fd, "/mcp", body, &buffer);
+            if (offset < 0) break;
+            if (i >= 0) samples[i] = (bench_now_ns() - start) / 1e6;
+
+            cJSON *reply = cJSON_Parse(buffer.data + offset);
+            const cJSON *sum = cJSON_GetObjectItem(cJSON_GetObjectItem(reply, "result"), "structuredContent");
+            int ok = cJSON_IsNumber(sum);
+            if (ok) result->sum = sum->valuedouble;
+            cJSON_Delete(reply);
+            if (!ok) break;
+        }
+        if (i == requests) {
+            result->ms = bench_percentile(samples, (size_t)requests, 50);
+            status = 0;
+        }
+        close(fd);
+    }
+
+    if (pid > 0) bench_http_stop(pid);
+    free(buffer.data);
+    free(samples);
+    return status;
+}
+
+int main(int argc, char **argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 9;
+    if (requests < 1) {
+        fprintf(stderr, "Usage: %s [requests]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct {
+        const char *name;
+        size_t count;
+    } cases[] = {
+        {"50k doubles", 50000},
+        {"1M doubles", 1000000},
+    };
+
+    int failures = 0;
+    signal(SIGPIPE, SIG_IGN);
+    srand(1);
+
+    printf("p50 per call over HTTP, %d calls per case\n", requests);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        size_t count = cases[c].count;
+        double *values = malloc(count * sizeof(double));
+        if (!values) return 1;
+        for (size_t i = 0; i < count; i++) values[i] = (double)rand() / RAND_MAX * 2000.0 - 1000.0;
+
+        char *json_call = bench_packed_json_call(values, count);
+        char *packed_call = bench_packed_packed_call(values, count);
+        bench_packed_result_t json = {0}, packed = {0};
+        int ran = json_call && packed_call &&
+                  bench_packed_case(json_call, requests, &json) == 0 &&
+                  bench_packed_case(packed_call, requests, &packed) == 0;
+        free(json_call);
+        free(packed_call);
+        free(values);
+
+        int ok = ran && json.sum == packed.sum && packed.ms < json.ms;
+        printf("%-12s JSON %8.0f KB %8.2f ms   packed %8.0f KB %8.2f ms%s\n", cases[c].name,
+               json.bytes / 1024.0, json.ms, packed.bytes / 1024.0, packed.ms, ok ? "" : "  FAILED");
+        if (ran && json.sum != packed.sum) {
+            fprintf(stderr, "%s: sums differ (%.17g JSON, %.17g packed)\n", cases[c].name, json.sum, packed.sum);
+        }
+        failures += !ok;
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "Packed array benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Large resources/read payload benchmark.
+//
+// Serves one large text resource and reads it back with sequential requests on a
+// keep-alive HTTP connection, on the poll thread and on two workers. Reports the p50
+// and p99 round trip and the body throughput. Every reply must carry the whole
+// resource; one that comes back short or as an error fails the run.
+//
+// Usage: bench_resource [requests]
+
+#include "bench_common.h"
+
+#define BENCH_RESOURCE_PORT 19963
+#define BENCH_RESOURCE_WARMUP 10
+
+static const char *bench_read =
+    "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"resources/read\",\"params\":{\"uri\":\"bench://payload\"}}";
+
+// Size of the resource the next server child registers
+static size_t bench_payload_size;
+
+static int bench_resource_setup(embed_mcp_server_t *server) {
+    char *payload = malloc(bench_payload_size + 1);
+    if (!payload) return -1;
+
+    for (size_t i = 0; i < bench_payload_size; i++) {
+        payload[i] = (i % 64 == 63) ? ' ' : (char)('a' + i % 26);
+    }
+    payload[bench_payload_size] = '\0';
+
+    int result = embed_mcp_add_text_resource(server, "bench://payload", "Payload",
+                                             "Large text payload", "text/plain", payload);
+    free(payload);
+    return result;
+}
+
+// Times requests reads of a size-byte resource; fills p50/p99 in microseconds and the
+// body throughput in MiB/s, 0 on success
+static int bench_resource_case(size_t size, int workers, int requests,
+                               double *p50, double *p99, double *throughput) {
+    embed_mcp_config_t config = {
+        .name = "ResourceBench",
+        .version = "1.0.0",
+        .port = BENCH_RESOURCE_PORT,
+        .path = "/mcp",
+        .worker_threads = workers
+    };
+
+    double *samples = malloc((size_t)requests * sizeof(double));
+    bench_buffer_t buffer = {0};
+    double body_bytes = 0, total_us = 0;
+    int result = -1;
+
+    bench_payload_size = size;
+    pid_t pid = bench_http_start(&config, bench_resource_setup);
+    int fd = pid > 0 && samples ? bench_http_connect(BENCH_RESOURCE_PORT) : -1;
+    if (fd >= 0) {
+        int i;
+        for (i = -BENCH_RESOURCE_WARMUP; i < requests; i++) {
+            double start = bench_now_ns();
+            long offset = bench_http_post(fd, "/mcp", bench_read, &buffer);
+            double elapsed = (bench_now_ns() - start) / 1000.0;
+            if (offset < 0 || buffer.length - (size_t)offset < size ||
+                !strstr(buffer.data + offset, "\"contents\"")) {
+                break;
+            }
+            if (i >= 0) {
+                samples[i] = elapsed;
+                total_us += elapsed;
+                body_bytes += (double)(buffer.length - (size_t)offset);
+            }
+        }
+        if (i == requests) {
+            *p50 = bench_percentile(samples, (size_t)requests, 50);
+            *p99 = bench_percentile(samples, (size_t)requests, 99);
+            *throughput = body_bytes / (1024.0 * 1024.0) / (total_us / 1e6);
+            result = 0;
+        }
+        close(fd);
+    }
+
+    if (pid > 0) bench_http_stop(pid);
+    free(buffer.data);
+    free(samples);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 300;
+    if (requests < 1) {
+        fprintf(stderr, "Usage: %s [requests]\n", argv[0]);
+        return 2;
+    }
+
+    static const struct {
+        const char *name;
+        size_t size;
+        int workers;
+    } cases[] = {
+        {"256 KiB, poll thread", 256 * 1024, 0},
+        {"256 KiB, 2 workers", 256 * 1024, 2},
+        {"1 MiB, poll thread", 1024 * 1024, 0},
+        {"1 MiB, 2 workers", 1024 * 1024, 2},
+    };
+
+    int failures = 0;
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("%d sequential resources/read requests on loopback\n", requests);
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        double p50 = 0, p99 = 0, throughput = 0;
+        if (bench_resource_case(cases[c].size, cases[c].workers, requests,
+                                &p50, &p99, &throughput) != 0) {
+            printf("%-22s FAILED (missing or short reply)\n", cases[c].name);
+            failures++;
+            continue;
+        }
+        printf("%-22s p50 %7.0f us  p99 %7.0f us  %7.1f MiB/s\n", cases[c].name, p50, p99, throughput);
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "Resource benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Response serialization microbenchmark.
+//
+// Renders a tools/list and a tools/call response in a loop and reports bytes on the
+// wire and nanoseconds per response for three paths: the old envelope (the result
+// deep-copied into a new object and printed with cJSON_Print into a fresh string),
+// jsonrpc_render_response compact into a reused buffer, and the same formatted as
+// with pretty_json. The compact rendering must be smaller and faster than the old
+// envelope, or the run fails.
+//
+// Usage: bench_serialize [iterations]
+
+#include "bench_common.h"
+#include "protocol/jsonrpc.h"
+#include "utils/json_buffer.h"
+
+typedef struct {
+    size_t bytes;
+    double ns;
+} bench_serialize_result_t;
+
+// Tool shaped like the example server's, with that many string/number/integer parameters
+static cJSON *bench_tool(int index, int properties) {
+    static const char *types[] = {"string", "number", "integer"};
+    char text[96];
+
+    cJSON *tool = cJSON_CreateObject();
+    snprintf(text, sizeof(text), "tool_%d", index);
+    cJSON_AddStringToObject(tool, "name", text);
+    snprintf(text, sizeof(text), "Example tool number %d with %d parameters", index, properties);
+    cJSON_AddStringToObject(tool, "description", text);
+
+    cJSON *schema = cJSON_AddObjectToObject(tool, "inputSchema");
+    cJSON_AddStringToObject(schema, "$schema", "http://json-schema.org/draft-07/schema#");
+    cJSON_AddStringToObject(schema, "type", "object");
+    cJSON_AddStringToObject(schema, "title", "Tool Parameters");
+    cJSON_AddStringToObject(schema, "description", "Parameters for the tool");
+    cJSON *props = cJSON_AddObjectToObject(schema, "properties");
+    cJSON *required = cJSON_AddArrayToObject(schema, "required");
+    for (int p = 0; p < properties; p++) {
+        snprintf(text, sizeof(text), "param_%d", p);
+        cJSON_AddItemToArray(required, cJSON_CreateString(text));
+        cJSON *prop = cJSON_AddObjectToObject(props, text);
+        snprintf(text, sizeof(text), "Description of parameter %d", p);
+        cJSON_AddStringToObject(prop, "description", text);
+        cJSON_AddStringToObject(prop, "type", types[p % 3]);
+    }
+    cJSON_AddFalseToObject(schema, "additionalProperties");
+    return tool;
+}
+
+static cJSON *bench_tools_list_result(void) {
+    cJSON *result = cJSON_CreateObject();
+    cJSON *tools = cJSON_AddArrayToObject(result, "tools");
+    for (int i = 0; i < 8; i++) {
+        cJSON_AddItemToArray(tools, bench_tool(i, 1 + i % 4));
+    }
+    return result;
+}
+
+static cJSON *bench_tools_call_result(void) {
+    return cJSON_Parse("{\"content\":[{\"type\":\"text\",\"text\":\"4\"}],"
+                       "\"structuredContent\":4,\"isError\":false}");
+}
+
+// The envelope every response was built with before jsonrpc_render_response
+static char *bench_old_serialize(const mcp_response_t *response) {
+    cJSON *envelope = cJSON_CreateObject();
+    cJSON_AddStringToObject(envelope, "jsonrpc", response->jsonrpc);
+    cJSON_AddItemToObject(envelope, "id", cJSON_Duplicate(response->id, 1));
+    cJSON_AddItemToObject(envelope, "result", cJSON_Duplicate(response->result, 1));
+    char *json = cJSON_Print(envelope);
+    cJSON_Delete(envelope);
+    return json;
+}
+
+static bench_serialize_result_t bench_old(const mcp_response_t *response, long iterations) {
+    bench_serialize_result_t result = {0, 0};
+    double start = bench_now_ns();
+    for (long i = 0; i < iterations; i++) {
+        char *json = bench_old_serialize(response);
+        if (!json) return result;
+        result.bytes = strlen(json);
+        free(json);
+    }
+    result.ns = (bench_now_ns() - start) / (double)iterations;
+    return result;
+}
+
+static bench_serialize_result_t bench_render(const mcp_response_t *response, bool formatted,
+                                             long iterations) {
+    bench_serialize_result_t result = {0, 0};
+    mcp_json_buffer_t buffer;
+    mcp_json_buffer_init(&buffer);
+
+    double start = bench_now_ns();
+    for (long i = 0; i < iterations; i++) {
+        if (jsonrpc_render_response(response, formatted, &buffer) != 0) {
+            mcp_json_buffer_free(&buffer);
+            return result;
+        }
+    }
+    result.ns = (bench_now_ns() - start) / (double)iterations;
+    result.bytes = buffer.length;
+
+    mcp_json_buffer_free(&buffer);
+    return result;
+}
+
+// Prints one response's three paths; 0 if the compact rendering beats the old envelope
+static int bench_serialize_case(const char *name, cJSON *result, long iterations) {
+    cJSON *id = cJSON_CreateNumber(2);
+    mcp_response_t response = {
+        .jsonrpc = JSONRPC_VERSION,
+        .id = id,
+        .result = result
+    };
+
+    bench_serialize_result_t old = bench_old(&response, iterations);
+    bench_serialize_result_t compact = bench_render(&response, false, iterations);
+    bench_serialize_result_t pretty = bench_render(&response, true, iterations);
+
+    int ok = old.bytes > 0 && compact.bytes > 0 && compact.bytes < old.bytes && compact.ns < old.ns;
+    printf("%-11s old %5zu B %7.0f ns   compact %5zu B %7.0f ns   pretty %5zu B %7.0f ns%s\n",
+           name, old.bytes, old.ns, compact.bytes, compact.ns, pretty.bytes, pretty.ns,
+           ok ? "" : "  FAILED");
+
+    cJSON_Delete(id);
+    cJSON_Delete(result);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000;
+    if (iterations < 1) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    printf("%ld renderings of tools/list, %ld of tools/call\n", iterations, iterations * 10);
+    failures += bench_serialize_case("tools/list", bench_tools_list_result(), iterations);
+    failures += bench_serialize_case("tools/call", bench_tools_call_result(), iterations * 10);
+
+    if (failures > 0) {
+        fprintf(stderr, "Serialization benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Schema validation benchmark: compiled program versus tree validator.
+//
+// Validates the arguments of a 20-property tool (6 required, with an array and a
+// nested object among them) in a loop, once valid and once with the last property
+// of the wrong type. Reports ns per call for the tree validator, the compiled
+// program, and the one-off compile. Both validators must reach the same verdict,
+// and the compiled program must be the faster one on valid arguments, or the run
+// fails.
+//
+// Usage: bench_validate [iterations]
+
+#include "bench_common.h"
+#include "tools/schema_validator.h"
+#include "tools/tool_interface.h"
+
+#define BENCH_VALIDATE_PROPERTIES 20
+#define BENCH_VALIDATE_REQUIRED 6
+
+static const char *bench_validate_types[] = {"string", "number", "integer", "boolean"};
+
+static cJSON *bench_validate_schema(void) {
+    char name[32];
+    cJSON *schema = cJSON_CreateObject();
+    cJSON_AddStringToObject(schema, "type", "object");
+    cJSON *properties = cJSON_AddObjectToObject(schema, "properties");
+    cJSON *required = cJSON_AddArrayToObject(schema, "required");
+
+    for (int i = 0; i < BENCH_VALIDATE_PROPERTIES; i++) {
+        snprintf(name, sizeof(name), "field_%02d", i);
+        cJSON *property = cJSON_AddObjectToObject(properties, name);
+        if (i == 4) {
+            cJSON_AddStringToObject(property, "type", "array");
+            cJSON_AddStringToObject(cJSON_AddObjectToObject(property, "items"), "type", "number");
+        } else if (i == 5) {
+            cJSON_AddStringToObject(property, "type", "object");
+            cJSON *inner = cJSON_AddObjectToObject(property, "properties");
+            cJSON_AddStringToObject(cJSON_AddObjectToObject(inner, "id"), "type", "integer");
+            cJSON_AddStringToObject(cJSON_AddObjectToObject(inner, "label"), "type", "string");
+            cJSON_AddItemToArray(cJSON_AddArrayToObject(property, "required"), cJSON_CreateString("id"));
+        } else {
+            cJSON_AddStringToObject(property, "type", bench_validate_types[i % 4]);
+            cJSON_AddStringToObject(property, "description", "Benchmark parameter");
+        }
+        if (i < BENCH_VALIDATE_REQUIRED) {
+            cJSON_AddItemToArray(required, cJSON_CreateString(name));
+        }
+    }
+    cJSON_AddFalseToObject(schema, "additionalProperties");
+    return schema;
+}
+
+// Every property set; broken makes the last one a string where a boolean belongs
+static cJSON *bench_validate_arguments(int broken) {
+    char name[32];
+    cJSON *arguments = cJSON_CreateObject();
+
+    for (int i = 0; i < BENCH_VALIDATE_PROPERTIES; i++) {
+        snprintf(name, sizeof(name), "field_%02d", i);
+        if (i == 4) {
+            cJSON *values = cJSON_AddArrayToObject(arguments, name);
+            for (int v = 0; v < 8; v++) cJSON_AddItemToArray(values, cJSON_CreateNumber(v * 1.5));
+        } else if (i == 5) {
+            cJSON *owner = cJSON_AddObjectToObject(arguments, name);
+            cJSON_AddNumberToObject(owner, "id", 7);
+            cJSON_AddStringToObject(owner, "label", "owner");
+        } else if (broken && i == BENCH_VALIDATE_PROPERTIES - 1) {
+            cJSON_AddStringToObject(arguments, name, "not a boolean");
+        } else {
+            switch (i % 4) {
+            case 0: cJSON_AddStringToObject(arguments, name, "value"); break;
+            case 1: cJSON_AddNumberToObject(arguments, name, i + 0.5); break;
+            case 2: cJSON_AddNumberToObject(arguments, name, i); break;
+            default: cJSON_AddTrueToObject(arguments, name); break;
+            }
+        }
+    }
+    return arguments;
+}
+
+static double bench_validate_tree(const cJSON *schema, const cJSON *arguments, long iterations,
+                                  bool *verdict) {
+    mcp_schema_error_t error;
+    double start = bench_now_ns();
+    for (long i = 0; i < iterations; i++) {
+        mcp_schema_error_init(&error);
+        *verdict = mcp_tool_validate_parameter_with_context(arguments, schema, &error);
+    }
+    return (bench_now_ns() - start) / (double)iterations;
+}
+
+static double bench_validate_compiled(const mcp_schema_program_t *program, const cJSON *arguments,
+                                      long iterations, bool *verdict) {
+    mcp_schema_error_t error;
+    double start = bench_now_ns();
+    for (long i = 0; i < iterations; i++) {
+        mcp_schema_error_init(&error);
+        *verdict = mcp_schema_validate(program, arguments, &error);
+    }
+    return (bench_now_ns() - start) / (double)iterations;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    if (iterations < 1) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    cJSON *schema = bench_validate_schema();
+    long compiles = iterations / 10 > 0 ? iterations / 10 : 1;
+    double start = bench_now_ns();
+    for (long i = 0; i < compiles; i++) {
+        mcp_schema_program_destroy(mcp_schema_compile(schema));
+    }
+    double compile_ns = (bench_now_ns() - start) / (double)compiles;
+
+    mcp_schema_program_t *program = mcp_schema_compile(schema);
+    if (!program) {
+        fprintf(stderr, "Failed to compile the benchmark schema\n");
+        cJSON_Delete(schema);
+        return 1;
+    }
+
+    int failures = 0;
+    printf("%d-property tool, %ld validations per case\n", BENCH_VALIDATE_PROPERTIES, iterations);
+    for (int broken = 0; broken <= 1; broken++) {
+        cJSON *arguments = bench_validate_arguments(broken);
+        bool tree_verdict = false, compiled_verdict = false;
+
+        double tree_ns = bench_validate_tree(schema, arguments, iterations, &tree_verdict);
+        double compiled_ns = bench_validate_compiled(program, arguments, iterations, &compiled_verdict);
+
+        int ok = tree_verdict == !broken && compiled_verdict == !broken &&
+                 (broken || compiled_ns < tree_ns);
+        printf("%-18s tree %7.0f ns   compiled %7.0f ns%s\n",
+               broken ? "invalid arguments" : "valid arguments", tree_ns, compiled_ns,
+               ok ? "" : "  FAILED");
+        failures += !ok;
+        cJSON_Delete(arguments);
+    }
+    printf("%-18s %7.0f ns\n", "one-off compile", compile_ns);
+
+    mcp_schema_program_destroy(program);
+    cJSON_Delete(schema);
+
+    if (failures > 0) {
+        fprintf(stderr, "Validation benchmark failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Deadline test for synchronous tools.
+//
+// A synchronous tool that overruns its deadline is answered with a timeout error as
+// soon as the deadline passes wherever the reply can leave while the tool still runs:
+// over STDIO and from HTTP worker threads. With no workers the HTTP poll thread runs
+// the tool itself, so the reply goes out directly once the tool returns.
+//
+// Every case runs the server in a child process and times the reply from the client side.
+//
+// Usage: tool_timeout
+
+#include "embed_mcp.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TIMEOUT_PORT 19961
+#define TIMEOUT_TOOL_MS 1500      // How long the tool runs
+#define TIMEOUT_DEADLINE_MS 200   // Its deadline
+#define TIMEOUT_EARLY_MS 1000     // An early reply arrives well before the tool returns
+
+static const char *timeout_initialize =
+    "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"initialize\",\"params\":{\"protocolVersion\":\"2025-06-18\","
+    "\"capabilities\":{},\"clientInfo\":{\"name\":\"TimeoutTest\",\"version\":\"1.0.0\"}}}";
+static const char *timeout_call =
+    "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"tools/call\",\"params\":{\"name\":\"slow\",\"arguments\":{}}}";
+
+static void *slow_wrapper(mcp_param_accessor_t *params, void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    usleep(TIMEOUT_TOOL_MS * 1000);
+
+    double *result = malloc(sizeof(double));
+    if (result) *result = 1;
+    return result;
+}
+
+static double timeout_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Child process: serve until killed; its logs would only bury the results
+static void timeout_run_server(embed_mcp_transport_t transport, int workers) {
+    freopen("/dev/null", "w", stderr);
+    if (transport == EMBED_MCP_TRANSPORT_HTTP) {
+        freopen("/dev/null", "w", stdout);
+    }
+
+    embed_mcp_config_t config = {
+        .name = "TimeoutTest",
+        .version = "1.0.0",
+        .port = TIMEOUT_PORT,
+        .path = "/mcp",
+        .worker_threads = workers
+    };
+
+    embed_mcp_server_t *server = embed_mcp_create(&config);
+    if (!server ||
+        embed_mcp_add_tool(server, "slow", "Runs past its deadline", NULL, NULL, NULL, 0,
+                           MCP_RETURN_DOUBLE, slow_wrapper, NULL) != 0 ||
+        embed_mcp_set_tool_timeout(server, "slow", TIMEOUT_DEADLINE_MS) != 0) {
+        fprintf(stderr, "Failed to set up the server: %s\n", embed_mcp_get_error());
+        _exit(1);
+    }
+
+    embed_mcp_run(server, transport);
+    _exit(0);
+}
+
+static void timeout_stop_server(pid_t pid) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+// Whether buffer holds the whole reply to request 2: a line over STDIO, a response
+// with its full Content-Length over HTTP
+static int timeout_reply_complete(const char *buffer, int http) {
+    if (!http) {
+        const char *reply = strstr(buffer, "\"id\":2");
+        return reply && strchr(reply, '\n');
+    }
+
+    const char *length = strstr(buffer, "Content-Length:");
+    const char *body = strstr(buffer, "\r\n\r\n");
+    return length && body && strlen(body + 4) >= (size_t)atol(length + 15);
+}
+
+// Reads from fd until the reply to request 2 has arrived; returns its milliseconds
+// since start, or -1 on a read error or after 5 seconds
+static double timeout_wait_reply(int fd, int http, double start, char *buffer, size_t size) {
+    size_t length = 0;
+
+    buffer[0] = '\0';
+    while (length + 1 < size && timeout_now_ms() - start < 5000) {
+        ssize_t n = read(fd, buffer + length, size - length - 1);
+        if (n <= 0) return -1;
+        length += (size_t)n;
+        buffer[length] = '\0';
+
+        if (timeout_reply_complete(buffer, http)) return timeout_now_ms() - start;
+    }
+    return -1;
+}
+
+static double timeout_case_stdio(char *reply, size_t size) {
+    int to_server[2], from_server[2];
+    if (pipe(to_server) != 0 || pipe(from_server) != 0) return -1;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        dup2(to_server[0], STDIN_FILENO);
+        dup2(from_server[1], STDOUT_FILENO);
+        close(to_server[1]);
+        close(from_server[0]);
+        timeout_run_server(EMBED_MCP_TRANSPORT_STDIO, 0);
+    }
+    close(to_server[0]);
+    close(from_server[1]);
+
+    // Later requests sit in the pipe until the reader thread gets to them
+    dprintf(to_server[1], "%s\n", timeout_initialize);
+    double start = timeout_now_ms();
+    dprintf(to_server[1], "%s\n", timeout_call);
+    double elapsed = timeout_wait_reply(from_server[0], 0, start, reply, size);
+
+    timeout_stop_server(pid);
+    close(to_server[1]);
+    close(from_server[0]);
+    return elapsed;
+}
+
+static int timeout_connect(void) {
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TIMEOUT_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (int attempt = 0; attempt < 100; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*)&address, sizeof(address)) == 0) return fd;
+        close(fd);
+        usleep(20000);
+    }
+    return -1;
+}
+
+static double timeout_case_http(int workers, char *reply, size_t size) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        timeout_run_server(EMBED_MCP_TRANSPORT_HTTP, workers);
+    }
+
+    double elapsed = -1;
+    int fd = timeout_connect();
+    if (fd >= 0) {
+        double start = timeout_now_ms();
+        dprintf(fd, "POST /mcp HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\n"
+                    "Accept: application/json, text/event-stream\r\nContent-Length: %zu\r\n\r\n%s",
+                strlen(timeout_call), timeout_call);
+        elapsed = timeout_wait_reply(fd, 1, start, reply, size);
+        close(fd);
+    }
+
+    timeout_stop_server(pid);
+    return elapsed;
+}
+
+// early: the reply must beat the tool; otherwise it comes once the tool has returned
+static int timeout_check(const char *name, double elapsed, const char *reply, int early) {
+    int timed_out = strstr(reply, "timed out") != NULL;
+    int in_time = early ? elapsed >= 0 && elapsed < TIMEOUT_EARLY_MS
+                        : elapsed >= TIMEOUT_TOOL_MS - 50;
+
+    printf("%-18s reply after %6.0f ms (tool runs %d ms, deadline %d ms)%s\n", name, elapsed,
+           TIMEOUT_TOOL_MS, TIMEOUT_DEADLINE_MS, timed_out && in_time ? "" : "  FAILED");
+    if (!timed_out) {
+        fprintf(stderr, "%s: no timeout error in the reply: %.300s\n", name, reply);
+    }
+    return timed_out && in_time ? 0 : 1;
+}
+
+int main(void) {
+    static char reply[65536];
+    int failures = 0;
+    double elapsed;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    elapsed = timeout_case_stdio(reply, sizeof(reply));
+    failures += timeout_check("stdio", elapsed, reply, 1);
+
+    elapsed = timeout_case_http(2, reply, sizeof(reply));
+    failures += timeout_check("http, 2 workers", elapsed, reply, 1);
+
+    elapsed = timeout_case_http(0, reply, sizeof(reply));
+    failures += timeout_check("http, poll thread", elapsed, reply, 0);
+
+    if (failures > 0) {
+        fprintf(stderr, "Tool timeout test failed\n");
+        return 1;
+    }
+    printf("Tool timeout test passed\n");
+    return 0;
+}
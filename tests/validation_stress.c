@@ -0,0 +1,186 @@
+// Multi-threaded stress test for schema validation.
+//
+// Validation reports failures through a caller-provided mcp_schema_error_t, so
+// concurrent calls must never see each other's path or message. Every thread
+// validates its own invalid arguments against one shared schema, with both the
+// tree validator and the compiled program, and checks each result against the
+// error it got before the other threads started.
+//
+// Usage: validation_stress [threads] [iterations]
+
+#include "tools/schema_validator.h"
+#include "tools/tool_interface.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STRESS_MAX_THREADS 64
+#define STRESS_ARRAY_SIZE STRESS_MAX_THREADS
+
+typedef struct {
+    int index;
+    long iterations;
+    const cJSON *schema;
+    const mcp_schema_program_t *program;
+    cJSON *arguments;
+    mcp_schema_error_t expected_tree;
+    mcp_schema_error_t expected_compiled;
+    long tree_mismatches;
+    long compiled_mismatches;
+} stress_thread_t;
+
+static const char *stress_schema_json =
+    "{\"type\":\"object\","
+    " \"properties\":{"
+    "   \"name\":{\"type\":\"string\"},"
+    "   \"level\":{\"type\":\"number\",\"minimum\":0,\"maximum\":10},"
+    "   \"values\":{\"type\":\"array\",\"items\":{\"type\":\"number\"}},"
+    "   \"owner\":{\"type\":\"object\","
+    "              \"properties\":{\"id\":{\"type\":\"integer\"}},"
+    "              \"required\":[\"id\"]}"
+    " },"
+    " \"required\":[\"name\"],"
+    " \"additionalProperties\":false}";
+
+// Arguments failing in a way that is different for every thread: a bad array
+// element at the thread's index, an unexpected property named after the thread,
+// a nested type error, or a nested required property missing
+static cJSON *stress_arguments(int index) {
+    cJSON *arguments = cJSON_CreateObject();
+    cJSON_AddStringToObject(arguments, "name", "stress");
+
+    switch (index % 4) {
+    case 0: {
+        cJSON *values = cJSON_AddArrayToObject(arguments, "values");
+        for (int i = 0; i < STRESS_ARRAY_SIZE; i++) {
+            if (i == index) {
+                cJSON_AddItemToArray(values, cJSON_CreateString("not a number"));
+            } else {
+                cJSON_AddItemToArray(values, cJSON_CreateNumber(i));
+            }
+        }
+        break;
+    }
+    case 1: {
+        char name[32];
+        snprintf(name, sizeof(name), "extra_%d", index);
+        cJSON_AddNumberToObject(arguments, name, index);
+        break;
+    }
+    case 2: {
+        cJSON *owner = cJSON_AddObjectToObject(arguments, "owner");
+        cJSON_AddStringToObject(owner, "id", "not an integer");
+        break;
+    }
+    default:
+        cJSON_AddObjectToObject(arguments, "owner");
+        break;
+    }
+
+    return arguments;
+}
+
+static bool stress_error_equal(const mcp_schema_error_t *a, const mcp_schema_error_t *b) {
+    return strcmp(a->path, b->path) == 0 &&
+           strcmp(a->keyword ? a->keyword : "", b->keyword ? b->keyword : "") == 0 &&
+           strcmp(a->message, b->message) == 0;
+}
+
+static void *stress_thread_main(void *arg) {
+    stress_thread_t *thread = (stress_thread_t*)arg;
+
+    for (long i = 0; i < thread->iterations; i++) {
+        mcp_schema_error_t error;
+
+        mcp_schema_error_init(&error);
+        if (mcp_tool_validate_parameter_with_context(thread->arguments, thread->schema, &error) ||
+            !stress_error_equal(&error, &thread->expected_tree)) {
+            thread->tree_mismatches++;
+        }
+
+        mcp_schema_error_init(&error);
+        if (mcp_schema_validate(thread->program, thread->arguments, &error) ||
+            !stress_error_equal(&error, &thread->expected_compiled)) {
+            thread->compiled_mismatches++;
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    int thread_count = argc > 1 ? atoi(argv[1]) : 8;
+    long iterations = argc > 2 ? atol(argv[2]) : 50000;
+    if (thread_count < 1 || thread_count > STRESS_MAX_THREADS || iterations < 1) {
+        fprintf(stderr, "Usage: %s [threads 1-%d] [iterations]\n", argv[0], STRESS_MAX_THREADS);
+        return 2;
+    }
+
+    cJSON *schema = cJSON_Parse(stress_schema_json);
+    mcp_schema_program_t *program = schema ? mcp_schema_compile(schema) : NULL;
+    if (!program) {
+        fprintf(stderr, "Failed to compile the stress schema\n");
+        cJSON_Delete(schema);
+        return 1;
+    }
+
+    stress_thread_t threads[STRESS_MAX_THREADS];
+    pthread_t handles[STRESS_MAX_THREADS];
+    int failures = 0;
+
+    // Expected results, taken one thread at a time
+    for (int t = 0; t < thread_count; t++) {
+        stress_thread_t *thread = &threads[t];
+        memset(thread, 0, sizeof(*thread));
+        thread->index = t;
+        thread->iterations = iterations;
+        thread->schema = schema;
+        thread->program = program;
+        thread->arguments = stress_arguments(t);
+
+        mcp_schema_error_init(&thread->expected_tree);
+        mcp_schema_error_init(&thread->expected_compiled);
+        if (mcp_tool_validate_parameter_with_context(thread->arguments, schema, &thread->expected_tree) ||
+            mcp_schema_validate(program, thread->arguments, &thread->expected_compiled)) {
+            fprintf(stderr, "Thread %d: arguments unexpectedly valid\n", t);
+            failures++;
+        }
+    }
+
+    int started = 0;
+    for (; failures == 0 && started < thread_count; started++) {
+        if (pthread_create(&handles[started], NULL, stress_thread_main, &threads[started]) != 0) {
+            fprintf(stderr, "Failed to start thread %d\n", started);
+            failures++;
+            break;
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    for (int t = 0; t < started; t++) {
+        const stress_thread_t *thread = &threads[t];
+        if (thread->tree_mismatches > 0 || thread->compiled_mismatches > 0) {
+            fprintf(stderr, "Thread %d (%s): %ld tree and %ld compiled mismatches of %ld\n",
+                    t, thread->expected_tree.path, thread->tree_mismatches,
+                    thread->compiled_mismatches, thread->iterations);
+            failures++;
+        }
+    }
+
+    for (int t = 0; t < thread_count; t++) {
+        cJSON_Delete(threads[t].arguments);
+    }
+    mcp_schema_program_destroy(program);
+    cJSON_Delete(schema);
+
+    if (failures > 0) {
+        fprintf(stderr, "Validation stress test failed\n");
+        return 1;
+    }
+    printf("Validation stress test passed (%d threads x %ld iterations, 2 validators)\n",
+           thread_count, iterations);
+    return 0;
+}